@@ -0,0 +1,60 @@
+#!/usr/bin/env python3
+"""Compares two Google Benchmark JSON reports and flags regressions.
+
+usage: bench_compare.py BASELINE CURRENT [--threshold PERCENT]
+
+A benchmark regresses when its real time grows by more than the threshold
+(default 10%). The script exits with status 1 if any benchmark regressed.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as report:
+        data = json.load(report)
+    results = {}
+    for bench in data.get("benchmarks", []):
+        if bench.get("run_type", "iteration") != "iteration":
+            continue
+        results[bench["name"]] = bench
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=10.0,
+                        help="allowed slowdown in percent")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+    regressions = 0
+    print(f"{'benchmark':<40} {'baseline':>12} {'current':>12} {'change':>8}")
+    for name, bench in current.items():
+        if name not in baseline:
+            print(f"{name:<40} {'-':>12} {bench['real_time']:>12.1f}      new")
+            continue
+        old = baseline[name]["real_time"]
+        new = bench["real_time"]
+        change = (new - old) / old * 100 if old else 0.0
+        mark = ""
+        if change > args.threshold:
+            mark = "  REGRESSION"
+            regressions += 1
+        print(f"{name:<40} {old:>12.1f} {new:>12.1f} {change:>+7.1f}%{mark}")
+    for name in baseline.keys() - current.keys():
+        print(f"{name:<40} missing from current run")
+
+    if regressions:
+        print(f"{regressions} benchmark(s) slower than {args.threshold}%")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
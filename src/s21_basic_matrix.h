@@ -0,0 +1,379 @@
+#ifndef SRC_S21_BASIC_MATRIX_
+#define SRC_S21_BASIC_MATRIX_
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <memory_resource>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "s21_matrix_gemm.h"
+#include "s21_matrix_oop.h"
+
+// Per element type: the tolerance of EqMatrix, about the square root of
+// the machine epsilon as 1e-7 is for double, and the type products are
+// accumulated in. float accumulates in double, so mixed-precision products
+// keep float storage and bandwidth but round only once per element.
+template <typename T>
+struct S21ElementTraits;
+
+template <>
+struct S21ElementTraits<float> {
+  using Accumulator = double;
+  static constexpr float kEpsilon = 1e-3f;
+};
+
+template <>
+struct S21ElementTraits<double> {
+  using Accumulator = double;
+  static constexpr double kEpsilon = 1e-7;
+};
+
+template <>
+struct S21ElementTraits<long double> {
+  using Accumulator = long double;
+  static constexpr long double kEpsilon = 1e-10L;
+};
+
+template <typename T>
+struct S21ElementTraits<std::complex<T>> {
+  using Accumulator =
+      std::complex<typename S21ElementTraits<T>::Accumulator>;
+  static constexpr T kEpsilon = S21ElementTraits<T>::kEpsilon;
+};
+
+// S21Matrix for any element type with an S21ElementTraits specialization,
+// with the same operation set and error behaviour. Elements are stored
+// row-major without padding in a buffer from resource. Products of float
+// and complex matrices go through the packed GEMM kernels; the other
+// kernels are plain loops left to the compiler's vectorizer, so float runs
+// twice as many elements per instruction as double. Use it through
+// BasicS21Matrix below.
+template <typename T>
+class S21GenericMatrix {
+  using Accumulator = typename S21ElementTraits<T>::Accumulator;
+  // Element types s21_kernels::Gemm takes.
+  static constexpr bool kPackedComplex =
+      std::is_same<T, std::complex<float>>::value ||
+      std::is_same<T, std::complex<double>>::value;
+  static constexpr bool kPackedProduct =
+      std::is_same<T, float>::value || kPackedComplex;
+
+ public:
+  S21GenericMatrix() : S21GenericMatrix(0, 0) {}
+  S21GenericMatrix(int rows, int cols,
+                   std::pmr::memory_resource* resource =
+                       S21SmallBlockPool::Instance())
+      : rows_(rows), cols_(cols), data_(resource) {
+    if (rows < 0 || cols < 0)
+      throw std::invalid_argument(
+          "Number of rows or columns should be positive");
+    data_.resize((std::size_t)rows * cols);
+  }
+  // Element-wise conversion, e.g. from an S21Matrix view or another
+  // element type.
+  template <typename U>
+  explicit S21GenericMatrix(S21BasicMatrixView<U> view,
+                            std::pmr::memory_resource* resource =
+                                S21SmallBlockPool::Instance())
+      : S21GenericMatrix(view.GetRows(), view.GetCols(), resource) {
+    for (int row = 0; row < rows_; row++)
+      for (int col = 0; col < cols_; col++)
+        At(row, col) = static_cast<T>(view.At(row, col));
+  }
+  // Copies and moves keep the resource, as with S21Matrix.
+  S21GenericMatrix(const S21GenericMatrix& other)
+      : rows_(other.rows_),
+        cols_(other.cols_),
+        data_(other.data_, other.data_.get_allocator()) {}
+  S21GenericMatrix(S21GenericMatrix&& other)
+      : rows_(std::exchange(other.rows_, 0)),
+        cols_(std::exchange(other.cols_, 0)),
+        data_(std::move(other.data_)) {}
+  S21GenericMatrix& operator=(const S21GenericMatrix& other) = default;
+  S21GenericMatrix& operator=(S21GenericMatrix&& other) {
+    if (this != &other) {
+      rows_ = std::exchange(other.rows_, 0);
+      cols_ = std::exchange(other.cols_, 0);
+      data_ = std::move(other.data_);
+      other.data_.clear();
+    }
+    return *this;
+  }
+
+  int GetRows() const { return rows_; }
+  int GetCols() const { return cols_; }
+  void SetRows(int rows) { SetSize(rows, cols_); }
+  void SetCols(int cols) { SetSize(rows_, cols); }
+  void SetSize(int rows, int cols) {
+    if (rows <= 0 || cols <= 0)
+      throw std::invalid_argument("Incorrect input, need rows, cols > 0");
+    S21GenericMatrix result(rows, cols, GetResource());
+    for (int row = 0; row < std::min(rows, rows_); row++)
+      std::copy_n(RowData(row), std::min(cols, cols_), result.RowData(row));
+    *this = std::move(result);
+  }
+  std::pmr::memory_resource* GetResource() const {
+    return data_.get_allocator().resource();
+  }
+  S21BasicMatrixView<T> View() { return {data_.data(), rows_, cols_, cols_}; }
+  S21BasicMatrixView<const T> View() const {
+    return {data_.data(), rows_, cols_, cols_};
+  }
+
+  T& operator()(int row, int col) {
+    CheckIndex(row, col);
+    return At(row, col);
+  }
+  const T& operator()(int row, int col) const {
+    CheckIndex(row, col);
+    return At(row, col);
+  }
+
+  bool EqMatrix(const S21GenericMatrix& other) const {
+    if (rows_ != other.rows_ || cols_ != other.cols_) return false;
+    // Ordered compare, so a NaN difference counts as close, as in S21Matrix.
+    for (std::size_t i = 0; i < data_.size(); i++)
+      if (std::abs(data_[i] - other.data_[i]) > S21ElementTraits<T>::kEpsilon)
+        return false;
+    return true;
+  }
+  void SumMatrix(const S21GenericMatrix& other) {
+    CheckSameShape(other);
+    for (std::size_t i = 0; i < data_.size(); i++) data_[i] += other.data_[i];
+  }
+  void SubMatrix(const S21GenericMatrix& other) {
+    CheckSameShape(other);
+    for (std::size_t i = 0; i < data_.size(); i++) data_[i] -= other.data_[i];
+  }
+  void MulNumber(T num) {
+    for (T& value : data_) value *= num;
+  }
+  void MulMatrix(const S21GenericMatrix& other) {
+    *this = Multiply(other);
+  }
+  // this * other, every element of the result summed in Accumulator and
+  // rounded to T once. float and complex products run on the packed GEMM
+  // kernels of S21Matrix, which sum in double; long double keeps a row
+  // loop.
+  S21GenericMatrix Multiply(const S21GenericMatrix& other) const {
+    if (cols_ != other.rows_)
+      throw std::out_of_range(
+          "Invalid matrix sizes: number of cols of the first matrix must be "
+          "equal to the number of rows of the second matrix");
+    S21GenericMatrix result(rows_, other.cols_, GetResource());
+    const int n = other.cols_;
+    if constexpr (kPackedProduct) {
+      const std::size_t size = result.data_.size();
+      std::pmr::vector<double> sums((kPackedComplex ? 2 : 1) * size,
+                                    GetResource());
+      if constexpr (kPackedComplex) {
+        using Part = typename T::value_type;
+        s21_kernels::Gemm(rows_, n, cols_, data_.data(), cols_,
+                          other.data_.data(), n, sums.data(),
+                          sums.data() + size, n);
+        for (std::size_t i = 0; i < size; i++)
+          result.data_[i] = T(Part(sums[i]), Part(sums[size + i]));
+      } else {
+        s21_kernels::Gemm(rows_, n, cols_, data_.data(), cols_,
+                          other.data_.data(), n, sums.data(), n);
+        for (std::size_t i = 0; i < size; i++) result.data_[i] = T(sums[i]);
+      }
+      return result;
+    }
+    S21ThreadPool::ParallelFor(
+        rows_, (long)n * cols_, [&](int begin, int end) {
+          std::vector<Accumulator> sums(n);
+          for (int row = begin; row < end; row++) {
+            std::fill(sums.begin(), sums.end(), Accumulator());
+            for (int k = 0; k < cols_; k++) {
+              const Accumulator factor = At(row, k);
+              const T* src = other.RowData(k);
+              for (int col = 0; col < n; col++)
+                sums[col] += factor * Accumulator(src[col]);
+            }
+            T* dst = result.RowData(row);
+            for (int col = 0; col < n; col++) dst[col] = T(sums[col]);
+          }
+        });
+    return result;
+  }
+  S21GenericMatrix Transpose() const {
+    S21GenericMatrix result(cols_, rows_, GetResource());
+    for (int row = 0; row < rows_; row++)
+      for (int col = 0; col < cols_; col++)
+        result.At(col, row) = At(row, col);
+    return result;
+  }
+  S21GenericMatrix GetMinor(int m_row, int m_col) const {
+    CheckIndex(m_row, m_col);
+    S21GenericMatrix result(rows_ - 1, cols_ - 1, GetResource());
+    for (int row = 0, i = 0; row < rows_; row++) {
+      if (row == m_row) continue;
+      for (int col = 0, j = 0; col < cols_; col++)
+        if (col != m_col) result.At(i, j++) = At(row, col);
+      i++;
+    }
+    return result;
+  }
+  S21GenericMatrix CalcComplements() const {
+    if (rows_ != cols_ || rows_ <= 1)
+      throw std::invalid_argument("The matrix is not square");
+    S21GenericMatrix result(rows_, cols_, GetResource());
+    for (int row = 0; row < rows_; row++) {
+      for (int col = 0; col < cols_; col++) {
+        const T det = GetMinor(row, col).Determinant();
+        result.At(row, col) = (row + col) % 2 == 0 ? det : -det;
+      }
+    }
+    return result;
+  }
+  T Determinant() const {
+    if (rows_ != cols_) throw std::invalid_argument("The matrix is not square");
+    // Only an exactly zero pivot gives 0, as in s21_views::Determinant.
+    S21GenericMatrix lu(*this);
+    T det = 1;
+    for (int k = 0; k < rows_; k++) {
+      const int pivot = lu.PivotRow(k);
+      if (lu.At(pivot, k) == T(0)) return T(0);
+      if (pivot != k) lu.SwapRows(k, pivot), det = -det;
+      det *= lu.At(k, k);
+      for (int i = k + 1; i < rows_; i++) {
+        const T factor = lu.At(i, k) / lu.At(k, k);
+        for (int j = k + 1; j < cols_; j++) lu.At(i, j) -= factor * lu.At(k, j);
+      }
+    }
+    return det;
+  }
+  // Gauss-Jordan elimination with partial pivoting.
+  S21GenericMatrix InverseMatrix() const {
+    if (rows_ != cols_ || rows_ == 0)
+      throw std::invalid_argument(
+          "Matrix determinant is 0 or matrix is not square");
+    S21GenericMatrix lhs(*this), result(rows_, cols_, GetResource());
+    const auto tolerance = SingularTolerance();
+    for (int i = 0; i < rows_; i++) result.At(i, i) = T(1);
+    for (int k = 0; k < rows_; k++) {
+      const int pivot = lhs.PivotRow(k);
+      if (std::abs(lhs.At(pivot, k)) <= tolerance)
+        throw std::invalid_argument(
+            "Matrix determinant is 0 or matrix is not square");
+      lhs.SwapRows(k, pivot);
+      result.SwapRows(k, pivot);
+      const T scale = T(1) / lhs.At(k, k);
+      for (int j = 0; j < cols_; j++)
+        lhs.At(k, j) *= scale, result.At(k, j) *= scale;
+      for (int i = 0; i < rows_; i++) {
+        const T factor = lhs.At(i, k);
+        if (i == k || factor == T(0)) continue;
+        for (int j = 0; j < cols_; j++) {
+          lhs.At(i, j) -= factor * lhs.At(k, j);
+          result.At(i, j) -= factor * result.At(k, j);
+        }
+      }
+    }
+    return result;
+  }
+
+  bool operator==(const S21GenericMatrix& other) const {
+    return EqMatrix(other);
+  }
+  bool operator!=(const S21GenericMatrix& other) const {
+    return !EqMatrix(other);
+  }
+  S21GenericMatrix& operator+=(const S21GenericMatrix& other) {
+    SumMatrix(other);
+    return *this;
+  }
+  S21GenericMatrix& operator-=(const S21GenericMatrix& other) {
+    SubMatrix(other);
+    return *this;
+  }
+  S21GenericMatrix& operator*=(const S21GenericMatrix& other) {
+    MulMatrix(other);
+    return *this;
+  }
+  S21GenericMatrix& operator*=(T num) {
+    MulNumber(num);
+    return *this;
+  }
+  friend S21GenericMatrix operator+(S21GenericMatrix lhs,
+                                    const S21GenericMatrix& rhs) {
+    return lhs += rhs;
+  }
+  friend S21GenericMatrix operator-(S21GenericMatrix lhs,
+                                    const S21GenericMatrix& rhs) {
+    return lhs -= rhs;
+  }
+  friend S21GenericMatrix operator*(const S21GenericMatrix& lhs,
+                                    const S21GenericMatrix& rhs) {
+    return lhs.Multiply(rhs);
+  }
+  friend S21GenericMatrix operator*(S21GenericMatrix lhs, T num) {
+    return lhs *= num;
+  }
+  friend S21GenericMatrix operator*(T num, S21GenericMatrix rhs) {
+    return rhs *= num;
+  }
+
+ private:
+  T& At(int row, int col) { return data_[(std::size_t)row * cols_ + col]; }
+  const T& At(int row, int col) const {
+    return data_[(std::size_t)row * cols_ + col];
+  }
+  T* RowData(int row) { return data_.data() + (std::size_t)row * cols_; }
+  const T* RowData(int row) const {
+    return data_.data() + (std::size_t)row * cols_;
+  }
+  void CheckIndex(int row, int col) const {
+    if (row < 0 || row >= rows_ || col < 0 || col >= cols_)
+      throw std::out_of_range("Incorrect input, index is out of range");
+  }
+  void CheckSameShape(const S21GenericMatrix& other) const {
+    if (rows_ != other.rows_ || cols_ != other.cols_)
+      throw std::out_of_range("Different matrix dimensions");
+  }
+  int PivotRow(int k) const {
+    int pivot = k;
+    for (int i = k + 1; i < rows_; i++)
+      if (std::abs(At(i, k)) > std::abs(At(pivot, k))) pivot = i;
+    return pivot;
+  }
+  void SwapRows(int lhs, int rhs) {
+    if (lhs != rhs)
+      std::swap_ranges(RowData(lhs), RowData(lhs) + cols_, RowData(rhs));
+  }
+  // Pivots at most this large count as zero, as with
+  // s21_views::SingularTolerance.
+  auto SingularTolerance() const {
+    using Real = decltype(std::abs(T()));
+    Real largest = 0;
+    for (const T& value : data_) largest = std::max(largest, std::abs(value));
+    return rows_ * std::numeric_limits<Real>::epsilon() * largest;
+  }
+
+  int rows_, cols_;
+  std::pmr::vector<T> data_;
+};
+
+// Matrix of T: S21Matrix itself for double, which keeps the padded SIMD
+// storage and GEMM kernel, and S21GenericMatrix<T> otherwise. Both offer
+// the same operations, but T cannot be deduced through the alias.
+template <typename T>
+struct S21MatrixFor {
+  using Type = S21GenericMatrix<T>;
+};
+
+template <>
+struct S21MatrixFor<double> {
+  using Type = S21Matrix;
+};
+
+template <typename T>
+using BasicS21Matrix = typename S21MatrixFor<T>::Type;
+
+#endif  // SRC_S21_BASIC_MATRIX_
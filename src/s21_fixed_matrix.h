@@ -0,0 +1,316 @@
+#ifndef SRC_S21_FIXED_MATRIX_
+#define SRC_S21_FIXED_MATRIX_
+
+#include <initializer_list>
+#include <limits>
+#include <memory_resource>
+#include <stdexcept>
+#include <utility>
+
+#include "s21_matrix_oop.h"
+
+namespace s21_fixed_detail {
+
+// Loops with at most this many iterations are expanded at compile time.
+constexpr int kUnrollLimit = 16;
+
+template <typename F, int... I>
+constexpr void Unrolled(F& body, std::integer_sequence<int, I...>) {
+  (body(I), ...);
+}
+
+template <int N, typename F>
+constexpr void For(F&& body) {
+  if constexpr (N <= kUnrollLimit) {
+    Unrolled(body, std::make_integer_sequence<int, N>{});
+  } else {
+    for (int i = 0; i < N; i++) body(i);
+  }
+}
+
+constexpr double Abs(double value) { return value < 0 ? -value : value; }
+
+}  // namespace s21_fixed_detail
+
+// Stack-allocated R x C counterpart of S21Matrix with the same operation
+// set. Shapes are template parameters, so mismatched operands fail to
+// compile, operator() does no bounds checking and all kernels are
+// constexpr.
+template <int R, int C>
+class S21FixedMatrix {
+  static_assert(R > 0 && C > 0, "Number of rows or columns should be positive");
+
+  template <int, int>
+  friend class S21FixedMatrix;
+
+ public:
+  constexpr S21FixedMatrix() : data_{} {}
+  // Row-major element list.
+  constexpr S21FixedMatrix(std::initializer_list<double> values) : data_{} {
+    if (values.size() != static_cast<std::size_t>(R * C))
+      throw std::invalid_argument("Incorrect number of matrix elements");
+    int i = 0;
+    for (double value : values) data_[i++] = value;
+  }
+  explicit S21FixedMatrix(const S21Matrix& matrix) : data_{} {
+    if (matrix.GetRows() != R || matrix.GetCols() != C)
+      throw std::invalid_argument("Different matrix dimensions");
+    for (int row = 0; row < R; row++)
+      for (int col = 0; col < C; col++) (*this)(row, col) = matrix(row, col);
+  }
+
+  static constexpr int GetRows() { return R; }
+  static constexpr int GetCols() { return C; }
+
+  constexpr double& operator()(int row, int col) {
+    return data_[row * C + col];
+  }
+  constexpr const double& operator()(int row, int col) const {
+    return data_[row * C + col];
+  }
+  template <int Row, int Col>
+  constexpr double& Get() {
+    static_assert(Row >= 0 && Row < R && Col >= 0 && Col < C,
+                  "Incorrect input, index is out of range");
+    return data_[Row * C + Col];
+  }
+  template <int Row, int Col>
+  constexpr const double& Get() const {
+    static_assert(Row >= 0 && Row < R && Col >= 0 && Col < C,
+                  "Incorrect input, index is out of range");
+    return data_[Row * C + Col];
+  }
+
+  constexpr bool EqMatrix(const S21FixedMatrix& other) const {
+    bool code = true;
+    s21_fixed_detail::For<R * C>([&](int i) {
+      if (s21_fixed_detail::Abs(data_[i] - other.data_[i]) > 1e-7)
+        code = false;
+    });
+    return code;
+  }
+  constexpr void SumMatrix(const S21FixedMatrix& other) {
+    s21_fixed_detail::For<R * C>([&](int i) { data_[i] += other.data_[i]; });
+  }
+  constexpr void SubMatrix(const S21FixedMatrix& other) {
+    s21_fixed_detail::For<R * C>([&](int i) { data_[i] -= other.data_[i]; });
+  }
+  constexpr void MulNumber(const double num) {
+    s21_fixed_detail::For<R * C>([&](int i) { data_[i] *= num; });
+  }
+  // In-place product keeps the shape, so other has to be C x C.
+  constexpr void MulMatrix(const S21FixedMatrix<C, C>& other) {
+    *this = Multiply(other);
+  }
+  template <int K>
+  constexpr S21FixedMatrix<R, K> Multiply(
+      const S21FixedMatrix<C, K>& other) const {
+    S21FixedMatrix<R, K> result;
+    s21_fixed_detail::For<R>([&](int row) {
+      s21_fixed_detail::For<K>([&](int col) {
+        double sum = 0.0;
+        s21_fixed_detail::For<C>(
+            [&](int i) { sum += (*this)(row, i) * other(i, col); });
+        result(row, col) = sum;
+      });
+    });
+    return result;
+  }
+  constexpr S21FixedMatrix<C, R> Transpose() const {
+    S21FixedMatrix<C, R> result;
+    s21_fixed_detail::For<R>([&](int row) {
+      s21_fixed_detail::For<C>(
+          [&](int col) { result(col, row) = (*this)(row, col); });
+    });
+    return result;
+  }
+  constexpr S21FixedMatrix<R - 1, C - 1> GetMinor(int m_row, int m_col) const {
+    static_assert(R > 1 && C > 1, "The matrix has no minors");
+    S21FixedMatrix<R - 1, C - 1> result;
+    for (int row = 0, i = 0; row < R; row++) {
+      if (row == m_row) continue;
+      for (int col = 0, j = 0; col < C; col++) {
+        if (col != m_col) result(i, j++) = (*this)(row, col);
+      }
+      i++;
+    }
+    return result;
+  }
+  constexpr S21FixedMatrix CalcComplements() const {
+    static_assert(R == C && R > 1, "The matrix is not square");
+    S21FixedMatrix result;
+    for (int row = 0; row < R; row++) {
+      for (int col = 0; col < C; col++) {
+        const double det = GetMinor(row, col).Determinant();
+        result(row, col) = (row + col) % 2 == 0 ? det : -det;
+      }
+    }
+    return result;
+  }
+  constexpr double Determinant() const {
+    static_assert(R == C, "The matrix is not square");
+    const S21FixedMatrix& m = *this;
+    if constexpr (R == 1) {
+      return m(0, 0);
+    } else if constexpr (R == 2) {
+      return m(0, 0) * m(1, 1) - m(1, 0) * m(0, 1);
+    } else if constexpr (R == 3) {
+      return m(0, 0) * (m(1, 1) * m(2, 2) - m(1, 2) * m(2, 1)) -
+             m(0, 1) * (m(1, 0) * m(2, 2) - m(1, 2) * m(2, 0)) +
+             m(0, 2) * (m(1, 0) * m(2, 1) - m(1, 1) * m(2, 0));
+    } else {
+      // Only an exactly zero pivot gives 0, as in s21_views::Determinant.
+      S21FixedMatrix lu = *this;
+      double det = 1.0;
+      for (int k = 0; k < R; k++) {
+        const int pivot = lu.PivotRow(k);
+        if (lu(pivot, k) == 0.0) return 0.0;
+        if (pivot != k) lu.SwapRows(k, pivot), det = -det;
+        det *= lu(k, k);
+        for (int i = k + 1; i < R; i++) {
+          const double factor = lu(i, k) / lu(k, k);
+          for (int j = k + 1; j < C; j++) lu(i, j) -= factor * lu(k, j);
+        }
+      }
+      return det;
+    }
+  }
+  constexpr S21FixedMatrix InverseMatrix() const {
+    static_assert(R == C, "The matrix is not square");
+    const double largest = Largest();
+    const double tolerance = R * kEpsilon * largest;
+    // The closed form needs the determinant, about largest^R, to be a
+    // normal double; other scales go through elimination.
+    if constexpr (R <= 3) {
+      if (largest >= kClosedFormMin && largest <= kClosedFormMax) {
+        const double det = Determinant();
+        // |det| / largest^(R - 1) is on the scale of a pivot.
+        double pivot = s21_fixed_detail::Abs(det);
+        for (int i = 1; i < R; i++) pivot /= largest;
+        if (pivot <= tolerance)
+          throw std::invalid_argument(
+              "Matrix determinant is 0 or matrix is not square");
+        S21FixedMatrix result;
+        if constexpr (R == 1) {
+          result(0, 0) = 1 / det;
+        } else {
+          result = CalcComplements().Transpose();
+          result.MulNumber(1 / det);
+        }
+        return result;
+      }
+    }
+    // Gauss-Jordan elimination with partial pivoting.
+    S21FixedMatrix lhs = *this;
+    S21FixedMatrix result;
+    for (int i = 0; i < R; i++) result(i, i) = 1.0;
+    for (int k = 0; k < R; k++) {
+      const int pivot = lhs.PivotRow(k);
+      if (s21_fixed_detail::Abs(lhs(pivot, k)) <= tolerance)
+        throw std::invalid_argument(
+            "Matrix determinant is 0 or matrix is not square");
+      lhs.SwapRows(k, pivot);
+      result.SwapRows(k, pivot);
+      const double scale = 1 / lhs(k, k);
+      for (int j = 0; j < C; j++) lhs(k, j) *= scale, result(k, j) *= scale;
+      for (int i = 0; i < R; i++) {
+        const double factor = lhs(i, k);
+        if (i == k || factor == 0.0) continue;
+        for (int j = 0; j < C; j++) {
+          lhs(i, j) -= factor * lhs(k, j);
+          result(i, j) -= factor * result(k, j);
+        }
+      }
+    }
+    return result;
+  }
+
+  constexpr bool operator==(const S21FixedMatrix& other) const {
+    return EqMatrix(other);
+  }
+  constexpr bool operator!=(const S21FixedMatrix& other) const {
+    return !EqMatrix(other);
+  }
+  constexpr S21FixedMatrix& operator+=(const S21FixedMatrix& other) {
+    SumMatrix(other);
+    return *this;
+  }
+  constexpr S21FixedMatrix& operator-=(const S21FixedMatrix& other) {
+    SubMatrix(other);
+    return *this;
+  }
+  constexpr S21FixedMatrix& operator*=(const S21FixedMatrix<C, C>& other) {
+    MulMatrix(other);
+    return *this;
+  }
+  constexpr S21FixedMatrix& operator*=(double num) {
+    MulNumber(num);
+    return *this;
+  }
+  friend constexpr S21FixedMatrix operator+(S21FixedMatrix lhs,
+                                            const S21FixedMatrix& rhs) {
+    return lhs += rhs;
+  }
+  friend constexpr S21FixedMatrix operator-(S21FixedMatrix lhs,
+                                            const S21FixedMatrix& rhs) {
+    return lhs -= rhs;
+  }
+  friend constexpr S21FixedMatrix operator*(S21FixedMatrix lhs, double num) {
+    return lhs *= num;
+  }
+  friend constexpr S21FixedMatrix operator*(double num, S21FixedMatrix rhs) {
+    return rhs *= num;
+  }
+  template <int K>
+  constexpr S21FixedMatrix<R, K> operator*(
+      const S21FixedMatrix<C, K>& other) const {
+    return Multiply(other);
+  }
+
+  S21Matrix ToMatrix(
+      std::pmr::memory_resource* resource = S21SmallBlockPool::Instance())
+      const {
+    S21Matrix result(R, C, resource);
+    for (int row = 0; row < R; row++)
+      for (int col = 0; col < C; col++) result(row, col) = (*this)(row, col);
+    return result;
+  }
+  operator S21Matrix() const { return ToMatrix(); }
+
+ private:
+  static constexpr double kEpsilon = std::numeric_limits<double>::epsilon();
+  // Largest magnitudes for which the closed-form 3x3 determinant and its
+  // cofactors neither overflow nor lose precision to subnormals.
+  static constexpr double kClosedFormMin = 1e-90, kClosedFormMax = 1e90;
+
+  // Pivots at most R * kEpsilon times this count as zero, as with
+  // s21_views::SingularTolerance.
+  constexpr double Largest() const {
+    double largest = 0.0;
+    for (int i = 0; i < R * C; i++)
+      if (s21_fixed_detail::Abs(data_[i]) > largest)
+        largest = s21_fixed_detail::Abs(data_[i]);
+    return largest;
+  }
+  constexpr int PivotRow(int k) const {
+    int pivot = k;
+    for (int i = k + 1; i < R; i++) {
+      if (s21_fixed_detail::Abs((*this)(i, k)) >
+          s21_fixed_detail::Abs((*this)(pivot, k)))
+        pivot = i;
+    }
+    return pivot;
+  }
+  constexpr void SwapRows(int lhs, int rhs) {
+    if (lhs == rhs) return;
+    for (int col = 0; col < C; col++) {
+      const double temp = (*this)(lhs, col);
+      (*this)(lhs, col) = (*this)(rhs, col);
+      (*this)(rhs, col) = temp;
+    }
+  }
+
+  double data_[R * C];
+};
+
+#endif  // SRC_S21_FIXED_MATRIX_
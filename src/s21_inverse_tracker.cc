@@ -0,0 +1,257 @@
+#include "s21_inverse_tracker.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "s21_matrix_gemm.h"
+#include "s21_matrix_simd.h"
+#include "s21_thread_pool.h"
+
+namespace {
+
+using s21_kernels::Op;
+
+constexpr int kDefaultCheckInterval = 16;
+constexpr double kDefaultTolerance = 1e-10;
+// Below this rank the products go column by column through Gemv, which
+// streams the n x n operand at memory bandwidth; GEMM only pays off once
+// each element it loads is reused for enough columns.
+constexpr int kNarrowRank = 8;
+
+// a += alpha * x * y^T; rows with x_i = 0 are not touched, so updating
+// one row costs O(cols).
+void AddOuter(S21MatrixView a, double alpha, const double* x,
+              const double* y) {
+  const int cols = a.GetCols();
+  S21ThreadPool::ParallelFor(a.GetRows(), cols, [&](int begin, int end) {
+    for (int i = begin; i < end; i++)
+      if (x[i] != 0.0)
+        s21_kernels::Axpy(a.RowData(i), alpha * x[i], y, cols);
+  });
+}
+
+// dst = a * x for an n x k x.
+void MultiplyColumns(S21ConstMatrixView a, const S21Matrix& x,
+                     S21Matrix& dst) {
+  if (x.GetCols() >= kNarrowRank) {
+    s21_views::Multiply(a, x, dst);
+    return;
+  }
+  for (int j = 0; j < x.GetCols(); j++)
+    s21_views::Gemv(1.0, a, x.View().Col(j), 0.0, dst.View().Col(j));
+}
+
+// target += lhs * rhs^T for n x k lhs and rhs with contiguous rows.
+void AddProducts(S21MatrixView target, S21ConstMatrixView lhs,
+                 S21ConstMatrixView rhs) {
+  const int n = target.GetRows(), k = lhs.GetCols();
+  if (k >= kNarrowRank) {
+    s21_kernels::Gemm(Op::kNoTrans, Op::kTrans, n, n, k, lhs.Data(),
+                      (int)lhs.GetRowStride(), rhs.Data(),
+                      (int)rhs.GetRowStride(), target.Data(),
+                      (int)target.GetRowStride());
+    return;
+  }
+  for (int j = 0; j < k; j++) {
+    const S21Vector x(lhs.Col(j)), y(rhs.Col(j));
+    AddOuter(target, 1.0, x.Data(), y.Data());
+  }
+}
+
+double NormInf(S21ConstMatrixView a) {
+  double norm = 0.0;
+  for (int i = 0; i < a.GetRows(); i++)
+    norm = std::max(norm, s21_kernels::AbsSum(a.RowData(i), a.GetCols()));
+  return norm;
+}
+
+double NormFrobenius(S21ConstMatrixView a) {
+  double sum = 0.0;
+  for (int i = 0; i < a.GetRows(); i++)
+    sum += s21_kernels::SumSquares(a.RowData(i), a.GetCols());
+  return std::sqrt(sum);
+}
+
+S21Vector UnitVector(int size, int index) {
+  S21Vector unit(size);
+  unit(index) = 1.0;
+  return unit;
+}
+
+}  // namespace
+
+S21InverseTracker::S21InverseTracker(const S21Matrix& matrix)
+    : matrix_(matrix),
+      inverse_(matrix.GetResource()),
+      probe_(matrix.GetRows(), matrix.GetResource()),
+      check_interval_(kDefaultCheckInterval),
+      tolerance_(kDefaultTolerance) {
+  if (matrix.GetRows() != matrix.GetCols())
+    throw std::invalid_argument("The matrix is not square");
+  const S21LU lu(matrix_);
+  if (lu.IsSingular()) throw std::invalid_argument("Matrix is singular");
+  Install(lu);
+  for (int i = 0; i < probe_.GetSize(); i++)
+    probe_(i) = ((i * 7919 + 13) % 2003) / 1001.0 - 1.0;
+}
+
+S21Matrix S21InverseTracker::Solve(const S21Matrix& b) const {
+  if (b.GetRows() != GetSize())
+    throw std::out_of_range("Different matrix dimensions");
+  S21Matrix x(GetSize(), b.GetCols(), b.GetResource());
+  s21_views::Multiply(inverse_, b, x);
+  return x;
+}
+
+S21Vector S21InverseTracker::Solve(const S21Vector& b) const {
+  if (b.GetSize() != GetSize())
+    throw std::out_of_range("Different matrix dimensions");
+  S21Vector x(GetSize());
+  x.Gemv(1.0, inverse_, b);
+  return x;
+}
+
+void S21InverseTracker::RankOneUpdate(const S21Vector& u,
+                                      const S21Vector& v) {
+  const int n = GetSize();
+  if (u.GetSize() != n || v.GetSize() != n)
+    throw std::out_of_range("Different matrix dimensions");
+  // (A + u v^T)^-1 = A^-1 - w z^T / (1 + v^T w) with w = A^-1 u and
+  // z = A^-T v; the denominator is also the ratio of the determinants.
+  S21Vector w(n, matrix_.GetResource()), z(n, matrix_.GetResource());
+  w.Gemv(1.0, inverse_, u);
+  z.GemvTransposed(1.0, inverse_, v);
+  const double denominator = 1.0 + v.Dot(w);
+  const double amplification =
+      (1.0 + v.Norm2() * w.Norm2()) / std::fabs(denominator);
+  if (!(amplification * std::numeric_limits<double>::epsilon() <=
+        tolerance_)) {
+    RefactorUpdated(u.View(), v.View());
+    return;
+  }
+  AddOuter(matrix_, 1.0, u.Data(), v.Data());
+  AddOuter(inverse_, -1.0 / denominator, w.Data(), z.Data());
+  determinant_ *= denominator;
+  FinishUpdate();
+}
+
+void S21InverseTracker::Update(const S21Matrix& u, const S21Matrix& v) {
+  const int n = GetSize(), k = u.GetCols();
+  if (u.GetRows() != n || v.GetRows() != n || v.GetCols() != k)
+    throw std::out_of_range("Different matrix dimensions");
+  if (k == 0) return;
+  // (A + U V^T)^-1 = A^-1 - A^-1 U C^-1 V^T A^-1 with the k x k
+  // capacitance matrix C = I + V^T A^-1 U, and det(A + U V^T) =
+  // det(A) * det(C).
+  std::pmr::memory_resource* resource = matrix_.GetResource();
+  // A^-1 U and A^-T V; the latter is (V^T A^-1)^T.
+  S21Matrix inverse_u(n, k, resource), inverse_v(n, k, resource);
+  MultiplyColumns(inverse_, u, inverse_u);
+  MultiplyColumns(inverse_.View().Transposed(), v, inverse_v);
+  S21Matrix capacitance(k, k, resource);
+  s21_views::Multiply(v.View().Transposed(), inverse_u, capacitance);
+  for (int i = 0; i < k; i++) capacitance(i, i) += 1.0;
+  const S21LU lu(capacitance);
+  if (lu.IsSingular()) {
+    RefactorUpdated(u, v);
+    return;
+  }
+  const S21Matrix capacitance_inverse = lu.Inverse();
+  const double amplification =
+      NormInf(capacitance_inverse) *
+      (1.0 + NormFrobenius(v) * NormFrobenius(inverse_u));
+  if (!(amplification * std::numeric_limits<double>::epsilon() <=
+        tolerance_)) {
+    RefactorUpdated(u, v);
+    return;
+  }
+  // A^-1 -= A^-1 U * (A^-T V C^-T)^T.
+  S21Matrix correction(n, k, resource);
+  s21_views::Multiply(inverse_v, capacitance_inverse.View().Transposed(),
+                      correction);
+  inverse_u.MulNumber(-1.0);
+  AddProducts(inverse_, inverse_u, correction);
+  AddProducts(matrix_, u, v);
+  determinant_ *= lu.Determinant();
+  FinishUpdate();
+}
+
+void S21InverseTracker::SetRow(int row, const S21Vector& values) {
+  const int n = GetSize();
+  if (row < 0 || row >= n)
+    throw std::out_of_range("Incorrect input, index is out of range");
+  if (values.GetSize() != n)
+    throw std::out_of_range("Different matrix dimensions");
+  S21Vector delta(values);
+  delta -= S21Vector(matrix_.View().Row(row));
+  RankOneUpdate(UnitVector(n, row), delta);
+  // old + (new - old) may differ from new in the last bit.
+  std::copy(values.Data(), values.Data() + n, matrix_.View().RowData(row));
+}
+
+void S21InverseTracker::SetCol(int col, const S21Vector& values) {
+  const int n = GetSize();
+  if (col < 0 || col >= n)
+    throw std::out_of_range("Incorrect input, index is out of range");
+  if (values.GetSize() != n)
+    throw std::out_of_range("Different matrix dimensions");
+  S21Vector delta(values);
+  delta -= S21Vector(matrix_.View().Col(col));
+  RankOneUpdate(delta, UnitVector(n, col));
+  for (int i = 0; i < n; i++) matrix_(i, col) = values(i);
+}
+
+void S21InverseTracker::Refactor() {
+  const S21LU lu(matrix_);
+  if (lu.IsSingular()) throw std::invalid_argument("Matrix is singular");
+  Install(lu);
+  refactorizations_++;
+}
+
+double S21InverseTracker::Drift() const {
+  const int n = GetSize();
+  if (n == 0) return 0.0;
+  S21Vector y(n), residual(probe_);
+  y.Gemv(1.0, inverse_, probe_);
+  residual.Gemv(1.0, matrix_, y, -1.0);
+  return residual.NormInf() /
+         (NormInf(matrix_) * y.NormInf() + probe_.NormInf());
+}
+
+void S21InverseTracker::SetCheckInterval(int updates) {
+  if (updates < 0)
+    throw std::invalid_argument("Check interval should not be negative");
+  check_interval_ = updates;
+}
+
+void S21InverseTracker::SetTolerance(double tolerance) {
+  if (!(tolerance > 0.0))
+    throw std::invalid_argument("Tolerance should be positive");
+  tolerance_ = tolerance;
+}
+
+void S21InverseTracker::RefactorUpdated(S21ConstMatrixView u,
+                                        S21ConstMatrixView v) {
+  S21Matrix updated(matrix_);
+  AddProducts(updated, u, v);
+  const S21LU lu(updated);
+  if (lu.IsSingular()) throw std::invalid_argument("Matrix is singular");
+  matrix_ = std::move(updated);
+  Install(lu);
+  refactorizations_++;
+}
+
+void S21InverseTracker::Install(const S21LU& lu) {
+  lu.InverseInto(inverse_);
+  determinant_ = lu.Determinant();
+  updates_ = 0;
+}
+
+void S21InverseTracker::FinishUpdate() {
+  updates_++;
+  if (check_interval_ > 0 && updates_ % check_interval_ == 0 &&
+      !(Drift() <= tolerance_))
+    Refactor();
+}
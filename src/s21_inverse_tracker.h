@@ -0,0 +1,77 @@
+#ifndef SRC_S21_INVERSE_TRACKER_
+#define SRC_S21_INVERSE_TRACKER_
+
+#include "s21_matrix_oop.h"
+#include "s21_vector.h"
+
+// A non-singular square matrix together with its inverse and determinant,
+// kept current through low-rank changes. A += U * V^T with n x k U and V
+// updates the inverse by Sherman-Morrison-Woodbury and the determinant by
+// the matrix determinant lemma in O(n^2 * k) instead of the O(n^3) of a new
+// factorization. Rounding errors of the updates accumulate, so every few
+// updates the backward error of the inverse is measured on a probe vector
+// in O(n^2), and the inverse is recomputed from an LU factorization once it
+// exceeds the tolerance. Updates whose capacitance matrix is close to
+// singular, which would amplify the error, refactor at once. An update
+// that makes A singular throws std::invalid_argument and leaves the tracker
+// unchanged.
+class S21InverseTracker {
+ public:
+  explicit S21InverseTracker(const S21Matrix& matrix);
+
+  int GetSize() const { return matrix_.GetRows(); }
+  const S21Matrix& Matrix() const { return matrix_; }
+  const S21Matrix& Inverse() const { return inverse_; }
+  double Determinant() const { return determinant_; }
+  // X = A^-1 * B through the stored inverse.
+  S21Matrix Solve(const S21Matrix& b) const;
+  S21Vector Solve(const S21Vector& b) const;
+
+  // A += u * v^T.
+  void RankOneUpdate(const S21Vector& u, const S21Vector& v);
+  // A += u * v^T with the k columns of u and v.
+  void Update(const S21Matrix& u, const S21Matrix& v);
+  // Replace one row or column of A; rank-one updates that only touch that
+  // row or column of the matrix itself.
+  void SetRow(int row, const S21Vector& values);
+  void SetCol(int col, const S21Vector& values);
+
+  // Recomputes the inverse and the determinant from A.
+  void Refactor();
+  // Normwise backward error |A * y - x| / (|A| * |y| + |x|) of y = A^-1 * x
+  // for the probe vector x, in the infinity norm.
+  double Drift() const;
+
+  // Updates between drift checks; 0 never checks.
+  void SetCheckInterval(int updates);
+  int GetCheckInterval() const { return check_interval_; }
+  // Largest Drift() accepted before refactoring. Updates that may amplify
+  // rounding errors past it refactor immediately.
+  void SetTolerance(double tolerance);
+  double GetTolerance() const { return tolerance_; }
+  int UpdatesSinceRefactor() const { return updates_; }
+  // Refactorizations after the construction, by drift checks, near-singular
+  // updates or Refactor().
+  int Refactorizations() const { return refactorizations_; }
+
+ private:
+  // Refactors the matrix A + u * v^T, committing it only if it is not
+  // singular.
+  void RefactorUpdated(S21ConstMatrixView u, S21ConstMatrixView v);
+  // Takes the inverse and the determinant from a factorization of A.
+  void Install(const S21LU& lu);
+  // Counts an update and runs the drift check when one is due.
+  void FinishUpdate();
+
+  S21Matrix matrix_;
+  S21Matrix inverse_;
+  double determinant_ = 0.0;
+  // Fixed pseudo-random entries in [-1, 1].
+  S21Vector probe_;
+  int check_interval_;
+  double tolerance_;
+  int updates_ = 0;
+  int refactorizations_ = 0;
+};
+
+#endif  // SRC_S21_INVERSE_TRACKER_
@@ -0,0 +1,374 @@
+#include "s21_matrix_batch.h"
+
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include "s21_matrix_simd.h"
+#include "s21_thread_pool.h"
+
+namespace {
+
+constexpr int kLanes = S21MatrixBatch::kLanes;
+
+// One element of every matrix in a group. GCC lowers the arithmetic to
+// the vector width of the function it is inlined into; loads and stores
+// go through memcpy, as in the GEMM micro-kernel. Vectors are passed by
+// reference and the helpers returning one are internal and inlined, so
+// the ABI warning about 64-byte vectors does not apply.
+#pragma GCC diagnostic ignored "-Wpsabi"
+typedef double Lanes __attribute__((vector_size(kLanes * sizeof(double))));
+typedef long Mask __attribute__((vector_size(kLanes * sizeof(long))));
+
+#define S21_BATCH_INLINE inline __attribute__((always_inline))
+
+S21_BATCH_INLINE Lanes Load(const double* src) {
+  Lanes value;
+  std::memcpy(&value, src, sizeof(value));
+  return value;
+}
+
+S21_BATCH_INLINE void Store(double* dst, const Lanes& value) {
+  std::memcpy(dst, &value, sizeof(value));
+}
+
+// dst -= factor * src over count consecutive elements of a row.
+S21_BATCH_INLINE void Update(double* dst, const double* src, int count,
+                             const Lanes& factor) {
+  for (int j = 0; j < count; j++, dst += kLanes, src += kLanes)
+    Store(dst, Load(dst) - factor * Load(src));
+}
+
+S21_BATCH_INLINE void Scale(double* dst, int count, const Lanes& factor) {
+  for (int j = 0; j < count; j++, dst += kLanes)
+    Store(dst, Load(dst) * factor);
+}
+
+// Swaps count consecutive elements of two rows in the lanes set in swap.
+S21_BATCH_INLINE void Blend(double* x, double* y, int count,
+                            const Mask& swap) {
+  for (int j = 0; j < count; j++, x += kLanes, y += kLanes) {
+    const Lanes lhs = Load(x), rhs = Load(y);
+    Store(x, swap ? rhs : lhs);
+    Store(y, swap ? lhs : rhs);
+  }
+}
+
+// c = a * b for one group; a is rows x inner, b is inner x cols.
+S21_BATCH_INLINE void MultiplyGroupBody(int rows, int inner, int cols,
+                                        const double* a, const double* b,
+                                        double* c) {
+  for (int row = 0; row < rows; row++) {
+    for (int col = 0; col < cols; col++) {
+      Lanes acc = {};
+      for (int k = 0; k < inner; k++)
+        acc += Load(a + (row * inner + k) * kLanes) *
+               Load(b + (k * cols + col) * kLanes);
+      Store(c + (row * cols + col) * kLanes, acc);
+    }
+  }
+}
+
+// Gaussian elimination of the n x n group a, repeating every row
+// operation on the n x m group b. Partial pivoting is done per lane: a
+// candidate row replaces the pivot row in exactly the lanes where it is
+// larger in magnitude, which ends with the largest pivot in every lane
+// without branching on data. With jordan set, rows above the pivot are
+// cleared as well and pivot rows are normalized, leaving A^-1 * B in b.
+// Lanes with a zero pivot carry on with a zero multiplier and report a
+// zero determinant; with jordan set, so do pivots within
+// s21_views::SingularTolerance of zero, which Solve and InverseMatrix
+// reject. Otherwise the determinant is the exact product of the pivots.
+S21_BATCH_INLINE void EliminateGroupBody(int n, int m, bool jordan, double* a,
+                                         double* b, double* determinants) {
+  auto at = [&](int row, int col) { return a + (row * n + col) * kLanes; };
+  auto rhs_at = [&](int row, int col) { return b + (row * m + col) * kLanes; };
+  const Lanes zero = {};
+  Lanes largest = zero;
+  for (int i = 0; i < n * n; i++) {
+    const Lanes value = Load(a + i * kLanes);
+    const Lanes magnitude = value < 0 ? -value : value;
+    largest = magnitude > largest ? magnitude : largest;
+  }
+  const Lanes tolerance =
+      largest * (n * std::numeric_limits<double>::epsilon());
+  Lanes det = zero + 1.0;
+  for (int k = 0; k < n; k++) {
+    for (int i = k + 1; i < n; i++) {
+      const Lanes candidate = Load(at(i, k)), pivot = Load(at(k, k));
+      const Mask swap = (candidate < 0 ? -candidate : candidate) >
+                        (pivot < 0 ? -pivot : pivot);
+      bool any = false;
+      for (int l = 0; l < kLanes; l++) any |= swap[l] != 0;
+      if (!any) continue;
+      Blend(at(k, k), at(i, k), n - k, swap);
+      Blend(rhs_at(k, 0), rhs_at(i, 0), m, swap);
+      det = swap ? -det : det;
+    }
+    const Lanes pivot = Load(at(k, k));
+    const Mask usable =
+        jordan ? (pivot < 0 ? -pivot : pivot) > tolerance : pivot != 0;
+    det = usable ? det * pivot : zero;
+    const Lanes inverse = usable ? 1.0 / pivot : zero;
+    for (int i = jordan ? 0 : k + 1; i < n; i++) {
+      if (i == k) continue;
+      const Lanes factor = Load(at(i, k)) * inverse;
+      Update(at(i, k + 1), at(k, k + 1), n - k - 1, factor);
+      Update(rhs_at(i, 0), rhs_at(k, 0), m, factor);
+    }
+    if (jordan) {
+      Scale(at(k, k + 1), n - k - 1, inverse);
+      Scale(rhs_at(k, 0), m, inverse);
+    }
+  }
+  Store(determinants, det);
+}
+
+struct GroupKernels {
+  void (*multiply)(int, int, int, const double*, const double*, double*);
+  void (*eliminate)(int, int, bool, double*, double*, double*);
+};
+
+// The bodies are compiled once per instruction set and picked at run time
+// from s21_kernels::ActiveSimdLevel(). No variant enables FMA, so all of
+// them round identically.
+#define S21_DEFINE_GROUP_KERNELS(SUFFIX, ATTRIBUTES)                         \
+  ATTRIBUTES void MultiplyGroup##SUFFIX(int rows, int inner, int cols,       \
+                                        const double* a, const double* b,    \
+                                        double* c) {                         \
+    MultiplyGroupBody(rows, inner, cols, a, b, c);                           \
+  }                                                                          \
+  ATTRIBUTES void EliminateGroup##SUFFIX(int n, int m, bool jordan,          \
+                                         double* a, double* b,               \
+                                         double* determinants) {             \
+    EliminateGroupBody(n, m, jordan, a, b, determinants);                    \
+  }                                                                          \
+  const GroupKernels k##SUFFIX##Kernels = {MultiplyGroup##SUFFIX,            \
+                                           EliminateGroup##SUFFIX};
+
+S21_DEFINE_GROUP_KERNELS(Generic, )
+#if defined(__x86_64__) || defined(__i386__)
+S21_DEFINE_GROUP_KERNELS(Avx2, __attribute__((target("avx2"))))
+S21_DEFINE_GROUP_KERNELS(Avx512, __attribute__((target("avx512f"))))
+#endif
+
+#undef S21_DEFINE_GROUP_KERNELS
+#undef S21_BATCH_INLINE
+
+const GroupKernels& Active() {
+#if defined(__x86_64__) || defined(__i386__)
+  switch (s21_kernels::ActiveSimdLevel()) {
+    case s21_kernels::SimdLevel::kAvx512:
+      return kAvx512Kernels;
+    case s21_kernels::SimdLevel::kAvx2:
+      return kAvx2Kernels;
+    default:
+      break;
+  }
+#endif
+  return kGenericKernels;
+}
+
+}  // namespace
+
+S21MatrixBatch::S21MatrixBatch(int count, int rows, int cols,
+                               std::pmr::memory_resource* resource)
+    : count_(count), rows_(rows), cols_(cols), storage_(resource) {
+  if (count < 0 || rows < 0 || cols < 0)
+    throw std::invalid_argument("Number of rows or columns should be positive");
+  storage_ = S21Matrix(Groups(), Elements() * kLanes, resource);
+}
+
+double& S21MatrixBatch::operator()(int index, int row, int col) {
+  const S21MatrixBatch& self = *this;
+  return const_cast<double&>(self(index, row, col));
+}
+
+const double& S21MatrixBatch::operator()(int index, int row, int col) const {
+  if (index < 0 || index >= count_ || row < 0 || row >= rows_ || col < 0 ||
+      col >= cols_)
+    throw std::out_of_range("Incorrect input, index is out of range");
+  return Group(index / kLanes)[(row * cols_ + col) * kLanes + index % kLanes];
+}
+
+S21Matrix S21MatrixBatch::Get(int index) const {
+  S21Matrix result(rows_, cols_, storage_.GetResource());
+  for (int row = 0; row < rows_; row++)
+    for (int col = 0; col < cols_; col++)
+      result(row, col) = (*this)(index, row, col);
+  return result;
+}
+
+void S21MatrixBatch::Set(int index, const S21Matrix& matrix) {
+  if (matrix.GetRows() != rows_ || matrix.GetCols() != cols_)
+    throw std::out_of_range("Different matrix dimensions");
+  for (int row = 0; row < rows_; row++)
+    for (int col = 0; col < cols_; col++)
+      (*this)(index, row, col) = matrix(row, col);
+}
+
+void S21MatrixBatch::CheckSameShape(const S21MatrixBatch& other) const {
+  if (count_ != other.count_ || rows_ != other.rows_ || cols_ != other.cols_)
+    throw std::out_of_range("Different matrix dimensions");
+}
+
+// Unused lanes of the last group stay zero through every operation, so
+// whole-storage comparisons and updates are safe.
+bool S21MatrixBatch::EqMatrix(const S21MatrixBatch& other) const {
+  if (count_ != other.count_ || rows_ != other.rows_ || cols_ != other.cols_)
+    return false;
+  return storage_.EqMatrix(other.storage_);
+}
+
+void S21MatrixBatch::SumMatrix(const S21MatrixBatch& other) {
+  CheckSameShape(other);
+  storage_.SumMatrix(other.storage_);
+}
+
+void S21MatrixBatch::SubMatrix(const S21MatrixBatch& other) {
+  CheckSameShape(other);
+  storage_.SubMatrix(other.storage_);
+}
+
+void S21MatrixBatch::MulNumber(double num) { storage_.MulNumber(num); }
+
+void S21MatrixBatch::MulMatrix(const S21MatrixBatch& other) {
+  if (count_ != other.count_ || cols_ != other.rows_)
+    throw std::out_of_range(
+        "Invalid matrix sizes: number of cols of the first matrix must be "
+        "equal to the number of rows of the second matrix");
+  const int inner = cols_, cols = other.cols_;
+  const GroupKernels& kernels = Active();
+  const long cost = (long)rows_ * cols * inner * kLanes;
+  if (cols == cols_) {
+    // The shape is unchanged: each group goes through a per-task scratch
+    // block and back, so no batch-sized buffer is allocated.
+    S21ThreadPool::ParallelFor(Groups(), cost, [&](int begin, int end) {
+      std::vector<double> scratch((std::size_t)Elements() * kLanes);
+      for (int group = begin; group < end; group++) {
+        kernels.multiply(rows_, inner, cols, Group(group), other.Group(group),
+                         scratch.data());
+        std::memcpy(Group(group), scratch.data(),
+                    scratch.size() * sizeof(double));
+      }
+    });
+    return;
+  }
+  S21MatrixBatch result(count_, rows_, cols, storage_.GetResource());
+  S21ThreadPool::ParallelFor(Groups(), cost, [&](int begin, int end) {
+    for (int group = begin; group < end; group++)
+      kernels.multiply(rows_, inner, cols, Group(group), other.Group(group),
+                       result.Group(group));
+  });
+  *this = std::move(result);
+}
+
+void S21MatrixBatch::Eliminate(S21MatrixBatch* rhs, bool jordan,
+                               std::vector<double>* determinants) {
+  const int n = rows_;
+  const int m = rhs ? rhs->cols_ : 0;
+  const GroupKernels& kernels = Active();
+  determinants->assign((std::size_t)Groups() * kLanes, 0.0);
+  S21ThreadPool::ParallelFor(
+      Groups(), (long)n * n * (n + m) * kLanes, [&](int begin, int end) {
+        for (int group = begin; group < end; group++)
+          kernels.eliminate(n, m, jordan, Group(group),
+                            rhs ? rhs->Group(group) : nullptr,
+                            determinants->data() + group * kLanes);
+      });
+  determinants->resize(count_);
+}
+
+std::vector<double> S21MatrixBatch::Determinant() const {
+  if (rows_ != cols_) throw std::invalid_argument("The matrix is not square");
+  S21MatrixBatch work(*this);
+  std::vector<double> determinants;
+  work.Eliminate(nullptr, false, &determinants);
+  return determinants;
+}
+
+S21MatrixBatch S21MatrixBatch::InverseMatrix() const {
+  if (rows_ != cols_ || rows_ == 0)
+    throw std::invalid_argument(
+        "Matrix determinant is 0 or matrix is not square");
+  S21MatrixBatch identity(count_, rows_, cols_, storage_.GetResource());
+  for (int group = 0; group < Groups(); group++) {
+    for (int i = 0; i < rows_; i++) {
+      double* diagonal = identity.Group(group) + (i * cols_ + i) * kLanes;
+      for (int l = 0; l < kLanes && group * kLanes + l < count_; l++)
+        diagonal[l] = 1.0;
+    }
+  }
+  S21MatrixBatch work(*this);
+  std::vector<double> determinants;
+  work.Eliminate(&identity, true, &determinants);
+  for (double det : determinants)
+    if (det == 0.0)
+      throw std::invalid_argument(
+          "Matrix determinant is 0 or matrix is not square");
+  return identity;
+}
+
+S21MatrixBatch S21MatrixBatch::Solve(const S21MatrixBatch& b) const {
+  if (rows_ != cols_) throw std::invalid_argument("The matrix is not square");
+  if (b.count_ != count_ || b.rows_ != rows_)
+    throw std::out_of_range(
+        "Invalid matrix sizes: right-hand side must have as many rows as the "
+        "system matrix");
+  S21MatrixBatch x(b);
+  S21MatrixBatch work(*this);
+  std::vector<double> determinants;
+  work.Eliminate(&x, true, &determinants);
+  for (double det : determinants)
+    if (det == 0.0) throw std::invalid_argument("Matrix is singular");
+  return x;
+}
+
+bool S21MatrixBatch::operator==(const S21MatrixBatch& other) const {
+  return EqMatrix(other);
+}
+
+bool S21MatrixBatch::operator!=(const S21MatrixBatch& other) const {
+  return !EqMatrix(other);
+}
+
+S21MatrixBatch& S21MatrixBatch::operator+=(const S21MatrixBatch& other) {
+  SumMatrix(other);
+  return *this;
+}
+
+S21MatrixBatch& S21MatrixBatch::operator-=(const S21MatrixBatch& other) {
+  SubMatrix(other);
+  return *this;
+}
+
+S21MatrixBatch& S21MatrixBatch::operator*=(const S21MatrixBatch& other) {
+  MulMatrix(other);
+  return *this;
+}
+
+S21MatrixBatch& S21MatrixBatch::operator*=(double num) {
+  MulNumber(num);
+  return *this;
+}
+
+S21MatrixBatch operator+(S21MatrixBatch lhs, const S21MatrixBatch& rhs) {
+  return lhs += rhs;
+}
+
+S21MatrixBatch operator-(S21MatrixBatch lhs, const S21MatrixBatch& rhs) {
+  return lhs -= rhs;
+}
+
+S21MatrixBatch operator*(S21MatrixBatch lhs, const S21MatrixBatch& rhs) {
+  return lhs *= rhs;
+}
+
+S21MatrixBatch operator*(S21MatrixBatch lhs, double num) {
+  return lhs *= num;
+}
+
+S21MatrixBatch operator*(double num, S21MatrixBatch rhs) {
+  return rhs *= num;
+}
@@ -0,0 +1,75 @@
+#ifndef SRC_S21_MATRIX_BATCH_
+#define SRC_S21_MATRIX_BATCH_
+
+#include <memory_resource>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+// Count independent rows x cols matrices in one buffer. Matrices are
+// interleaved in groups of kLanes: element (row, col) of every matrix in a
+// group occupies kLanes consecutive doubles, so each kernel runs the
+// scalar algorithm on a whole group at once with vector instructions, and
+// groups are split between threads. Aimed at many small (up to about
+// 16 x 16) matrices.
+class S21MatrixBatch {
+ public:
+  static constexpr int kLanes = 8;
+
+  S21MatrixBatch(int count, int rows, int cols,
+                 std::pmr::memory_resource* resource =
+                     S21SmallBlockPool::Instance());
+
+  int GetCount() const { return count_; }
+  int GetRows() const { return rows_; }
+  int GetCols() const { return cols_; }
+
+  double& operator()(int index, int row, int col);
+  const double& operator()(int index, int row, int col) const;
+  S21Matrix Get(int index) const;
+  void Set(int index, const S21Matrix& matrix);
+
+  bool EqMatrix(const S21MatrixBatch& other) const;
+  void SumMatrix(const S21MatrixBatch& other);
+  void SubMatrix(const S21MatrixBatch& other);
+  void MulNumber(double num);
+  // Replaces every matrix i with matrix i * other matrix i.
+  void MulMatrix(const S21MatrixBatch& other);
+  std::vector<double> Determinant() const;
+  S21MatrixBatch InverseMatrix() const;
+  // Solves matrix i * X = b matrix i for every i.
+  S21MatrixBatch Solve(const S21MatrixBatch& b) const;
+
+  bool operator==(const S21MatrixBatch& other) const;
+  bool operator!=(const S21MatrixBatch& other) const;
+  S21MatrixBatch& operator+=(const S21MatrixBatch& other);
+  S21MatrixBatch& operator-=(const S21MatrixBatch& other);
+  S21MatrixBatch& operator*=(const S21MatrixBatch& other);
+  S21MatrixBatch& operator*=(double num);
+
+ private:
+  int Groups() const { return (count_ + kLanes - 1) / kLanes; }
+  int Elements() const { return rows_ * cols_; }
+  double* Group(int group) { return storage_.View().RowData(group); }
+  const double* Group(int group) const {
+    return storage_.View().RowData(group);
+  }
+  void CheckSameShape(const S21MatrixBatch& other) const;
+  // Gaussian elimination of every matrix in place, repeating the row
+  // operations on the matching matrix of rhs (which may be null); see the
+  // definition.
+  void Eliminate(S21MatrixBatch* rhs, bool jordan,
+                 std::vector<double>* determinants);
+
+  int count_, rows_, cols_;
+  // One row per group of kLanes matrices.
+  S21Matrix storage_;
+};
+
+S21MatrixBatch operator+(S21MatrixBatch lhs, const S21MatrixBatch& rhs);
+S21MatrixBatch operator-(S21MatrixBatch lhs, const S21MatrixBatch& rhs);
+S21MatrixBatch operator*(S21MatrixBatch lhs, const S21MatrixBatch& rhs);
+S21MatrixBatch operator*(S21MatrixBatch lhs, double num);
+S21MatrixBatch operator*(double num, S21MatrixBatch rhs);
+
+#endif  // SRC_S21_MATRIX_BATCH_
@@ -0,0 +1,1000 @@
+#include "s21_matrix_eigen.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+#include "s21_matrix_gemm.h"
+#include "s21_matrix_householder.h"
+#include "s21_matrix_simd.h"
+#include "s21_matrix_solvers.h"
+#include "s21_thread_pool.h"
+
+namespace {
+
+using s21_kernels::Op;
+
+constexpr double kEpsilon = std::numeric_limits<double>::epsilon();
+// Columns per panel of the tridiagonal and bidiagonal reductions.
+constexpr int kPanel = 32;
+// Divide and conquer leaves blocks up to this size to QL iteration.
+constexpr int kLeafSize = 32;
+constexpr int kMaxQlIterations = 60;
+// Newton steps, bisection where they leave the bracket, per secular root.
+constexpr int kMaxSecularIterations = 300;
+constexpr unsigned kRandomSeed = 20240521u;
+
+double MaxAbs(S21ConstMatrixView a) {
+  double max = 0.0;
+  for (int i = 0; i < a.GetRows(); i++)
+    max = std::max(max, s21_kernels::AbsMax(a.RowData(i), a.GetCols()));
+  return max;
+}
+
+// A power of two that brings the largest element near 1 when squares of
+// the elements could overflow or underflow, 1 otherwise.
+double ScaleFor(double max_abs) {
+  if (max_abs == 0.0 || (max_abs > 0x1p-400 && max_abs < 0x1p400)) return 1.0;
+  int exponent;
+  std::frexp(max_abs, &exponent);
+  return std::ldexp(1.0, -exponent);
+}
+
+// Sorts values ascending, and the columns of q with them unless q is empty.
+void SortAscending(int n, double* values, S21MatrixView q) {
+  std::vector<int> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [values](int a, int b) { return values[a] < values[b]; });
+  std::vector<double> sorted(n);
+  for (int i = 0; i < n; i++) sorted[i] = values[order[i]];
+  std::copy(sorted.begin(), sorted.end(), values);
+  if (q.Empty()) return;
+  const S21Matrix copy(q);
+  for (int r = 0; r < q.GetRows(); r++)
+    for (int i = 0; i < n; i++) q.At(r, i) = copy(r, order[i]);
+}
+
+// Implicit QL iteration with Wilkinson shifts on the symmetric tridiagonal
+// matrix with diagonal d and off-diagonal e, where e[i] couples i and
+// i + 1 and e[n - 1] is scratch. The eigenvalues replace d, unsorted; the
+// rotations are accumulated into the columns of q unless q is empty.
+void TridiagonalQl(int n, double* d, double* e, S21MatrixView q) {
+  if (n == 0) return;
+  e[n - 1] = 0.0;
+  double norm = 0.0;
+  for (int i = 0; i < n; i++)
+    norm = std::max(norm, std::fabs(d[i]) + std::fabs(e[i]));
+  // Couplings are dropped relative to their diagonal elements, or to the
+  // whole matrix for eigenvalues at its noise level, which the relative
+  // test could never separate.
+  const double floor =
+      std::max(kEpsilon * norm, std::numeric_limits<double>::min());
+  for (int l = 0; l < n; l++) {
+    for (int iteration = 0;; iteration++) {
+      int m = l;
+      for (; m < n - 1; m++) {
+        const double dd = std::fabs(d[m]) + std::fabs(d[m + 1]);
+        if (std::fabs(e[m]) <= kEpsilon * dd || std::fabs(e[m]) <= floor)
+          break;
+      }
+      if (m == l) break;
+      if (iteration == kMaxQlIterations)
+        throw std::runtime_error("Eigenvalue iteration did not converge");
+      double g = (d[l + 1] - d[l]) / (2.0 * e[l]);
+      double r = std::hypot(g, 1.0);
+      g = d[m] - d[l] + e[l] / (g + std::copysign(r, g));
+      double s = 1.0, c = 1.0, p = 0.0;
+      int i = m - 1;
+      for (; i >= l; i--) {
+        double f = s * e[i];
+        const double b = c * e[i];
+        r = std::hypot(f, g);
+        e[i + 1] = r;
+        if (r == 0.0) {
+          d[i + 1] -= p;
+          e[m] = 0.0;
+          break;
+        }
+        s = f / r;
+        c = g / r;
+        g = d[i + 1] - p;
+        r = (d[i] - g) * s + 2.0 * c * b;
+        p = s * r;
+        d[i + 1] = g + p;
+        g = c * r - b;
+        if (!q.Empty()) {
+          for (int k = 0; k < q.GetRows(); k++) {
+            f = q.At(k, i + 1);
+            q.At(k, i + 1) = s * q.At(k, i) + c * f;
+            q.At(k, i) = c * q.At(k, i) - s * f;
+          }
+        }
+      }
+      if (r == 0.0 && i >= l) continue;
+      d[l] -= p;
+      e[l] = g;
+      e[m] = 0.0;
+    }
+  }
+}
+
+// Root i of the secular equation 1 + rho * sum_j z_j^2 / (d_j - lambda) = 0
+// for ascending d and rho > 0, which lies in (d_i, d_(i+1)), or in
+// (d_i, d_i + rho * weight] for the last one with weight = |z|^2. It is
+// returned as lambda = d_origin + tau for the nearer end of the interval,
+// so that the differences d_j - lambda = (d_j - d_origin) - tau that the
+// eigenvectors are built from keep full relative accuracy. d is given
+// through delta(j, o) = d_j - d_o, so that squares can be passed without
+// forming them.
+template <typename Delta>
+void SolveSecular(int k, const Delta& delta, const double* z, double rho,
+                  double weight, int i, int* origin, double* tau) {
+  auto secular = [&](int o, double t, double* derivative) {
+    double f = 1.0, df = 0.0;
+    for (int j = 0; j < k; j++) {
+      const double ratio = z[j] / (delta(j, o) - t);
+      f += rho * z[j] * ratio;
+      df += rho * ratio * ratio;
+    }
+    *derivative = df;
+    return f;
+  };
+  int o = i;
+  double lo = 0.0, hi;
+  if (i < k - 1) {
+    const double half = delta(i + 1, i) / 2.0;
+    double unused;
+    if (secular(i, half, &unused) > 0.0) {
+      hi = half;
+    } else {
+      o = i + 1;
+      lo = -half;
+      hi = 0.0;
+    }
+  } else {
+    hi = rho * weight;
+  }
+  double t = (lo + hi) / 2.0;
+  for (int iteration = 0; iteration < kMaxSecularIterations; iteration++) {
+    double df;
+    const double f = secular(o, t, &df);
+    if (f == 0.0) break;
+    if (f > 0.0)
+      hi = t;
+    else
+      lo = t;
+    double next = t - f / df;
+    if (!(next > lo && next < hi)) next = (lo + hi) / 2.0;
+    const bool converged =
+        std::fabs(next - t) <= 2.0 * kEpsilon * std::fabs(next) ||
+        hi - lo <= 2.0 * kEpsilon * std::max(std::fabs(lo), std::fabs(hi));
+    t = next;
+    if (converged) break;
+  }
+  *origin = o;
+  *tau = t;
+}
+
+// Columns p and i of q become c * q_p + s * q_i and c * q_i - s * q_p.
+void RotateColumns(S21MatrixView q, int p, int i, double c, double s) {
+  for (int r = 0; r < q.GetRows(); r++) {
+    const double qp = q.At(r, p), qi = q.At(r, i);
+    q.At(r, p) = c * qp + s * qi;
+    q.At(r, i) = c * qi - s * qp;
+  }
+}
+
+// Eigendecomposition of Q * (D + rho * z * z^T) * Q^T, given the
+// eigenvalues d of the two halves split at row m and their eigenvectors in
+// the block diagonal q, with z made of the last row of the top block and
+// the first row of the bottom one. Replaces d and q by the eigenvalues of
+// the merged matrix, ascending, and its eigenvectors.
+void Merge(int n, int m, double rho, double* d, S21MatrixView q) {
+  std::vector<double> z(n);
+  for (int i = 0; i < m; i++) z[i] = q.At(m - 1, i);
+  for (int i = m; i < n; i++) z[i] = q.At(m, i);
+  double norm = 0.0;
+  for (double value : z) norm += value * value;
+  norm = std::sqrt(norm);
+  for (double& value : z) value /= norm;
+  // For rho < 0 the eigenvalues are those of -D + |rho| * z * z^T negated.
+  const double sign = rho < 0.0 ? -1.0 : 1.0;
+  rho = std::fabs(rho) * norm * norm;
+  std::vector<double> dd(n);
+  for (int i = 0; i < n; i++) dd[i] = sign * d[i];
+  std::vector<int> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&dd](int a, int b) { return dd[a] < dd[b]; });
+  double dmax = 0.0;
+  for (double value : dd) dmax = std::max(dmax, std::fabs(value));
+  const double tolerance = 8.0 * kEpsilon * std::max(dmax, rho);
+
+  // Deflation: components of z below the tolerance leave their pair as it
+  // is, and a rotation of two nearly equal d_j moves the weight of z to
+  // one of them. Blocks records the rows each column of q can be non-zero
+  // in: 1 for the top half, 2 for the bottom one, 3 for both.
+  std::vector<int> blocks(n);
+  for (int i = 0; i < n; i++) blocks[i] = i < m ? 1 : 2;
+  std::vector<int> kept, deflated;
+  int previous = -1;
+  for (int index : order) {
+    if (rho * std::fabs(z[index]) <= tolerance) {
+      deflated.push_back(index);
+      continue;
+    }
+    if (previous >= 0) {
+      const double tau = std::hypot(z[previous], z[index]);
+      const double c = z[previous] / tau, s = z[index] / tau;
+      if (std::fabs((dd[index] - dd[previous]) * c * s) <= tolerance) {
+        RotateColumns(q, previous, index, c, s);
+        const double dp = dd[previous], di = dd[index];
+        dd[previous] = c * c * dp + s * s * di;
+        dd[index] = s * s * dp + c * c * di;
+        z[previous] = tau;
+        z[index] = 0.0;
+        blocks[previous] = blocks[index] = blocks[previous] | blocks[index];
+        deflated.push_back(index);
+        continue;
+      }
+      kept.push_back(previous);
+    }
+    previous = index;
+  }
+  if (previous >= 0) kept.push_back(previous);
+
+  // The rotations may have broken the order of the kept values slightly.
+  std::stable_sort(kept.begin(), kept.end(),
+                   [&dd](int a, int b) { return dd[a] < dd[b]; });
+  const int k = (int)kept.size();
+  std::vector<double> dk(k), zk(k);
+  double weight = 0.0;
+  for (int i = 0; i < k; i++) {
+    dk[i] = dd[kept[i]];
+    zk[i] = z[kept[i]];
+    weight += zk[i] * zk[i];
+  }
+  std::vector<int> origin(k);
+  std::vector<double> tau(k);
+  const auto delta = [&dk](int j, int o) { return dk[j] - dk[o]; };
+  S21ThreadPool::ParallelFor(k, 20L * k, [&](int begin, int end) {
+    for (int i = begin; i < end; i++)
+      SolveSecular(k, delta, zk.data(), rho, weight, i, &origin[i], &tau[i]);
+  });
+  // lambda_i - d_j for root i.
+  auto gap = [&](int i, int j) { return tau[i] - delta(j, origin[i]); };
+  // Recomputing z from the computed roots (Gu and Eisenstat) makes them
+  // the exact eigenvalues of a nearby problem, so that the eigenvectors
+  // below come out orthogonal however close the roots are.
+  std::vector<double> zhat(k);
+  S21ThreadPool::ParallelFor(k, k, [&](int begin, int end) {
+    for (int j = begin; j < end; j++) {
+      double w = gap(j, j) / rho;
+      for (int i = 0; i < k; i++)
+        if (i != j) w *= gap(i, j) / delta(i, j);
+      zhat[j] = std::copysign(std::sqrt(std::max(w, 0.0)), zk[j]);
+    }
+  });
+
+  // Columns of q that only touch the top rows come first, the bottom-only
+  // ones last, so that each half of the product below skips the zeros.
+  std::vector<int> layout;
+  int top = 0, both = 0;
+  for (int pass : {1, 3, 2}) {
+    for (int c = 0; c < k; c++) {
+      if (blocks[kept[c]] != pass) continue;
+      layout.push_back(c);
+      top += pass == 1;
+      both += pass == 3;
+    }
+  }
+  // Row i holds the eigenvector of root i in the basis of the kept
+  // columns, in layout order.
+  S21Matrix vectors(k, k);
+  const S21MatrixView vectors_view = vectors.View();
+  S21ThreadPool::ParallelFor(k, k, [&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      double* row = vectors_view.RowData(i);
+      for (int c = 0; c < k; c++) row[c] = -zhat[layout[c]] / gap(i, layout[c]);
+      s21_kernels::Scale(row, 1.0 / std::sqrt(s21_kernels::SumSquares(row, k)),
+                         k);
+    }
+  });
+  S21Matrix gathered(n, k), merged(n, k);
+  for (int r = 0; r < n; r++)
+    for (int c = 0; c < k; c++) gathered(r, c) = q.At(r, kept[layout[c]]);
+  const int top_cols = top + both, bottom_cols = k - top;
+  if (top_cols > 0)
+    s21_views::Multiply(
+        gathered.View().Submatrix(0, 0, m, top_cols),
+        vectors_view.Submatrix(0, 0, k, top_cols).Transposed(),
+        merged.View().Submatrix(0, 0, m, k));
+  if (bottom_cols > 0)
+    s21_views::Multiply(
+        gathered.View().Submatrix(m, top, n - m, bottom_cols),
+        vectors_view.Submatrix(0, top, k, bottom_cols).Transposed(),
+        merged.View().Submatrix(m, 0, n - m, k));
+
+  // Kept roots and deflated pairs together, ascending.
+  std::vector<double> values(n);
+  std::vector<int> source(n);
+  for (int i = 0; i < k; i++) {
+    values[i] = sign * (dk[origin[i]] + tau[i]);
+    source[i] = i;
+  }
+  for (int i = 0; i < n - k; i++) {
+    values[k + i] = sign * dd[deflated[i]];
+    source[k + i] = k + i;
+  }
+  S21Matrix rest(n, n - k);
+  for (int r = 0; r < n; r++)
+    for (int i = 0; i < n - k; i++) rest(r, i) = q.At(r, deflated[i]);
+  std::stable_sort(source.begin(), source.end(),
+                   [&values](int a, int b) { return values[a] < values[b]; });
+  for (int p = 0; p < n; p++) {
+    const int s = source[p];
+    d[p] = values[s];
+    for (int r = 0; r < n; r++)
+      q.At(r, p) = s < k ? merged(r, s) : rest(r, s - k);
+  }
+}
+
+// Cuppen's divide and conquer on the tridiagonal matrix of TridiagonalQl:
+// subtracting |e[m - 1]| from the two diagonal elements at the split
+// leaves two independent halves and a rank-one correction. Q must be n x n
+// and zero; it receives the eigenvectors.
+void DivideAndConquer(int n, double* d, double* e, S21MatrixView q) {
+  if (n <= kLeafSize) {
+    for (int i = 0; i < n; i++) q.At(i, i) = 1.0;
+    TridiagonalQl(n, d, e, q);
+    SortAscending(n, d, q);
+    return;
+  }
+  const int m = n / 2;
+  const double rho = e[m - 1];
+  d[m - 1] -= rho;
+  d[m] -= rho;
+  S21ThreadPool::ParallelFor(2, (long)m * m * m, [&](int begin, int end) {
+    for (int half = begin; half < end; half++) {
+      if (half == 0)
+        DivideAndConquer(m, d, e, q.Submatrix(0, 0, m, m));
+      else
+        DivideAndConquer(n - m, d + m, e + m, q.Submatrix(m, m, n - m, n - m));
+    }
+  });
+  Merge(n, m, rho, d, q);
+}
+
+// Eigenvalues of the tridiagonal matrix into d, ascending, and its
+// eigenvectors into the columns of q unless q is empty.
+void TridiagonalEigen(int n, double* d, double* e, S21MatrixView q) {
+  if (q.Empty()) {
+    TridiagonalQl(n, d, e, q);
+    std::sort(d, d + n);
+    return;
+  }
+  for (int r = 0; r < n; r++) std::fill(q.RowData(r), q.RowData(r) + n, 0.0);
+  DivideAndConquer(n, d, e, q);
+}
+
+// The columns of q picked by columns[layout[i]] times vectors^T, where
+// rows below top_rows only meet the first top_cols of them and rows from
+// bottom_first on only those in [bottom_begin, bottom_end); the products
+// outside both ranges are zero.
+S21Matrix CombineColumns(S21ConstMatrixView q, const std::vector<int>& columns,
+                         const std::vector<int>& layout, int top_rows,
+                         int top_cols, int bottom_first, int bottom_begin,
+                         int bottom_end, S21ConstMatrixView vectors) {
+  const int rows = q.GetRows(), count = (int)layout.size();
+  const int bottom_rows = rows - bottom_first;
+  const int bottom_cols = bottom_end - bottom_begin;
+  S21Matrix gathered(rows, count), merged(rows, count);
+  for (int row = 0; row < rows; row++)
+    for (int i = 0; i < count; i++)
+      gathered(row, i) = q.At(row, columns[layout[i]]);
+  if (top_rows > 0 && top_cols > 0)
+    s21_views::Multiply(
+        gathered.View().Submatrix(0, 0, top_rows, top_cols),
+        vectors.Submatrix(0, 0, count, top_cols).Transposed(),
+        merged.View().Submatrix(0, 0, top_rows, count));
+  if (bottom_rows > 0 && bottom_cols > 0)
+    s21_views::Multiply(
+        gathered.View().Submatrix(bottom_first, bottom_begin, bottom_rows,
+                                  bottom_cols),
+        vectors.Submatrix(0, bottom_begin, count, bottom_cols).Transposed(),
+        merged.View().Submatrix(bottom_first, 0, bottom_rows, count));
+  return merged;
+}
+
+// Merge step of BidiagonalDivideAndConquer for the r x c matrix B split at
+// row k, whose elements there were alpha on the diagonal and beta right of
+// it. d, u and v hold the decompositions of the two halves, with d[k]
+// free. In those bases B becomes M = diag(d) + e_k * z^T, with d_k = 0
+// and, for c = r + 1, one more column that is z alone. M^T * M = D^2 +
+// z * z^T, so the singular values are the roots of the secular equation
+// with d_j^2 for d_j and rho = 1, and for a root sigma the right vector is
+// z_j / (d_j^2 - sigma^2) and the left one M times it: -1 in row k,
+// d_j * z_j / (d_j^2 - sigma^2) in the others.
+void MergeBidiagonal(int r, int c, int k, double alpha, double beta,
+                     double* d, S21MatrixView u, S21MatrixView v) {
+  std::vector<double> z(c);
+  for (int j = 0; j <= k; j++) z[j] = alpha * v.At(k, j);
+  for (int j = k + 1; j < c; j++) z[j] = beta * v.At(k + 1, j);
+  d[k] = 0.0;
+  u.At(k, k) = 1.0;
+  // Rows each column can be non-zero in, as in Merge: 1 for the top half,
+  // 2 for the bottom one, 3 for both; 0 for column k of u, which is e_k.
+  std::vector<int> u_blocks(r), v_blocks(c);
+  for (int j = 0; j < r; j++) u_blocks[j] = j < k ? 1 : j > k ? 2 : 0;
+  for (int j = 0; j < c; j++) v_blocks[j] = j <= k ? 1 : 2;
+  // The extra column moves into column k and leaves the null vector of B.
+  if (c == r + 1) {
+    const double tau = std::hypot(z[k], z[r]);
+    if (tau > 0.0) {
+      RotateColumns(v, k, r, z[k] / tau, z[r] / tau);
+      z[k] = tau;
+      z[r] = 0.0;
+      v_blocks[k] = 3;
+    }
+  }
+  double dmax = 0.0, norm = 0.0;
+  for (int j = 0; j < r; j++) {
+    dmax = std::max(dmax, d[j]);
+    norm += z[j] * z[j];
+  }
+  const double tolerance = 8.0 * kEpsilon * std::max(dmax, std::sqrt(norm));
+
+  // Deflation as in Merge. A d_j at the noise level is first rotated into
+  // column k, whose d is 0, and a negligible z_k is raised to the
+  // tolerance, so that column k always takes part unless z is zero.
+  for (int j = 0; j < r; j++) {
+    if (j == k || d[j] > tolerance) continue;
+    const double tau = std::hypot(z[k], z[j]);
+    if (tau == 0.0) continue;
+    const double cs = z[k] / tau, sn = z[j] / tau;
+    RotateColumns(v, k, j, cs, sn);
+    // Column j of M is now cs * d_j * e_j.
+    d[j] *= std::fabs(cs);
+    if (cs < 0.0)
+      for (int row = 0; row < c; row++) v.At(row, j) = -v.At(row, j);
+    z[k] = tau;
+    z[j] = 0.0;
+    v_blocks[k] = v_blocks[j] = v_blocks[k] | v_blocks[j];
+  }
+  if (std::fabs(z[k]) <= tolerance) z[k] = std::copysign(tolerance, z[k]);
+  std::vector<int> order(r);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [d](int a, int b) { return d[a] < d[b]; });
+  std::vector<int> kept, deflated;
+  int previous = -1;
+  for (int index : order) {
+    const bool negligible = index == k ? z[index] == 0.0
+                                       : std::fabs(z[index]) <= tolerance;
+    if (negligible) {
+      deflated.push_back(index);
+      continue;
+    }
+    if (previous >= 0) {
+      const double tau = std::hypot(z[previous], z[index]);
+      const double cs = z[previous] / tau, sn = z[index] / tau;
+      // Column k of u is e_k and stays so; its pairs were formed above.
+      if (previous != k &&
+          std::fabs((d[index] - d[previous]) * cs * sn) <= tolerance) {
+        RotateColumns(u, previous, index, cs, sn);
+        RotateColumns(v, previous, index, cs, sn);
+        const double dp = d[previous], di = d[index];
+        d[previous] = cs * cs * dp + sn * sn * di;
+        d[index] = sn * sn * dp + cs * cs * di;
+        z[previous] = tau;
+        z[index] = 0.0;
+        u_blocks[previous] = u_blocks[index] =
+            u_blocks[previous] | u_blocks[index];
+        v_blocks[previous] = v_blocks[index] =
+            v_blocks[previous] | v_blocks[index];
+        deflated.push_back(index);
+        continue;
+      }
+      kept.push_back(previous);
+    }
+    previous = index;
+  }
+  if (previous >= 0) kept.push_back(previous);
+
+  std::stable_sort(kept.begin(), kept.end(),
+                   [d](int a, int b) { return d[a] < d[b]; });
+  const int count = (int)kept.size();
+  std::vector<double> dk(count), zk(count);
+  double weight = 0.0;
+  for (int i = 0; i < count; i++) {
+    dk[i] = d[kept[i]];
+    zk[i] = z[kept[i]];
+    weight += zk[i] * zk[i];
+  }
+  std::vector<int> origin(count);
+  std::vector<double> tau(count);
+  // d_j^2 - d_o^2 without forming the squares.
+  const auto delta = [&dk](int j, int o) {
+    return (dk[j] - dk[o]) * (dk[j] + dk[o]);
+  };
+  S21ThreadPool::ParallelFor(count, 20L * count, [&](int begin, int end) {
+    for (int i = begin; i < end; i++)
+      SolveSecular(count, delta, zk.data(), 1.0, weight, i, &origin[i],
+                   &tau[i]);
+  });
+  // sigma_i^2 - d_j^2 for root i.
+  auto gap = [&](int i, int j) { return tau[i] - delta(j, origin[i]); };
+  std::vector<double> zhat(count);
+  S21ThreadPool::ParallelFor(count, count, [&](int begin, int end) {
+    for (int j = begin; j < end; j++) {
+      double w = gap(j, j);
+      for (int i = 0; i < count; i++)
+        if (i != j) w *= gap(i, j) / delta(i, j);
+      zhat[j] = std::copysign(std::sqrt(std::max(w, 0.0)), zk[j]);
+    }
+  });
+
+  // Kept columns in the order top-only, both halves, bottom-only, then
+  // column k of u, which only touches row k.
+  auto layout_of = [&](const std::vector<int>& blocks, int* top, int* both) {
+    std::vector<int> layout;
+    *top = *both = 0;
+    for (int pass : {1, 3, 2, 0}) {
+      for (int i = 0; i < count; i++) {
+        if (blocks[kept[i]] != pass) continue;
+        layout.push_back(i);
+        *top += pass == 1;
+        *both += pass == 3;
+      }
+    }
+    return layout;
+  };
+  int u_top, u_both, v_top, v_both;
+  const std::vector<int> u_layout = layout_of(u_blocks, &u_top, &u_both);
+  const std::vector<int> v_layout = layout_of(v_blocks, &v_top, &v_both);
+  // Row i holds the singular vectors of root i in the kept columns, in
+  // layout order.
+  S21Matrix u_vectors(count, count), v_vectors(count, count);
+  const S21MatrixView uv = u_vectors.View(), vv = v_vectors.View();
+  S21ThreadPool::ParallelFor(count, count, [&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      double* u_row = uv.RowData(i);
+      double* v_row = vv.RowData(i);
+      for (int j = 0; j < count; j++) {
+        const int lu = u_layout[j], lv = v_layout[j];
+        v_row[j] = -zhat[lv] / gap(i, lv);
+        u_row[j] = kept[lu] == k ? -1.0 : -dk[lu] * zhat[lu] / gap(i, lu);
+      }
+      s21_kernels::Scale(
+          u_row, 1.0 / std::sqrt(s21_kernels::SumSquares(u_row, count)),
+          count);
+      s21_kernels::Scale(
+          v_row, 1.0 / std::sqrt(s21_kernels::SumSquares(v_row, count)),
+          count);
+    }
+  });
+  const S21Matrix u_merged = CombineColumns(
+      u, kept, u_layout, k, u_top + u_both, k + 1, u_top, count - 1, uv);
+  const S21Matrix v_merged = CombineColumns(
+      v, kept, v_layout, k + 1, v_top + v_both, k + 1, v_top, count, vv);
+
+  // Kept roots and deflated columns together, ascending; row k of u comes
+  // from the vector entries of column k alone.
+  std::vector<double> values(r);
+  std::vector<int> source(r);
+  for (int i = 0; i < count; i++) {
+    values[i] = std::sqrt(dk[origin[i]] * dk[origin[i]] + tau[i]);
+    source[i] = i;
+  }
+  for (int i = 0; i < r - count; i++) {
+    values[count + i] = d[deflated[i]];
+    source[count + i] = count + i;
+  }
+  S21Matrix u_rest(r, r - count), v_rest(c, r - count);
+  for (int i = 0; i < r - count; i++) {
+    for (int row = 0; row < r; row++) u_rest(row, i) = u.At(row, deflated[i]);
+    for (int row = 0; row < c; row++) v_rest(row, i) = v.At(row, deflated[i]);
+  }
+  std::stable_sort(source.begin(), source.end(),
+                   [&values](int a, int b) { return values[a] < values[b]; });
+  for (int p = 0; p < r; p++) {
+    const int s = source[p];
+    d[p] = values[s];
+    for (int row = 0; row < r; row++)
+      u.At(row, p) = s >= count ? u_rest(row, s - count)
+                     : row == k ? uv.At(s, count - 1)
+                                : u_merged(row, s);
+    for (int row = 0; row < c; row++)
+      v.At(row, p) = s < count ? v_merged(row, s) : v_rest(row, s - count);
+  }
+}
+
+// Singular value decomposition B = U * S * V^T of the upper bidiagonal
+// r x c matrix with d on its diagonal and f right of it, c being r or
+// r + 1, by the divide and conquer of Jessup and Sorensen: removing row
+// k = r / 2 leaves a k x (k + 1) matrix above it and one shaped like B
+// below, which are decomposed on their own and merged by
+// MergeBidiagonal. The singular values replace d, ascending, and the
+// singular vectors fill the columns of u (r x r) and v (c x c); for
+// c = r + 1 the last column of v spans the null space of B. u and v must
+// be zero.
+void BidiagonalDivideAndConquer(int r, int c, double* d, const double* f,
+                                S21MatrixView u, S21MatrixView v) {
+  if (r == 0) {
+    if (c == 1) v.At(0, 0) = 1.0;
+    return;
+  }
+  const int k = r / 2, rest = r - k - 1;
+  const double alpha = d[k], beta = k + 1 < c ? f[k] : 0.0;
+  S21ThreadPool::ParallelFor(2, (long)k * k * k, [&](int begin, int end) {
+    for (int half = begin; half < end; half++) {
+      if (half == 0)
+        BidiagonalDivideAndConquer(k, k + 1, d, f, u.Submatrix(0, 0, k, k),
+                                   v.Submatrix(0, 0, k + 1, k + 1));
+      else
+        BidiagonalDivideAndConquer(
+            rest, c - k - 1, d + k + 1, f + k + 1,
+            u.Submatrix(k + 1, k + 1, rest, rest),
+            v.Submatrix(k + 1, k + 1, c - k - 1, c - k - 1));
+    }
+  });
+  MergeBidiagonal(r, c, k, alpha, beta, d, u, v);
+}
+
+// Reflectors right of the diagonal, stored in the rows of the reduced
+// matrix: reflector j sits in row j from column j + 1 on.
+S21MatrixView RowReflectors(S21MatrixView a) {
+  return a.Transposed().Submatrix(1, 0, a.GetCols() - 1, a.GetRows());
+}
+
+// Rows [0, count) of top and then of bottom, from column offset on,
+// times scale.
+S21Matrix Stack(S21ConstMatrixView top, S21ConstMatrixView bottom, int count,
+                int offset, double scale) {
+  const int cols = top.GetCols() - offset;
+  S21Matrix stacked(2 * count, cols);
+  const S21MatrixView dst = stacked.View();
+  for (int t = 0; t < count; t++) {
+    std::copy(top.RowData(t) + offset, top.RowData(t) + offset + cols,
+              dst.RowData(t));
+    std::copy(bottom.RowData(t) + offset, bottom.RowData(t) + offset + cols,
+              dst.RowData(count + t));
+  }
+  if (scale != 1.0) stacked.MulNumber(scale);
+  return stacked;
+}
+
+// The trailing matrix of a from (done, done) on += lhs^T * rhs.
+void UpdateTrailing(S21MatrixView a, int done, const S21Matrix& lhs,
+                    const S21Matrix& rhs) {
+  const int trailing = a.GetRows() - done;
+  s21_kernels::Gemm(Op::kTrans, Op::kNoTrans, trailing, trailing,
+                    lhs.GetRows(), lhs.View().Data(),
+                    (int)lhs.View().GetRowStride(), rhs.View().Data(),
+                    (int)rhs.View().GetRowStride(), a.RowData(done) + done,
+                    (int)a.GetRowStride());
+}
+
+// Column col of the first count rows of a.
+void GatherColumn(S21ConstMatrixView a, int count, int col, double* dst) {
+  for (int t = 0; t < count; t++) dst[t] = a.At(t, col);
+}
+
+// Q^T * A * Q = T for a symmetric n x n matrix, with T's diagonal in d,
+// its off-diagonal in e and the reflectors of Q in the rows of the matrix.
+// Each panel builds V and W with (A - V * W^T - W * V^T) the matrix the
+// panel's reflectors leave, touching A itself only through matrix-vector
+// products, and then applies that rank-2nb update as one GEMM. The panel
+// vectors are kept as rows, so that every product with them runs along
+// vectors of the matrix's length.
+void Tridiagonalize(S21Matrix& matrix, std::vector<double>& d,
+                    std::vector<double>& e, std::vector<double>& taus) {
+  const int n = matrix.GetRows();
+  d.assign(n, 0.0);
+  e.assign(n, 0.0);
+  taus.assign(std::max(n - 1, 0), 0.0);
+  if (n == 0) return;
+  const S21MatrixView a = matrix.View();
+  const int lda = (int)a.GetRowStride();
+  const S21MatrixView packed = RowReflectors(a);
+  std::vector<double> p(n), scratch(kPanel);
+  for (int first = 0; first < n - 1; first += kPanel) {
+    const int nb = std::min(kPanel, n - 1 - first), rows = n - first - 1;
+    // Column r of V and W belongs to row first + 1 + r of A.
+    S21Matrix vs(nb, rows), ws(nb, rows);
+    const S21MatrixView vt = vs.View(), wt = ws.View();
+    const int ld = (int)vt.GetRowStride();
+    for (int c = 0; c < nb; c++) {
+      const int j = first + c, len = n - j - 1;
+      double* row = a.RowData(j);
+      if (c > 0) {
+        // Brings row j up to date from the diagonal on.
+        GatherColumn(vt, c, c - 1, scratch.data());
+        s21_kernels::Gemv(Op::kTrans, n - j, c, -1.0, wt.RowData(0) + c - 1,
+                          ld, scratch.data(), 1.0, row + j);
+        GatherColumn(wt, c, c - 1, scratch.data());
+        s21_kernels::Gemv(Op::kTrans, n - j, c, -1.0, vt.RowData(0) + c - 1,
+                          ld, scratch.data(), 1.0, row + j);
+      }
+      d[j] = row[j];
+      taus[j] = s21_views::MakeReflector(packed, j);
+      e[j] = row[j + 1];
+      const double tau = taus[j];
+      if (tau == 0.0) continue;
+      double* v = vt.RowData(c) + c;
+      v[0] = 1.0;
+      std::copy(row + j + 2, row + n, v + 1);
+      // p = tau * (A - V * W^T - W * V^T) * v below row j.
+      s21_kernels::Gemv(Op::kNoTrans, len, len, 1.0, a.RowData(j + 1) + j + 1,
+                        lda, v, 0.0, p.data());
+      if (c > 0) {
+        s21_kernels::Gemv(Op::kNoTrans, c, len, 1.0, wt.RowData(0) + c, ld, v,
+                          0.0, scratch.data());
+        s21_kernels::Gemv(Op::kTrans, len, c, -1.0, vt.RowData(0) + c, ld,
+                          scratch.data(), 1.0, p.data());
+        s21_kernels::Gemv(Op::kNoTrans, c, len, 1.0, vt.RowData(0) + c, ld, v,
+                          0.0, scratch.data());
+        s21_kernels::Gemv(Op::kTrans, len, c, -1.0, wt.RowData(0) + c, ld,
+                          scratch.data(), 1.0, p.data());
+      }
+      s21_kernels::Scale(p.data(), tau, len);
+      // w = p - tau / 2 * (p^T * v) * v.
+      double* w = wt.RowData(c) + c;
+      std::copy(p.begin(), p.begin() + len, w);
+      s21_kernels::Axpy(w, -0.5 * tau * s21_kernels::Dot(p.data(), v, len), v,
+                        len);
+    }
+    if (first + nb == n) continue;
+    // A -= [V W] * [W V]^T on the trailing matrix.
+    UpdateTrailing(a, first + nb, Stack(vt, wt, nb, nb - 1, -1.0),
+                   Stack(wt, vt, nb, nb - 1, 1.0));
+  }
+  d[n - 1] = a.At(n - 1, n - 1);
+}
+
+// Q^T * A * P = B for a square matrix, with B upper bidiagonal: d on its
+// diagonal, f above it. The reflectors of Q are kept in the columns of the
+// matrix below the diagonal, those of P in its rows right of the
+// superdiagonal. Like Tridiagonalize, each panel defers its effect on the
+// trailing matrix to A - V * Y^T - X * U^T, applied as one GEMM.
+void Bidiagonalize(S21Matrix& matrix, std::vector<double>& d,
+                   std::vector<double>& f, std::vector<double>& tauq,
+                   std::vector<double>& taup) {
+  const int n = matrix.GetRows();
+  d.assign(n, 0.0);
+  f.assign(n, 0.0);
+  tauq.assign(n, 0.0);
+  taup.assign(std::max(n - 1, 0), 0.0);
+  if (n == 0) return;
+  const S21MatrixView a = matrix.View();
+  const int lda = (int)a.GetRowStride();
+  const S21MatrixView right = RowReflectors(a);
+  std::vector<double> column(n), scratch(kPanel);
+  for (int first = 0; first < n; first += kPanel) {
+    const int nb = std::min(kPanel, n - first), rows = n - first;
+    // Column r of the panel vectors belongs to row or column first + r.
+    S21Matrix vs(nb, rows), ys(nb, rows), xs(nb, rows), us(nb, rows);
+    const S21MatrixView vt = vs.View(), yt = ys.View(), xt = xs.View(),
+                        ut = us.View();
+    const int ld = (int)vt.GetRowStride();
+    for (int c = 0; c < nb; c++) {
+      const int j = first + c, len = n - j, rest = len - 1;
+      if (c > 0) {
+        // Brings column j up to date from the diagonal down.
+        GatherColumn(yt, c, c, scratch.data());
+        s21_kernels::Gemv(Op::kTrans, len, c, 1.0, vt.RowData(0) + c, ld,
+                          scratch.data(), 0.0, column.data());
+        GatherColumn(ut, c, c, scratch.data());
+        s21_kernels::Gemv(Op::kTrans, len, c, 1.0, xt.RowData(0) + c, ld,
+                          scratch.data(), 1.0, column.data());
+        for (int r = 0; r < len; r++) a.At(j + r, j) -= column[r];
+      }
+      tauq[j] = s21_views::MakeReflector(a, j);
+      d[j] = a.At(j, j);
+      double* v = vt.RowData(c) + c;
+      v[0] = 1.0;
+      for (int r = 1; r < len; r++) v[r] = a.At(j + r, j);
+      if (rest == 0) break;
+
+      // y = tauq * (A^T * v - Y * (V^T * v) - U * (X^T * v)) right of
+      // column j.
+      double* y = yt.RowData(c) + c + 1;
+      s21_kernels::Gemv(Op::kTrans, rest, len, 1.0, a.RowData(j) + j + 1, lda,
+                        v, 0.0, y);
+      if (c > 0) {
+        s21_kernels::Gemv(Op::kNoTrans, c, len, 1.0, vt.RowData(0) + c, ld, v,
+                          0.0, scratch.data());
+        s21_kernels::Gemv(Op::kTrans, rest, c, -1.0, yt.RowData(0) + c + 1, ld,
+                          scratch.data(), 1.0, y);
+        s21_kernels::Gemv(Op::kNoTrans, c, len, 1.0, xt.RowData(0) + c, ld, v,
+                          0.0, scratch.data());
+        s21_kernels::Gemv(Op::kTrans, rest, c, -1.0, ut.RowData(0) + c + 1, ld,
+                          scratch.data(), 1.0, y);
+      }
+      s21_kernels::Scale(y, tauq[j], rest);
+
+      // Brings row j up to date right of the diagonal.
+      double* row = a.RowData(j) + j + 1;
+      GatherColumn(vt, c + 1, c, scratch.data());
+      s21_kernels::Gemv(Op::kTrans, rest, c + 1, -1.0, yt.RowData(0) + c + 1,
+                        ld, scratch.data(), 1.0, row);
+      if (c > 0) {
+        GatherColumn(xt, c, c, scratch.data());
+        s21_kernels::Gemv(Op::kTrans, rest, c, -1.0, ut.RowData(0) + c + 1, ld,
+                          scratch.data(), 1.0, row);
+      }
+      taup[j] = s21_views::MakeReflector(right, j);
+      f[j] = row[0];
+      double* u = ut.RowData(c) + c + 1;
+      u[0] = 1.0;
+      std::copy(row + 1, row + rest, u + 1);
+
+      // x = taup * (A * u - V * (Y^T * u) - X * (U^T * u)) below row j.
+      double* x = xt.RowData(c) + c + 1;
+      s21_kernels::Gemv(Op::kNoTrans, rest, rest, 1.0,
+                        a.RowData(j + 1) + j + 1, lda, u, 0.0, x);
+      s21_kernels::Gemv(Op::kNoTrans, c + 1, rest, 1.0, yt.RowData(0) + c + 1,
+                        ld, u, 0.0, scratch.data());
+      s21_kernels::Gemv(Op::kTrans, rest, c + 1, -1.0, vt.RowData(0) + c + 1,
+                        ld, scratch.data(), 1.0, x);
+      if (c > 0) {
+        s21_kernels::Gemv(Op::kNoTrans, c, rest, 1.0, ut.RowData(0) + c + 1,
+                          ld, u, 0.0, scratch.data());
+        s21_kernels::Gemv(Op::kTrans, rest, c, -1.0, xt.RowData(0) + c + 1, ld,
+                          scratch.data(), 1.0, x);
+      }
+      s21_kernels::Scale(x, taup[j], rest);
+    }
+    if (first + nb == n) continue;
+    // A -= [V X] * [Y U]^T on the trailing matrix.
+    UpdateTrailing(a, first + nb, Stack(vt, xt, nb, nb, -1.0),
+                   Stack(yt, ut, nb, nb, 1.0));
+  }
+}
+
+S21Matrix OrthonormalBasis(const S21Matrix& columns) {
+  return S21QR(columns).Q();
+}
+
+}  // namespace
+
+S21SymmetricEigen::S21SymmetricEigen(const S21Matrix& matrix, bool vectors)
+    : vectors_(matrix.GetResource()) {
+  Compute(matrix, vectors);
+}
+
+void S21SymmetricEigen::Compute(const S21Matrix& matrix, bool vectors) {
+  if (matrix.GetRows() != matrix.GetCols())
+    throw std::invalid_argument("The matrix is not square");
+  const int n = matrix.GetRows();
+  S21Matrix a(matrix);
+  for (int i = 0; i < n; i++)
+    for (int j = i + 1; j < n; j++) a(i, j) = a(j, i);
+  const double scale = ScaleFor(MaxAbs(a));
+  if (scale != 1.0) a.MulNumber(scale);
+  std::vector<double> e, taus;
+  Tridiagonalize(a, values_, e, taus);
+  const int size = vectors ? n : 0;
+  S21Matrix z(size, size, matrix.GetResource());
+  TridiagonalEigen(n, values_.data(), e.data(), z.View());
+  for (double& value : values_) value /= scale;
+  if (vectors && n > 1)
+    s21_views::ApplyReflectors(RowReflectors(a.View()), taus.data(), n - 1,
+                               false, z.View().Submatrix(1, 0, n - 1, n));
+  vectors_ = std::move(z);
+}
+
+S21SVD::S21SVD(const S21Matrix& matrix, bool vectors)
+    : u_(matrix.GetResource()), v_(matrix.GetResource()) {
+  Compute(matrix, vectors);
+}
+
+void S21SVD::Compute(const S21Matrix& matrix, bool vectors) {
+  rows_ = matrix.GetRows();
+  cols_ = matrix.GetCols();
+  const bool wide = rows_ < cols_;
+  S21Matrix a = wide ? matrix.Transpose() : matrix;
+  const int m = a.GetRows(), n = a.GetCols();
+  const double scale = ScaleFor(MaxAbs(a));
+  if (scale != 1.0) a.MulNumber(scale);
+  S21Matrix q(matrix.GetResource());
+  if (m > n) {
+    const S21QR qr(a);
+    if (vectors) q = qr.Q();
+    a = qr.R();
+  }
+  std::vector<double> d, f, tauq, taup;
+  Bidiagonalize(a, d, f, tauq, taup);
+  values_.resize(n);
+  if (!vectors) {
+    // The Golub-Kahan matrix, with a zero diagonal and d_0, f_0, d_1, ...
+    // off it, has the singular values of B and their negatives for
+    // eigenvalues.
+    const int size = 2 * n;
+    std::vector<double> diagonal(size, 0.0), coupling(size, 0.0);
+    for (int i = 0; i < n; i++) {
+      coupling[2 * i] = d[i];
+      if (i < n - 1) coupling[2 * i + 1] = f[i];
+    }
+    TridiagonalEigen(size, diagonal.data(), coupling.data(), S21MatrixView());
+    for (int i = 0; i < n; i++)
+      values_[i] = std::max(diagonal[size - 1 - i], 0.0) / scale;
+    u_ = S21Matrix(matrix.GetResource());
+    v_ = S21Matrix(matrix.GetResource());
+    return;
+  }
+  S21Matrix ascending_u(n, n), ascending_v(n, n);
+  BidiagonalDivideAndConquer(n, n, d.data(), f.data(), ascending_u.View(),
+                             ascending_v.View());
+  S21Matrix ub(n, n), vb(n, n);
+  for (int i = 0; i < n; i++) values_[i] = d[n - 1 - i] / scale;
+  for (int r = 0; r < n; r++) {
+    for (int i = 0; i < n; i++) {
+      ub(r, i) = ascending_u(r, n - 1 - i);
+      vb(r, i) = ascending_v(r, n - 1 - i);
+    }
+  }
+  s21_views::ApplyReflectors(a.View(), tauq.data(), n, false, ub.View());
+  if (n > 1)
+    s21_views::ApplyReflectors(RowReflectors(a.View()), taup.data(), n - 1,
+                               false, vb.View().Submatrix(1, 0, n - 1, n));
+  if (m > n) {
+    S21Matrix full(m, n, matrix.GetResource());
+    s21_views::Multiply(q, ub, full);
+    ub = std::move(full);
+  }
+  u_ = wide ? std::move(vb) : std::move(ub);
+  v_ = wide ? std::move(ub) : std::move(vb);
+}
+
+S21SVD S21SVD::Randomized(const S21Matrix& matrix, int rank, int oversampling,
+                          int power_iterations) {
+  const int m = matrix.GetRows(), n = matrix.GetCols();
+  if (rank < 0 || rank > std::min(m, n))
+    throw std::invalid_argument(
+        "Rank should not exceed the smaller dimension of the matrix");
+  if (oversampling < 0 || power_iterations < 0)
+    throw std::invalid_argument(
+        "Oversampling and power iterations should not be negative");
+  std::pmr::memory_resource* resource = matrix.GetResource();
+  const int samples = std::min(rank + oversampling, std::min(m, n));
+  S21Matrix omega(n, samples, resource);
+  std::mt19937_64 generator(kRandomSeed);
+  std::normal_distribution<double> normal;
+  for (int i = 0; i < n; i++)
+    for (int j = 0; j < samples; j++) omega(i, j) = normal(generator);
+  S21Matrix range(m, samples, resource), co_range(n, samples, resource);
+  s21_views::Multiply(matrix, omega, range);
+  S21Matrix basis = OrthonormalBasis(range);
+  for (int i = 0; i < power_iterations; i++) {
+    s21_views::Multiply(matrix.View().Transposed(), basis, co_range);
+    s21_views::Multiply(matrix, OrthonormalBasis(co_range), range);
+    basis = OrthonormalBasis(range);
+  }
+  S21Matrix projected(samples, n, resource);
+  s21_views::Multiply(basis.View().Transposed(), matrix, projected);
+  const S21SVD small(projected);
+
+  S21SVD result;
+  result.rows_ = m;
+  result.cols_ = n;
+  result.values_.assign(small.values_.begin(), small.values_.begin() + rank);
+  result.u_ = S21Matrix(m, rank, resource);
+  s21_views::Multiply(basis, small.u_.View().Submatrix(0, 0, samples, rank),
+                      result.u_);
+  result.v_ = S21Matrix(small.v_.View().Submatrix(0, 0, n, rank), resource);
+  return result;
+}
+
+int S21SVD::Rank(double tolerance) const {
+  if (values_.empty()) return 0;
+  if (tolerance < 0.0)
+    tolerance = std::max(rows_, cols_) * kEpsilon * values_.front();
+  return (int)std::count_if(
+      values_.begin(), values_.end(),
+      [tolerance](double value) { return value > tolerance; });
+}
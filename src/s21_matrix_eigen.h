@@ -0,0 +1,75 @@
+#ifndef SRC_S21_MATRIX_EIGEN_
+#define SRC_S21_MATRIX_EIGEN_
+
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+// Eigendecomposition A = V * diag(values) * V^T of a symmetric matrix; only
+// the lower triangle of A is read. A is reduced to tridiagonal form by
+// Householder reflectors in panels, so that half of the work is one GEMM
+// update of the trailing matrix per panel, and the tridiagonal problem is
+// solved by divide and conquer: the two halves are solved independently on
+// the thread pool and merged through a rank-one secular equation, with the
+// eigenvectors of each merge formed by GEMM. Without vectors the
+// tridiagonal eigenvalues come from QL iteration in O(n^2).
+class S21SymmetricEigen {
+ public:
+  explicit S21SymmetricEigen(const S21Matrix& matrix, bool vectors = true);
+  // Decomposes another matrix in the storage of this one.
+  void Compute(const S21Matrix& matrix, bool vectors = true);
+
+  int GetSize() const { return (int)values_.size(); }
+  // Ascending.
+  const std::vector<double>& Values() const { return values_; }
+  // Orthonormal eigenvectors in the columns, in the order of Values();
+  // empty when only the values were computed.
+  const S21Matrix& Vectors() const { return vectors_; }
+
+ private:
+  std::vector<double> values_;
+  S21Matrix vectors_;
+};
+
+// Singular value decomposition A = U * diag(values) * V^T of a rows x cols
+// matrix, keeping k = min(rows, cols) columns in U and V. A tall matrix is
+// first reduced to the R factor of S21QR and a wide one is transposed; the
+// square matrix is reduced to bidiagonal form in GEMM-updated panels. The
+// bidiagonal SVD comes from a divide and conquer of its own, which splits
+// off a row and merges the singular vectors of the halves by GEMM; without
+// vectors the singular values are the eigenvalues of the Golub-Kahan
+// tridiagonal matrix, found by QL iteration in O(n^2).
+class S21SVD {
+ public:
+  explicit S21SVD(const S21Matrix& matrix, bool vectors = true);
+  void Compute(const S21Matrix& matrix, bool vectors = true);
+  // The rank largest singular triplets by randomized range finding: A is
+  // multiplied by rank + oversampling Gaussian vectors, power_iterations
+  // rounds of multiplying by A^T and A sharpen the range for slowly
+  // decaying spectra, and the projection of A onto that range gets a full
+  // SVD. The heavy work is GEMM with A, O(rows * cols * rank) in all. The
+  // random vectors come from a fixed seed, so results are reproducible.
+  static S21SVD Randomized(const S21Matrix& matrix, int rank,
+                           int oversampling = 10, int power_iterations = 2);
+
+  int GetRows() const { return rows_; }
+  int GetCols() const { return cols_; }
+  // Descending.
+  const std::vector<double>& Values() const { return values_; }
+  // Orthonormal singular vectors in the columns, rows x k and cols x k;
+  // empty when only the values were computed.
+  const S21Matrix& U() const { return u_; }
+  const S21Matrix& V() const { return v_; }
+  // Singular values above tolerance; a negative tolerance selects
+  // max(rows, cols) * epsilon * the largest singular value.
+  int Rank(double tolerance = -1.0) const;
+
+ private:
+  S21SVD() = default;
+
+  int rows_ = 0, cols_ = 0;
+  std::vector<double> values_;
+  S21Matrix u_, v_;
+};
+
+#endif  // SRC_S21_MATRIX_EIGEN_
@@ -0,0 +1,235 @@
+#include "s21_matrix_file.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "s21_matrix_gemm.h"
+#include "s21_matrix_io.h"
+
+namespace {
+
+void ReadFully(int fd, void* dst, std::size_t bytes, long offset) {
+  auto* out = static_cast<char*>(dst);
+  while (bytes > 0) {
+    const ssize_t done = ::pread(fd, out, bytes, offset);
+    if (done <= 0) throw std::runtime_error("Cannot read matrix file");
+    out += done, bytes -= done, offset += done;
+  }
+}
+
+void WriteFully(int fd, const void* src, std::size_t bytes, long offset) {
+  const auto* in = static_cast<const char*>(src);
+  while (bytes > 0) {
+    const ssize_t done = ::pwrite(fd, in, bytes, offset);
+    if (done <= 0) throw std::runtime_error("Cannot write matrix file");
+    in += done, bytes -= done, offset += done;
+  }
+}
+
+}  // namespace
+
+S21MatrixFile::S21MatrixFile(int fd, const std::string& path, int rows,
+                             int cols)
+    : fd_(fd),
+      path_(path),
+      rows_(rows),
+      cols_(cols),
+      stride_(s21_io::StrideFor(cols)),
+      dirty_(false) {}
+
+S21MatrixFile::S21MatrixFile(const std::string& path, bool writable)
+    : S21MatrixFile(::open(path.c_str(), writable ? O_RDWR : O_RDONLY), path,
+                    0, 0) {
+  if (fd_ < 0) throw std::runtime_error("Cannot open file " + path);
+  struct stat status;
+  s21_io::FileHeader header;
+  try {
+    if (::fstat(fd_, &status) != 0 ||
+        ::pread(fd_, &header, sizeof(header), 0) != (ssize_t)sizeof(header))
+      throw std::invalid_argument("Not an S21Matrix file");
+    s21_io::CheckHeader(header, status.st_size);
+  } catch (...) {
+    Close();
+    throw;
+  }
+  rows_ = (int)header.rows;
+  cols_ = (int)header.cols;
+  stride_ = (int)header.stride;
+}
+
+S21MatrixFile S21MatrixFile::Create(const std::string& path, int rows,
+                                    int cols) {
+  if (rows < 0 || cols < 0)
+    throw std::invalid_argument("Number of rows or columns should be positive");
+  const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) throw std::runtime_error("Cannot create file " + path);
+  S21MatrixFile file(fd, path, rows, cols);
+  const s21_io::FileHeader header = s21_io::MakeHeader(rows, cols);
+  WriteFully(fd, &header, sizeof(header), 0);
+  if (::ftruncate(fd, file.Offset(rows, 0)) != 0)
+    throw std::runtime_error("Cannot create file " + path);
+  file.dirty_ = true;
+  return file;
+}
+
+S21MatrixFile::S21MatrixFile(S21MatrixFile&& other)
+    : fd_(std::exchange(other.fd_, -1)),
+      path_(std::move(other.path_)),
+      rows_(other.rows_),
+      cols_(other.cols_),
+      stride_(other.stride_),
+      dirty_(other.dirty_) {}
+
+S21MatrixFile& S21MatrixFile::operator=(S21MatrixFile&& other) {
+  if (this != &other) {
+    Close();
+    fd_ = std::exchange(other.fd_, -1);
+    path_ = std::move(other.path_);
+    rows_ = other.rows_, cols_ = other.cols_, stride_ = other.stride_;
+    dirty_ = other.dirty_;
+  }
+  return *this;
+}
+
+S21MatrixFile::~S21MatrixFile() { Close(); }
+
+void S21MatrixFile::Close() {
+  if (fd_ >= 0) ::close(fd_);
+  fd_ = -1;
+}
+
+long S21MatrixFile::Offset(int row, int col) const {
+  return (long)sizeof(s21_io::FileHeader) +
+         ((long)row * stride_ + col) * (long)sizeof(double);
+}
+
+void S21MatrixFile::CheckBlock(int row, int col, int rows, int cols) const {
+  if (row < 0 || col < 0 || row + rows > rows_ || col + cols > cols_)
+    throw std::out_of_range("Incorrect input, index is out of range");
+}
+
+void S21MatrixFile::ReadBlock(int row, int col, S21MatrixView dst) const {
+  const int rows = dst.GetRows(), cols = dst.GetCols();
+  CheckBlock(row, col, rows, cols);
+  if (dst.Empty()) return;
+  // Whole padded rows into a view with the same stride: one read.
+  if (col == 0 && cols == cols_ && dst.GetColStride() == 1 &&
+      dst.GetRowStride() == stride_) {
+    ReadFully(fd_, dst.Data(),
+              ((std::size_t)(rows - 1) * stride_ + cols) * sizeof(double),
+              Offset(row, 0));
+    return;
+  }
+  std::vector<double> buffer(dst.GetColStride() == 1 ? 0 : cols);
+  for (int i = 0; i < rows; i++) {
+    double* out = buffer.empty() ? dst.RowData(i) : buffer.data();
+    ReadFully(fd_, out, cols * sizeof(double), Offset(row + i, col));
+    for (int j = 0; j < (int)buffer.size(); j++) dst.At(i, j) = buffer[j];
+  }
+}
+
+void S21MatrixFile::WriteBlock(int row, int col, S21ConstMatrixView src) {
+  const int rows = src.GetRows(), cols = src.GetCols();
+  CheckBlock(row, col, rows, cols);
+  std::vector<double> buffer(src.GetColStride() == 1 ? 0 : cols);
+  for (int i = 0; i < rows && cols > 0; i++) {
+    const double* in = src.RowData(i);
+    if (!buffer.empty()) {
+      for (int j = 0; j < cols; j++) buffer[j] = src.At(i, j);
+      in = buffer.data();
+    }
+    WriteFully(fd_, in, cols * sizeof(double), Offset(row + i, col));
+  }
+  dirty_ = true;
+}
+
+void S21MatrixFile::Sync() {
+  if (!dirty_) return;
+  const std::size_t data_size = Offset(rows_, 0) - Offset(0, 0);
+  std::vector<char> chunk(std::min(data_size, s21_io::kChunkBytes));
+  std::vector<std::uint64_t> hashes;
+  for (std::size_t offset = 0; offset < data_size; offset += chunk.size()) {
+    const std::size_t bytes = std::min(chunk.size(), data_size - offset);
+    ReadFully(fd_, chunk.data(), bytes, Offset(0, 0) + offset);
+    hashes.push_back(s21_io::HashChunk(chunk.data(), bytes));
+  }
+  s21_io::FileHeader header = s21_io::MakeHeader(rows_, cols_);
+  header.checksum =
+      s21_io::CombineChunks(hashes.data(), hashes.size(), data_size);
+  WriteFully(fd_, &header, sizeof(header), 0);
+  dirty_ = false;
+}
+
+S21MatrixFile S21MatrixFile::MulMatrix(const S21MatrixFile& other,
+                                       const std::string& result_path,
+                                       std::size_t memory_budget) const {
+  if (cols_ != other.rows_)
+    throw std::out_of_range(
+        "Invalid matrix sizes: number of cols of the first matrix must be "
+        "equal to the number of rows of the second matrix");
+  // Square blocks: one of the result and two of each operand, one pair
+  // being read while the other is multiplied.
+  const int step = s21_io::kStrideStep;
+  const int block =
+      (int)std::sqrt(memory_budget / (5.0 * sizeof(double))) / step * step;
+  if (block < step)
+    throw std::invalid_argument("Memory budget is too small for a block");
+  const int m = rows_, n = other.cols_, k = cols_;
+  S21MatrixFile result = Create(result_path, m, n);
+  const int bm = std::min(block, m), bn = std::min(block, n);
+  const int bk = std::min(block, k);
+  struct Step {
+    int row, col, depth;
+  };
+  std::vector<Step> steps;
+  for (int row = 0; row < m; row += bm)
+    for (int col = 0; col < n; col += bn)
+      for (int depth = 0; depth < k; depth += bk)
+        steps.push_back({row, col, depth});
+  S21Matrix c(bm, bn), a[2] = {S21Matrix(bm, bk), S21Matrix(bm, bk)},
+                       b[2] = {S21Matrix(bk, bn), S21Matrix(bk, bn)};
+  auto extent = [](int start, int size, int total) {
+    return std::min(size, total - start);
+  };
+  auto load = [&](std::size_t index) {
+    const Step& s = steps[index];
+    const int rows = extent(s.row, bm, m), cols = extent(s.col, bn, n);
+    const int depth = extent(s.depth, bk, k);
+    ReadBlock(s.row, s.depth, a[index % 2].View().Submatrix(0, 0, rows, depth));
+    other.ReadBlock(s.depth, s.col,
+                    b[index % 2].View().Submatrix(0, 0, depth, cols));
+  };
+  // Declared after the blocks, so an exception waits for the read in
+  // flight before they are freed.
+  std::future<void> pending;
+  if (!steps.empty()) pending = std::async(std::launch::async, load, 0);
+  for (std::size_t index = 0; index < steps.size(); index++) {
+    pending.get();
+    if (index + 1 < steps.size())
+      pending = std::async(std::launch::async, load, index + 1);
+    const Step& s = steps[index];
+    const int rows = extent(s.row, bm, m), cols = extent(s.col, bn, n);
+    const int depth = extent(s.depth, bk, k);
+    const S21MatrixView dst = c.View();
+    if (s.depth == 0)
+      for (int i = 0; i < rows; i++)
+        std::fill(dst.RowData(i), dst.RowData(i) + cols, 0.0);
+    const S21ConstMatrixView lhs = a[index % 2].View(),
+                             rhs = b[index % 2].View();
+    s21_kernels::Gemm(rows, cols, depth, lhs.Data(), (int)lhs.GetRowStride(),
+                      rhs.Data(), (int)rhs.GetRowStride(), dst.Data(),
+                      (int)dst.GetRowStride());
+    if (s.depth + depth == k)
+      result.WriteBlock(s.row, s.col, dst.Submatrix(0, 0, rows, cols));
+  }
+  result.Sync();
+  return result;
+}
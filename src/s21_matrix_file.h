@@ -0,0 +1,56 @@
+#ifndef SRC_S21_MATRIX_FILE_
+#define SRC_S21_MATRIX_FILE_
+
+#include <cstddef>
+#include <string>
+
+#include "s21_matrix_oop.h"
+
+// A matrix file (see s21_matrix_io.h) accessed block by block with
+// positioned reads and writes, so that only the blocks in use have to be
+// in memory. Blocks can be read from several threads at once.
+class S21MatrixFile {
+ public:
+  // Opens a file written by S21Matrix::Save or Create.
+  explicit S21MatrixFile(const std::string& path, bool writable = false);
+  // Creates, or truncates, path as a writable all-zero rows x cols matrix.
+  static S21MatrixFile Create(const std::string& path, int rows, int cols);
+  S21MatrixFile(S21MatrixFile&& other);
+  S21MatrixFile& operator=(S21MatrixFile&& other);
+  S21MatrixFile(const S21MatrixFile&) = delete;
+  S21MatrixFile& operator=(const S21MatrixFile&) = delete;
+  ~S21MatrixFile();
+
+  int GetRows() const { return rows_; }
+  int GetCols() const { return cols_; }
+  const std::string& GetPath() const { return path_; }
+
+  // Copy the block whose top-left element is (row, col) and whose shape is
+  // that of the view.
+  void ReadBlock(int row, int col, S21MatrixView dst) const;
+  void WriteBlock(int row, int col, S21ConstMatrixView src);
+  // Rewrites the checksum in the header after WriteBlock or Create; Load
+  // rejects the file until then. Reads the file back in 1 MiB chunks.
+  void Sync();
+
+  // Writes this * other to result_path and returns it opened. Blocks of
+  // the operands are read from disk on a separate thread while the
+  // previous pair is multiplied, and each finished block of the result is
+  // written back; the blocks never take more than memory_budget bytes.
+  S21MatrixFile MulMatrix(const S21MatrixFile& other,
+                          const std::string& result_path,
+                          std::size_t memory_budget) const;
+
+ private:
+  S21MatrixFile(int fd, const std::string& path, int rows, int cols);
+  void CheckBlock(int row, int col, int rows, int cols) const;
+  long Offset(int row, int col) const;
+  void Close();
+
+  int fd_;
+  std::string path_;
+  int rows_, cols_, stride_;
+  bool dirty_;
+};
+
+#endif  // SRC_S21_MATRIX_FILE_
@@ -0,0 +1,469 @@
+#include "s21_matrix_gemm.h"
+
+#include <algorithm>
+#include <complex>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include "s21_matrix_simd.h"
+#include "s21_thread_pool.h"
+
+namespace s21_kernels {
+
+namespace {
+
+// Cache blocking factors: an MR x KC sliver of A and a KC x NR sliver of
+// B stay in L1, an MC x KC block of A stays in L2, a KC x NC panel of B in
+// L3. The register tile MR x NR, KC and MC depend on the micro-kernel.
+constexpr int kNc = 2048;
+// Column width of the tiles that are distributed between threads; a
+// multiple of every NR.
+constexpr int kNcSplit = 256;
+
+// Elements of y per task of the transposed GEMV; 4 KiB stays in L1 while
+// every row of A is added to it.
+constexpr int kGemvBlock = 512;
+
+// Below this many multiply-adds packing costs more than it saves.
+constexpr long kSmallProduct = 32L * 32 * 32;
+
+constexpr std::size_t kAlignment = 64;
+
+struct AlignedDelete {
+  void operator()(double* ptr) const {
+    ::operator delete[](ptr, std::align_val_t(kAlignment));
+  }
+};
+
+using PackBuffer = std::unique_ptr<double[], AlignedDelete>;
+
+PackBuffer AllocatePack(std::size_t size) {
+  return PackBuffer(static_cast<double*>(
+      ::operator new[](size * sizeof(double), std::align_val_t(kAlignment))));
+}
+
+// Grow-only pack buffer kept by a thread between products, so that
+// products of fixed shapes stop allocating after the first one. The
+// largest is a KC x NC panel of B, 4 MiB.
+struct PackSlot {
+  PackBuffer buffer;
+  std::size_t size = 0;
+  bool busy = false;
+};
+
+thread_local PackSlot pack_a_slot, pack_b_slot;
+
+// The buffer of a slot for the lifetime of the lease. A thread that
+// waits in ParallelFor may steal a task that starts another product; if
+// that finds the slot still leased, it gets a buffer of its own.
+class PackLease {
+ public:
+  PackLease(PackSlot& slot, std::size_t size) {
+    if (slot.busy) {
+      owned_ = AllocatePack(size);
+      data_ = owned_.get();
+      return;
+    }
+    if (slot.size < size) {
+      slot.buffer = AllocatePack(size);
+      slot.size = size;
+    }
+    slot.busy = true;
+    slot_ = &slot;
+    data_ = slot.buffer.get();
+  }
+  PackLease(const PackLease&) = delete;
+  PackLease& operator=(const PackLease&) = delete;
+  ~PackLease() {
+    if (slot_) slot_->busy = false;
+  }
+
+  double* get() const { return data_; }
+
+ private:
+  PackSlot* slot_ = nullptr;
+  PackBuffer owned_;
+  double* data_;
+};
+
+// Address of element (row, col) of op(X).
+template <typename T>
+const T* At(const T* x, int ldx, Op op, int row, int col) {
+  return op == Op::kNoTrans ? x + row * (long)ldx + col
+                            : x + col * (long)ldx + row;
+}
+
+// How packing reads an operand element as a double: widened as it is, or
+// one part of a complex number, so that float and complex products run
+// on the double kernels.
+struct Widen {
+  template <typename T>
+  double operator()(T value) const {
+    return value;
+  }
+};
+
+struct RealPart {
+  template <typename T>
+  double operator()(const std::complex<T>& value) const {
+    return value.real();
+  }
+};
+
+struct ImagPart {
+  template <typename T>
+  double operator()(const std::complex<T>& value) const {
+    return value.imag();
+  }
+};
+
+struct NegatedImagPart {
+  template <typename T>
+  double operator()(const std::complex<T>& value) const {
+    return -(double)value.imag();
+  }
+};
+
+int RoundUp(int value, int step) { return (value + step - 1) / step * step; }
+
+// Packs an mc x kc block of op(A) into mr-row slivers, each stored column
+// by column; rows past mc are zero-filled.
+template <typename T, typename Load>
+void PackA(Op op, int mc, int kc, const T* a, int lda, Load load, int mr,
+           double* packed) {
+  for (int i = 0; i < mc; i += mr) {
+    const int rows = std::min(mr, mc - i);
+    for (int p = 0; p < kc; p++) {
+      if (op == Op::kNoTrans) {
+        for (int r = 0; r < rows; r++)
+          packed[r] = load(a[(i + r) * (long)lda + p]);
+      } else {
+        const T* src = a + p * (long)lda + i;
+        for (int r = 0; r < rows; r++) packed[r] = load(src[r]);
+      }
+      for (int r = rows; r < mr; r++) packed[r] = 0.0;
+      packed += mr;
+    }
+  }
+}
+
+// Packs a kc x nc block of op(B) into nr-column slivers, each stored row
+// by row; columns past nc are zero-filled.
+template <typename T, typename Load>
+void PackB(Op op, int kc, int nc, const T* b, int ldb, Load load, int nr,
+           double* packed) {
+  for (int j = 0; j < nc; j += nr) {
+    const int cols = std::min(nr, nc - j);
+    for (int p = 0; p < kc; p++) {
+      if (op == Op::kNoTrans) {
+        const T* src = b + p * (long)ldb + j;
+        for (int c = 0; c < cols; c++) packed[c] = load(src[c]);
+      } else {
+        for (int c = 0; c < cols; c++)
+          packed[c] = load(b[(j + c) * (long)ldb + p]);
+      }
+      for (int c = cols; c < nr; c++) packed[c] = 0.0;
+      packed += nr;
+    }
+  }
+}
+
+// C(mr x nr) += the product of a packed sliver of A and one of B; mr and
+// nr are below the register tile only at the edges of C.
+using MicroKernelFn = void (*)(int kc, const double* a, const double* b,
+                               double* c, int ldc, int mr, int nr);
+
+struct GemmKernel {
+  int mr, nr;
+  // Depth of the packed slivers and rows of the L2 block of A, a multiple
+  // of mr.
+  int kc, mc;
+  MicroKernelFn micro_kernel;
+};
+
+// Adds an MR x NR tile of accumulators, stored row by row, to C.
+template <int MR, int NR>
+void AddTile(const double (&tile)[MR][NR], double* c, int ldc, int mr,
+             int nr) {
+  for (int i = 0; i < mr; i++) {
+    double* dst = c + i * (long)ldc;
+    for (int j = 0; j < nr; j++) dst[j] += tile[i][j];
+  }
+}
+
+// Two-lane double vector; GCC lowers it to SSE2 on x86-64 and to plain
+// scalar code where no SIMD unit is available. Without FMA, this is the
+// kernel of the levels below AVX2.
+typedef double Vec2 __attribute__((vector_size(16)));
+constexpr int kGenericMr = 4;
+constexpr int kGenericNr = 8;
+
+void MicroKernelGeneric(int kc, const double* a, const double* b, double* c,
+                        int ldc, int mr, int nr) {
+  constexpr int kVecs = kGenericNr / 2;
+  Vec2 acc[kGenericMr][kVecs] = {};
+  for (int p = 0; p < kc; p++) {
+    Vec2 bv[kVecs];
+    std::memcpy(bv, b, sizeof(bv));
+    for (int i = 0; i < kGenericMr; i++) {
+      const double ai = a[i];
+      for (int j = 0; j < kVecs; j++) acc[i][j] += ai * bv[j];
+    }
+    a += kGenericMr;
+    b += kGenericNr;
+  }
+  double tile[kGenericMr][kGenericNr];
+  std::memcpy(tile, acc, sizeof(tile));
+  AddTile(tile, c, ldc, mr, nr);
+}
+
+const GemmKernel kGenericKernel = {kGenericMr, kGenericNr, 256, 128,
+                                   MicroKernelGeneric};
+
+#if defined(__x86_64__) || defined(__i386__)
+
+// MR x NR tiles of WIDTH-lane FMA accumulators, one broadcast element of A
+// times one row of the B sliver per step. Full tiles are added to C in
+// registers, edge tiles through a buffer.
+#define S21_DEFINE_FMA_KERNEL(SUFFIX, TARGET, VEC, WIDTH, MR, NR, LOAD,    \
+                              STORE, SET1, ADD, FMADD)                     \
+  __attribute__((target(TARGET))) void MicroKernel##SUFFIX(                \
+      int kc, const double* a, const double* b, double* c, int ldc,        \
+      int mr, int nr) {                                                    \
+    constexpr int kVecs = NR / WIDTH;                                      \
+    VEC acc[MR][kVecs];                                                    \
+    for (int i = 0; i < MR; i++)                                           \
+      for (int j = 0; j < kVecs; j++) acc[i][j] = SET1(0.0);               \
+    _Pragma("GCC unroll 4")                                                \
+    for (int p = 0; p < kc; p++) {                                         \
+      VEC bv[kVecs];                                                       \
+      for (int j = 0; j < kVecs; j++) bv[j] = LOAD(b + j * WIDTH);         \
+      for (int i = 0; i < MR; i++) {                                       \
+        const VEC ai = SET1(a[i]);                                         \
+        for (int j = 0; j < kVecs; j++)                                    \
+          acc[i][j] = FMADD(ai, bv[j], acc[i][j]);                         \
+      }                                                                    \
+      a += MR;                                                             \
+      b += NR;                                                             \
+    }                                                                      \
+    if (mr == MR && nr == NR) {                                            \
+      for (int i = 0; i < MR; i++) {                                       \
+        double* dst = c + i * (long)ldc;                                   \
+        for (int j = 0; j < kVecs; j++)                                    \
+          STORE(dst + j * WIDTH, ADD(LOAD(dst + j * WIDTH), acc[i][j]));   \
+      }                                                                    \
+      return;                                                              \
+    }                                                                      \
+    double tile[MR][NR];                                                   \
+    for (int i = 0; i < MR; i++)                                           \
+      for (int j = 0; j < kVecs; j++) STORE(&tile[i][j * WIDTH], acc[i][j]); \
+    AddTile(tile, c, ldc, mr, nr);                                         \
+  }
+
+// 12 and 24 of the 16 and 32 vector registers hold accumulators.
+S21_DEFINE_FMA_KERNEL(Avx2, "avx2,fma", __m256d, 4, 6, 8, _mm256_loadu_pd,
+                      _mm256_storeu_pd, _mm256_set1_pd, _mm256_add_pd,
+                      _mm256_fmadd_pd)
+S21_DEFINE_FMA_KERNEL(Avx512, "avx512f", __m512d, 8, 6, 32, _mm512_loadu_pd,
+                      _mm512_storeu_pd, _mm512_set1_pd, _mm512_add_pd,
+                      _mm512_fmadd_pd)
+
+#undef S21_DEFINE_FMA_KERNEL
+
+const GemmKernel kAvx2Kernel = {6, 8, 256, 120, MicroKernelAvx2};
+const GemmKernel kAvx512Kernel = {6, 32, 128, 252, MicroKernelAvx512};
+
+#endif
+
+// The micro-kernel of ActiveSimdLevel(). AVX2 without FMA, which no CPU
+// is known to ship, keeps the generic kernel.
+const GemmKernel& ActiveKernel() {
+#if defined(__x86_64__) || defined(__i386__)
+  static const bool fma = __builtin_cpu_supports("fma");
+  switch (ActiveSimdLevel()) {
+    case SimdLevel::kAvx512:
+      return kAvx512Kernel;
+    case SimdLevel::kAvx2:
+      if (fma) return kAvx2Kernel;
+      break;
+    default:
+      break;
+  }
+#endif
+  return kGenericKernel;
+}
+
+void MacroKernel(const GemmKernel& kernel, int mc, int nc, int kc,
+                 const double* packed_a, const double* packed_b, double* c,
+                 int ldc) {
+  for (int j = 0; j < nc; j += kernel.nr) {
+    const int nr = std::min(kernel.nr, nc - j);
+    const double* b_sliver = packed_b + (long)j * kc;
+    for (int i = 0; i < mc; i += kernel.mr) {
+      const int mr = std::min(kernel.mr, mc - i);
+      kernel.micro_kernel(kc, packed_a + (long)i * kc, b_sliver,
+                          c + i * (long)ldc + j, ldc, mr, nr);
+    }
+  }
+}
+
+// i-k-j loop of GemmReference, reading the operands through the loaders.
+template <typename T, typename LoadA, typename LoadB>
+void ReferenceProduct(Op op_a, Op op_b, int m, int n, int k, const T* a,
+                      int lda, LoadA load_a, const T* b, int ldb,
+                      LoadB load_b, double* c, int ldc) {
+  for (int row = 0; row < m; row++) {
+    double* dst = c + row * (long)ldc;
+    for (int i = 0; i < k; i++) {
+      const double factor = load_a(*At(a, lda, op_a, row, i));
+      if (op_b == Op::kNoTrans) {
+        const T* rhs = b + i * (long)ldb;
+        for (int col = 0; col < n; col++)
+          dst[col] += factor * load_b(rhs[col]);
+      } else {
+        for (int col = 0; col < n; col++)
+          dst[col] += factor * load_b(b[col * (long)ldb + i]);
+      }
+    }
+  }
+}
+
+// Gemm for operands of any element type that the loaders widen to double.
+template <typename T, typename LoadA, typename LoadB>
+void PackedProduct(Op op_a, Op op_b, int m, int n, int k, const T* a, int lda,
+                   LoadA load_a, const T* b, int ldb, LoadB load_b, double* c,
+                   int ldc) {
+  if (m <= 0 || n <= 0 || k <= 0) return;
+  if ((long)m * n * k <= kSmallProduct) {
+    ReferenceProduct(op_a, op_b, m, n, k, a, lda, load_a, b, ldb, load_b, c,
+                     ldc);
+    return;
+  }
+  const GemmKernel& kernel = ActiveKernel();
+  const int mr = kernel.mr, nr = kernel.nr;
+  const int kc_block = kernel.kc, mc_block = kernel.mc;
+  const int nc_max = std::min(kNc, RoundUp(n, nr));
+  const int mc_max = std::min(mc_block, RoundUp(m, mr));
+  const int kc_max = std::min(kc_block, k);
+  const PackLease packed_b(pack_b_slot, (std::size_t)nc_max * kc_max);
+  for (int jc = 0; jc < n; jc += kNc) {
+    const int nc = std::min(kNc, n - jc);
+    const int row_blocks = (m + mc_block - 1) / mc_block;
+    const int col_blocks = (nc + kNcSplit - 1) / kNcSplit;
+    for (int pc = 0; pc < k; pc += kc_block) {
+      const int kc = std::min(kc_block, k - pc);
+      PackB(op_b, kc, nc, At(b, ldb, op_b, pc, jc), ldb, load_b, nr,
+            packed_b.get());
+      // Each tile owns a disjoint block of C, so splitting the tiles
+      // between threads does not change any result.
+      S21ThreadPool::ParallelFor(
+          row_blocks * col_blocks, (long)mc_block * kNcSplit * kc,
+          [&](int begin, int end) {
+            const PackLease packed_a(pack_a_slot,
+                                     (std::size_t)mc_max * kc_max);
+            int packed_ic = -1;
+            for (int tile = begin; tile < end; tile++) {
+              const int ic = tile / col_blocks * mc_block;
+              const int jr = tile % col_blocks * kNcSplit;
+              const int mc = std::min(mc_block, m - ic);
+              if (ic != packed_ic) {
+                PackA(op_a, mc, kc, At(a, lda, op_a, ic, pc), lda, load_a,
+                      mr, packed_a.get());
+                packed_ic = ic;
+              }
+              MacroKernel(kernel, mc, std::min(kNcSplit, nc - jr), kc,
+                          packed_a.get(), packed_b.get() + (long)jr * kc,
+                          c + ic * (long)ldc + jc + jr, ldc);
+            }
+          });
+    }
+  }
+}
+
+// Real and imaginary parts of C as four real products.
+template <typename T>
+void ComplexGemm(int m, int n, int k, const std::complex<T>* a, int lda,
+                 const std::complex<T>* b, int ldb, double* c_real,
+                 double* c_imag, int ldc) {
+  constexpr Op kN = Op::kNoTrans;
+  PackedProduct(kN, kN, m, n, k, a, lda, RealPart(), b, ldb, RealPart(),
+                c_real, ldc);
+  PackedProduct(kN, kN, m, n, k, a, lda, NegatedImagPart(), b, ldb,
+                ImagPart(), c_real, ldc);
+  PackedProduct(kN, kN, m, n, k, a, lda, RealPart(), b, ldb, ImagPart(),
+                c_imag, ldc);
+  PackedProduct(kN, kN, m, n, k, a, lda, ImagPart(), b, ldb, RealPart(),
+                c_imag, ldc);
+}
+
+}  // namespace
+
+void Gemm(Op op_a, Op op_b, int m, int n, int k, const double* a, int lda,
+          const double* b, int ldb, double* c, int ldc) {
+  PackedProduct(op_a, op_b, m, n, k, a, lda, Widen(), b, ldb, Widen(), c,
+                ldc);
+}
+
+void Gemm(int m, int n, int k, const float* a, int lda, const float* b,
+          int ldb, double* c, int ldc) {
+  PackedProduct(Op::kNoTrans, Op::kNoTrans, m, n, k, a, lda, Widen(), b, ldb,
+                Widen(), c, ldc);
+}
+
+void Gemm(int m, int n, int k, const std::complex<float>* a, int lda,
+          const std::complex<float>* b, int ldb, double* c_real,
+          double* c_imag, int ldc) {
+  ComplexGemm(m, n, k, a, lda, b, ldb, c_real, c_imag, ldc);
+}
+
+void Gemm(int m, int n, int k, const std::complex<double>* a, int lda,
+          const std::complex<double>* b, int ldb, double* c_real,
+          double* c_imag, int ldc) {
+  ComplexGemm(m, n, k, a, lda, b, ldb, c_real, c_imag, ldc);
+}
+
+void Gemv(Op op_a, int m, int n, double alpha, const double* a, int lda,
+          const double* x, double beta, double* y) {
+  if (m <= 0) return;
+  if (op_a == Op::kNoTrans) {
+    S21ThreadPool::ParallelFor(m, n, [&](int begin, int end) {
+      for (int i = begin; i < end; i++) {
+        const double dot = Dot(a + i * (long)lda, x, n);
+        y[i] = beta == 0.0 ? alpha * dot : beta * y[i] + alpha * dot;
+      }
+    });
+    return;
+  }
+  // Row i of op(A) is column i of A, so y accumulates alpha * x[p] times
+  // row p of A, one block of y at a time.
+  const int blocks = (m + kGemvBlock - 1) / kGemvBlock;
+  S21ThreadPool::ParallelFor(
+      blocks, (long)kGemvBlock * n, [&](int begin, int end) {
+        for (int block = begin; block < end; block++) {
+          const int first = block * kGemvBlock;
+          const int size = std::min(kGemvBlock, m - first);
+          double* dst = y + first;
+          if (beta == 0.0) {
+            std::fill(dst, dst + size, 0.0);
+          } else if (beta != 1.0) {
+            Scale(dst, beta, size);
+          }
+          for (int p = 0; p < n; p++)
+            Axpy(dst, alpha * x[p], a + p * (long)lda + first, size);
+        }
+      });
+}
+
+void GemmReference(Op op_a, Op op_b, int m, int n, int k, const double* a,
+                   int lda, const double* b, int ldb, double* c, int ldc) {
+  ReferenceProduct(op_a, op_b, m, n, k, a, lda, Widen(), b, ldb, Widen(), c,
+                   ldc);
+}
+
+}  // namespace s21_kernels
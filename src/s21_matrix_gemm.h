@@ -0,0 +1,57 @@
+#ifndef SRC_S21_MATRIX_GEMM_
+#define SRC_S21_MATRIX_GEMM_
+
+#include <complex>
+
+namespace s21_kernels {
+
+// How an operand is read: as stored, or as its transpose (an m x k operand
+// with kTrans is stored k x m).
+enum class Op { kNoTrans, kTrans };
+
+// C(m x n) += op(A)(m x k) * op(B)(k x n); all operands row-major with the
+// given leading dimensions. C must not alias A or B. The micro-kernel of
+// ActiveSimdLevel() fuses multiply-adds from AVX2 on, so results differ in
+// the last bits between levels but not between thread counts. Packing
+// buffers are kept per thread and only grow, up to 4 MiB.
+void Gemm(Op op_a, Op op_b, int m, int n, int k, const double* a, int lda,
+          const double* b, int ldb, double* c, int ldc);
+
+// C(m x n) += A(m x k) * B(k x n) for float and complex operands on the
+// same packed double kernels: elements are widened to double as they are
+// packed, so C is summed in double and the caller rounds it once. Complex
+// products are four real ones into the real and imaginary parts of C,
+// kept in separate arrays with the same leading dimension.
+void Gemm(int m, int n, int k, const float* a, int lda, const float* b,
+          int ldb, double* c, int ldc);
+void Gemm(int m, int n, int k, const std::complex<float>* a, int lda,
+          const std::complex<float>* b, int ldb, double* c_real,
+          double* c_imag, int ldc);
+void Gemm(int m, int n, int k, const std::complex<double>* a, int lda,
+          const std::complex<double>* b, int ldb, double* c_real,
+          double* c_imag, int ldc);
+
+// Straightforward i-k-j loop, kept as the reference implementation.
+void GemmReference(Op op_a, Op op_b, int m, int n, int k, const double* a,
+                   int lda, const double* b, int ldb, double* c, int ldc);
+
+// y(m) = alpha * op(A)(m x n) * x(n) + beta * y with A row-major; beta 0
+// overwrites y without reading it. Rows of op(A) are split between threads
+// for kNoTrans, blocks of y for kTrans, so each element of y is summed by
+// one thread in a fixed order. y must not alias A or x.
+void Gemv(Op op_a, int m, int n, double alpha, const double* a, int lda,
+          const double* x, double beta, double* y);
+
+inline void Gemm(int m, int n, int k, const double* a, int lda,
+                 const double* b, int ldb, double* c, int ldc) {
+  Gemm(Op::kNoTrans, Op::kNoTrans, m, n, k, a, lda, b, ldb, c, ldc);
+}
+
+inline void GemmReference(int m, int n, int k, const double* a, int lda,
+                          const double* b, int ldb, double* c, int ldc) {
+  GemmReference(Op::kNoTrans, Op::kNoTrans, m, n, k, a, lda, b, ldb, c, ldc);
+}
+
+}  // namespace s21_kernels
+
+#endif  // SRC_S21_MATRIX_GEMM_
@@ -0,0 +1,104 @@
+#include "s21_matrix_householder.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "s21_matrix_gemm.h"
+#include "s21_matrix_simd.h"
+
+namespace s21_views {
+
+namespace {
+
+// Reflectors per compact WY block.
+constexpr int kBlock = 64;
+
+}  // namespace
+
+double MakeReflector(S21MatrixView a, int j) {
+  const int m = a.GetRows();
+  const double alpha = a.At(j, j);
+  double sigma = 0.0;
+  for (int r = j + 1; r < m; r++) sigma += a.At(r, j) * a.At(r, j);
+  if (sigma == 0.0) return 0.0;
+  const double norm = std::sqrt(alpha * alpha + sigma);
+  const double beta = alpha > 0 ? -norm : norm;
+  const double scale = 1.0 / (alpha - beta);
+  for (int r = j + 1; r < m; r++) a.At(r, j) *= scale;
+  a.At(j, j) = beta;
+  return (beta - alpha) / beta;
+}
+
+void ApplyReflector(S21MatrixView a, int j, double tau, int from, int to,
+                    std::vector<double>& w) {
+  if (tau == 0.0 || from >= to) return;
+  const int m = a.GetRows(), count = to - from;
+  w.assign(a.RowData(j) + from, a.RowData(j) + to);
+  for (int r = j + 1; r < m; r++)
+    s21_kernels::Axpy(w.data(), a.At(r, j), a.RowData(r) + from, count);
+  s21_kernels::Axpy(a.RowData(j) + from, -tau, w.data(), count);
+  for (int r = j + 1; r < m; r++)
+    s21_kernels::Axpy(a.RowData(r) + from, -tau * a.At(r, j), w.data(),
+                      count);
+}
+
+S21Matrix TriangularFactor(const S21Matrix& y, const double* taus) {
+  const int nb = y.GetCols();
+  S21Matrix gram(nb, nb, y.GetResource());
+  Multiply(y.View().Transposed(), y.View(), gram.View());
+  S21Matrix t(nb, nb, y.GetResource());
+  for (int i = 0; i < nb; i++) {
+    t(i, i) = taus[i];
+    for (int r = 0; r < i; r++) {
+      double sum = 0.0;
+      for (int c = r; c < i; c++) sum += t(r, c) * gram(c, i);
+      t(r, i) = -taus[i] * sum;
+    }
+  }
+  return t;
+}
+
+void ApplyBlock(const S21Matrix& y, const S21Matrix& t, bool transposed,
+                S21MatrixView target) {
+  const int nb = y.GetCols(), cols = target.GetCols();
+  if (cols == 0) return;
+  S21Matrix w(nb, cols, y.GetResource());
+  Multiply(y.View().Transposed(), target, w);
+  S21Matrix tw(nb, cols, y.GetResource());
+  Multiply(transposed ? t.View().Transposed() : t.View(), w, tw);
+  tw.MulNumber(-1.0);
+  s21_kernels::Gemm(y.GetRows(), cols, nb, y.View().Data(),
+                    (int)y.View().GetRowStride(), tw.View().Data(),
+                    (int)tw.View().GetRowStride(), target.Data(),
+                    (int)target.GetRowStride());
+}
+
+S21Matrix Reflectors(S21ConstMatrixView packed, int first, int count) {
+  const int rows = packed.GetRows() - first;
+  S21Matrix y(rows, count);
+  const S21ConstMatrixView src = packed.Submatrix(first, first, rows, count);
+  const S21MatrixView dst = y.View();
+  for (int r = 0; r < rows; r++)
+    for (int c = 0; c < std::min(r, count); c++) dst.At(r, c) = src.At(r, c);
+  for (int c = 0; c < count; c++) dst.At(c, c) = 1.0;
+  return y;
+}
+
+void ApplyReflectors(S21ConstMatrixView packed, const double* taus,
+                     int count, bool transposed, S21MatrixView target) {
+  if (packed.GetRows() != target.GetRows())
+    throw std::out_of_range("Different matrix dimensions");
+  const int blocks = (count + kBlock - 1) / kBlock;
+  for (int step = 0; step < blocks; step++) {
+    // Q^T = H_(count - 1) * ... * H_0 starts with the first block, Q with
+    // the last.
+    const int first = (transposed ? step : blocks - 1 - step) * kBlock;
+    const int nb = std::min(kBlock, count - first);
+    const S21Matrix y = Reflectors(packed, first, nb);
+    ApplyBlock(y, TriangularFactor(y, taus + first), transposed,
+               target.Submatrix(first, 0, target.GetRows() - first,
+                                target.GetCols()));
+  }
+}
+
+}  // namespace s21_views
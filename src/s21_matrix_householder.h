@@ -0,0 +1,48 @@
+#ifndef SRC_S21_MATRIX_HOUSEHOLDER_
+#define SRC_S21_MATRIX_HOUSEHOLDER_
+
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+// Householder reflectors H = I - tau * v * v^T shared by the QR,
+// eigenvalue and singular value decompositions. A sequence of reflectors
+// is kept packed LAPACK-style: v_j fills column j of a matrix below row j,
+// with v_j(j) = 1 implied, and blocks of 64 of them are applied in the
+// compact WY form H_1 * ... * H_nb = I - Y * T * Y^T, so that the work is
+// GEMM. Rows of a view only need to be contiguous where stated.
+namespace s21_views {
+
+// Turns column j of a, from row j down, into a Householder vector v with
+// an implicit v_j = 1, so that I - tau * v * v^T maps the column to
+// (beta, 0, ..., 0); beta is stored at (j, j). Returns tau, 0 when the
+// column is already in that form.
+double MakeReflector(S21MatrixView a, int j);
+
+// Applies the reflector of column j to columns [from, to) of a, row by
+// row; w is scratch.
+void ApplyReflector(S21MatrixView a, int j, double tau, int from, int to,
+                    std::vector<double>& w);
+
+// Y of the count reflectors packed from column first on, unit diagonal and
+// zeros above it included: a (rows - first) x count matrix.
+S21Matrix Reflectors(S21ConstMatrixView packed, int first, int count);
+
+// Upper triangular T with H_1 * ... * H_nb = I - Y * T * Y^T for the
+// reflectors in the columns of y, built from the Gram matrix Y^T * Y.
+S21Matrix TriangularFactor(const S21Matrix& y, const double* taus);
+
+// target -= Y * op(T) * Y^T * target, which applies Q^T of the block when
+// transposed and Q otherwise. The rows of target must be contiguous.
+void ApplyBlock(const S21Matrix& y, const S21Matrix& t, bool transposed,
+                S21MatrixView target);
+
+// Applies Q = H_0 * ... * H_(count - 1) of the reflectors packed in the
+// first count columns, or Q^T when transposed, to a target with as many
+// rows as packed. The rows of target must be contiguous.
+void ApplyReflectors(S21ConstMatrixView packed, const double* taus,
+                     int count, bool transposed, S21MatrixView target);
+
+}  // namespace s21_views
+
+#endif  // SRC_S21_MATRIX_HOUSEHOLDER_
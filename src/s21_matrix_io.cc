@@ -0,0 +1,219 @@
+#include "s21_matrix_io.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+#include "s21_thread_pool.h"
+
+namespace s21_io {
+
+namespace {
+
+constexpr char kMagic[8] = {'S', '2', '1', 'M', 'A', 'T', 'R', 'X'};
+constexpr std::uint32_t kVersion = 1;
+constexpr std::uint32_t kFloat64 = 1;
+constexpr std::uint32_t kRowMajorPadded = 1;
+// Written as a number and compared as one, so files from a machine with
+// the other byte order are rejected.
+constexpr std::uint32_t kByteOrderMark = 0x01020304;
+
+constexpr std::uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+constexpr std::uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr std::uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+
+std::uint64_t RotateLeft(std::uint64_t value, int bits) {
+  return (value << bits) | (value >> (64 - bits));
+}
+
+std::uint64_t Mix(std::uint64_t acc, std::uint64_t word) {
+  return RotateLeft(acc + word * kPrime2, 31) * kPrime1;
+}
+
+}  // namespace
+
+FileHeader MakeHeader(int rows, int cols) {
+  FileHeader header = {};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.header_size = sizeof(FileHeader);
+  header.dtype = kFloat64;
+  header.layout = kRowMajorPadded;
+  header.alignment = kAlignment;
+  header.byte_order = kByteOrderMark;
+  header.rows = rows;
+  header.cols = cols;
+  header.stride = StrideFor(cols);
+  return header;
+}
+
+std::size_t CheckHeader(const FileHeader& header, std::uint64_t file_size) {
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0)
+    throw std::invalid_argument("Not an S21Matrix file");
+  if (header.version != kVersion || header.header_size != sizeof(FileHeader))
+    throw std::invalid_argument("Unsupported S21Matrix file version");
+  // Rows and columns must fit in an int with room for the row padding.
+  const std::int64_t max = std::numeric_limits<int>::max() - kStrideStep;
+  if (header.rows < 0 || header.cols < 0 || header.rows > max ||
+      header.cols > max)
+    throw std::invalid_argument("S21Matrix file is truncated or corrupted");
+  if (header.byte_order != kByteOrderMark || header.dtype != kFloat64 ||
+      header.layout != kRowMajorPadded || header.alignment != kAlignment ||
+      header.stride != StrideFor((int)header.cols))
+    throw std::invalid_argument("Unsupported S21Matrix file layout");
+  // Compared by division, so that a corrupted shape cannot overflow.
+  const std::uint64_t row_bytes = header.stride * sizeof(double);
+  const std::uint64_t data_size = file_size - sizeof(FileHeader);
+  const bool fits =
+      file_size >= sizeof(FileHeader) &&
+      (header.rows == 0 || row_bytes == 0
+           ? data_size == 0
+           : data_size % row_bytes == 0 &&
+                 data_size / row_bytes == (std::uint64_t)header.rows);
+  if (!fits)
+    throw std::invalid_argument("S21Matrix file is truncated or corrupted");
+  return data_size;
+}
+
+// xxHash64-style, four independent accumulators over whole doubles.
+std::uint64_t HashChunk(const void* data, std::size_t bytes) {
+  const auto* src = static_cast<const unsigned char*>(data);
+  std::uint64_t lanes[4] = {kPrime1 + kPrime2, kPrime2, 0, 0 - kPrime1};
+  std::size_t offset = 0;
+  for (; offset + 32 <= bytes; offset += 32) {
+    for (int lane = 0; lane < 4; lane++) {
+      std::uint64_t word;
+      std::memcpy(&word, src + offset + lane * 8, 8);
+      lanes[lane] = Mix(lanes[lane], word);
+    }
+  }
+  for (; offset + 8 <= bytes; offset += 8) {
+    std::uint64_t word;
+    std::memcpy(&word, src + offset, 8);
+    lanes[0] = Mix(lanes[0], word);
+  }
+  std::uint64_t hash = RotateLeft(lanes[0], 1) + RotateLeft(lanes[1], 7) +
+                       RotateLeft(lanes[2], 12) + RotateLeft(lanes[3], 18);
+  hash ^= bytes;
+  hash = (hash ^ (hash >> 33)) * kPrime2;
+  hash = (hash ^ (hash >> 29)) * kPrime3;
+  return hash ^ (hash >> 32);
+}
+
+std::uint64_t CombineChunks(const std::uint64_t* hashes, std::size_t count,
+                            std::size_t bytes) {
+  std::uint64_t hash = kPrime3 ^ bytes;
+  for (std::size_t i = 0; i < count; i++) hash = Mix(hash, hashes[i]);
+  return hash;
+}
+
+// Chunks are combined in order, so the result does not depend on the
+// number of threads.
+std::uint64_t Checksum(const void* data, std::size_t bytes) {
+  const auto* src = static_cast<const unsigned char*>(data);
+  const int chunks = (int)((bytes + kChunkBytes - 1) / kChunkBytes);
+  std::vector<std::uint64_t> hashes(chunks);
+  S21ThreadPool::ParallelFor(chunks, kChunkBytes / 8, [&](int begin, int end) {
+    for (int chunk = begin; chunk < end; chunk++) {
+      const std::size_t offset = chunk * kChunkBytes;
+      hashes[chunk] =
+          HashChunk(src + offset, std::min(kChunkBytes, bytes - offset));
+    }
+  });
+  return CombineChunks(hashes.data(), hashes.size(), bytes);
+}
+
+}  // namespace s21_io
+
+void S21Matrix::Save(const std::string& path) const {
+  static_assert(kAlignment == s21_io::kAlignment,
+                "files keep the in-memory layout");
+  // Spare columns are not part of the format; a copy drops them.
+  if (stride_ != StrideFor(cols_)) return S21Matrix(*this).Save(path);
+  const std::size_t data_size = BufferSize() * sizeof(double);
+  s21_io::FileHeader header = s21_io::MakeHeader(rows_, cols_);
+  header.checksum = s21_io::Checksum(matrix_, data_size);
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  if (data_size) file.write(reinterpret_cast<const char*>(matrix_), data_size);
+  file.close();
+  if (!file) throw std::runtime_error("Cannot write file " + path);
+}
+
+S21Matrix S21Matrix::Load(const std::string& path,
+                          std::pmr::memory_resource* resource) {
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file) throw std::runtime_error("Cannot open file " + path);
+  const std::uint64_t file_size = file.tellg();
+  s21_io::FileHeader header;
+  file.seekg(0);
+  if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+    throw std::invalid_argument("Not an S21Matrix file");
+  const std::size_t data_size = s21_io::CheckHeader(header, file_size);
+  S21Matrix result((int)header.rows, (int)header.cols, resource);
+  if (data_size &&
+      !file.read(reinterpret_cast<char*>(result.matrix_), data_size))
+    throw std::runtime_error("Cannot read file " + path);
+  if (s21_io::Checksum(result.matrix_, data_size) != header.checksum)
+    throw std::invalid_argument("S21Matrix file checksum mismatch");
+  return result;
+}
+
+S21Matrix S21Matrix::Map(const std::string& path, bool verify_checksum,
+                         std::pmr::memory_resource* resource) {
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) throw std::runtime_error("Cannot open file " + path);
+  struct stat status;
+  s21_io::FileHeader header;
+  const bool readable =
+      ::fstat(fd, &status) == 0 &&
+      ::pread(fd, &header, sizeof(header), 0) == (ssize_t)sizeof(header);
+  if (!readable) {
+    ::close(fd);
+    throw std::invalid_argument("Not an S21Matrix file");
+  }
+  std::size_t data_size;
+  try {
+    data_size = s21_io::CheckHeader(header, status.st_size);
+  } catch (...) {
+    ::close(fd);
+    throw;
+  }
+  if (data_size == 0) {
+    ::close(fd);
+    return S21Matrix((int)header.rows, (int)header.cols, resource);
+  }
+  // Private and writable: pages are shared with the page cache until the
+  // matrix writes to them. The mapping outlives the descriptor.
+  void* mapping = ::mmap(nullptr, status.st_size, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (mapping == MAP_FAILED)
+    throw std::runtime_error("Cannot map file " + path);
+  S21Matrix result(resource);
+  result.rows_ = (int)header.rows;
+  result.cols_ = (int)header.cols;
+  result.stride_ = (int)header.stride;
+  result.matrix_ = reinterpret_cast<double*>(static_cast<char*>(mapping) +
+                                             sizeof(s21_io::FileHeader));
+  result.capacity_ = result.BufferSize();
+  result.mapping_ = mapping;
+  result.mapping_size_ = status.st_size;
+  if (verify_checksum &&
+      s21_io::Checksum(result.matrix_, data_size) != header.checksum)
+    throw std::invalid_argument("S21Matrix file checksum mismatch");
+  return result;
+}
+
+void S21Matrix::Unmap(void* mapping, std::size_t size) {
+  ::munmap(mapping, size);
+}
@@ -0,0 +1,55 @@
+#ifndef SRC_S21_MATRIX_IO_
+#define SRC_S21_MATRIX_IO_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace s21_io {
+
+// File format, version 1: a 64-byte FileHeader followed by the elements
+// exactly as S21Matrix keeps them in memory, rows x stride doubles in
+// native byte order with every row zero-padded to stride. The data starts
+// 64 bytes into the file, so a mapping of the whole file can be used as a
+// matrix buffer directly.
+struct FileHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t header_size;
+  std::uint32_t dtype;
+  std::uint32_t layout;
+  std::uint32_t alignment;
+  std::uint32_t byte_order;
+  std::int64_t rows, cols, stride;
+  // Checksum() of the data section.
+  std::uint64_t checksum;
+};
+static_assert(sizeof(FileHeader) == 64, "the data must stay 64-byte aligned");
+
+constexpr std::size_t kAlignment = 64;
+constexpr int kStrideStep = kAlignment / sizeof(double);
+// The checksum hashes the data in chunks of this size, so it can be
+// computed while streaming a file through a chunk-sized buffer.
+constexpr std::size_t kChunkBytes = std::size_t(1) << 20;
+
+inline int StrideFor(int cols) {
+  return (cols + kStrideStep - 1) / kStrideStep * kStrideStep;
+}
+
+// Header for a rows x cols matrix with a zero checksum.
+FileHeader MakeHeader(int rows, int cols);
+// Validates everything but the checksum and returns the size of the data
+// section; throws std::invalid_argument if the file cannot be read as a
+// matrix.
+std::size_t CheckHeader(const FileHeader& header, std::uint64_t file_size);
+
+// Hash of one chunk of at most kChunkBytes, then the checksum of a data
+// section from the hashes of its chunks in order.
+std::uint64_t HashChunk(const void* data, std::size_t bytes);
+std::uint64_t CombineChunks(const std::uint64_t* hashes, std::size_t count,
+                            std::size_t bytes);
+// The two above over an in-memory data section, chunks in parallel.
+std::uint64_t Checksum(const void* data, std::size_t bytes);
+
+}  // namespace s21_io
+
+#endif  // SRC_S21_MATRIX_IO_
@@ -0,0 +1,89 @@
+#include "s21_matrix_oop.h"
+
+#include <algorithm>
+#include <cmath>
+
+S21LU::S21LU(const S21Matrix& matrix) : lu_(matrix.resource_) {
+  Factor(matrix);
+}
+
+void S21LU::Factor(const S21Matrix& matrix) {
+  if (matrix.rows_ != matrix.cols_)
+    throw std::invalid_argument("The matrix is not square");
+  lu_ = matrix;
+  pivots_.resize(lu_.rows_);
+  sign_ = s21_views::FactorLU(lu_, pivots_.data(), singular_);
+}
+
+double S21LU::Determinant() const {
+  double det = sign_;
+  for (int i = 0; i < lu_.rows_; i++) det *= lu_.Row(i)[i];
+  return det;
+}
+
+S21Matrix S21LU::Solve(const S21Matrix& b) const {
+  S21Matrix x(b.resource_);
+  SolveInto(b, x);
+  return x;
+}
+
+void S21LU::SolveInto(const S21Matrix& b, S21Matrix& x) const {
+  const int n = lu_.rows_;
+  if (b.rows_ != n)
+    throw std::out_of_range(
+        "Invalid matrix sizes: right-hand side must have as many rows as the "
+        "system matrix");
+  if (singular_) throw std::invalid_argument("Matrix is singular");
+  if (&x == &b) {
+    // Permuting the rows needs the original right-hand side.
+    const S21Matrix copy(b);
+    SolveInto(copy, x);
+    return;
+  }
+  const int k = b.cols_;
+  x.Reshape(n, k);
+  for (int i = 0; i < n; i++)
+    std::copy(b.Row(pivots_[i]), b.Row(pivots_[i]) + k, x.Row(i));
+  Substitute(x);
+}
+
+void S21LU::InverseInto(S21Matrix& out) const {
+  if (singular_) throw std::invalid_argument("Matrix is singular");
+  const int n = lu_.rows_;
+  out.Reshape(n, n);
+  for (int i = 0; i < n; i++) {
+    std::fill(out.Row(i), out.Row(i) + n, 0.0);
+    out.Row(i)[pivots_[i]] = 1.0;
+  }
+  Substitute(out);
+}
+
+void S21LU::Substitute(S21Matrix& x) const {
+  const int n = lu_.rows_, k = x.cols_;
+  for (int i = 0; i < n; i++) {
+    const double* lu_row = lu_.Row(i);
+    double* dst = x.Row(i);
+    for (int j = 0; j < i; j++) {
+      const double factor = lu_row[j];
+      const double* src = x.Row(j);
+      for (int c = 0; c < k; c++) dst[c] -= factor * src[c];
+    }
+  }
+  for (int i = n - 1; i >= 0; i--) {
+    const double* lu_row = lu_.Row(i);
+    double* dst = x.Row(i);
+    for (int j = i + 1; j < n; j++) {
+      const double factor = lu_row[j];
+      const double* src = x.Row(j);
+      for (int c = 0; c < k; c++) dst[c] -= factor * src[c];
+    }
+    const double diagonal = lu_row[i];
+    for (int c = 0; c < k; c++) dst[c] /= diagonal;
+  }
+}
+
+S21Matrix S21LU::Inverse() const {
+  S21Matrix out(lu_.resource_);
+  InverseInto(out);
+  return out;
+}
@@ -0,0 +1,102 @@
+#include "s21_matrix_memory.h"
+
+#include <new>
+#include <vector>
+
+namespace {
+
+constexpr int kSizeClasses = 9;  // 64 B ... 16 KiB
+static_assert(S21SmallBlockPool::kMinBlockSize << (kSizeClasses - 1) ==
+                  S21SmallBlockPool::kMaxBlockSize,
+              "size classes must cover the pooled range");
+
+void* AllocateBlock(std::size_t bytes, std::size_t alignment) {
+  return ::operator new(bytes, std::align_val_t(alignment));
+}
+
+void FreeBlock(void* ptr, std::size_t alignment) {
+  ::operator delete(ptr, std::align_val_t(alignment));
+}
+
+// Size class for a pooled request, or -1 if it goes straight upstream.
+int SizeClass(std::size_t bytes, std::size_t alignment) {
+  if (bytes > S21SmallBlockPool::kMaxBlockSize ||
+      alignment > S21SmallBlockPool::kBlockAlignment)
+    return -1;
+  int size_class = 0;
+  for (std::size_t size = S21SmallBlockPool::kMinBlockSize; size < bytes;
+       size <<= 1)
+    size_class++;
+  return size_class;
+}
+
+std::size_t ClassSize(int size_class) {
+  return S21SmallBlockPool::kMinBlockSize << size_class;
+}
+
+// Trivially destructible, so it can still be read while thread_local
+// objects of the exiting thread are being destroyed.
+thread_local bool cache_destroyed = false;
+
+struct ThreadCache {
+  std::vector<void*> free_lists[kSizeClasses];
+
+  // Reserved up front so that returning a block never allocates.
+  ThreadCache() {
+    for (auto& list : free_lists)
+      list.reserve(S21SmallBlockPool::kMaxCachedBlocks);
+  }
+
+  ~ThreadCache() {
+    cache_destroyed = true;
+    for (auto& list : free_lists)
+      for (void* block : list)
+        FreeBlock(block, S21SmallBlockPool::kBlockAlignment);
+  }
+};
+
+ThreadCache* Cache() {
+  if (cache_destroyed) return nullptr;
+  thread_local ThreadCache cache;
+  return &cache;
+}
+
+}  // namespace
+
+S21SmallBlockPool* S21SmallBlockPool::Instance() {
+  static S21SmallBlockPool pool;
+  return &pool;
+}
+
+void* S21SmallBlockPool::do_allocate(std::size_t bytes,
+                                     std::size_t alignment) {
+  const int size_class = SizeClass(bytes, alignment);
+  if (size_class < 0) return AllocateBlock(bytes, alignment);
+  ThreadCache* cache = Cache();
+  if (cache && !cache->free_lists[size_class].empty()) {
+    void* block = cache->free_lists[size_class].back();
+    cache->free_lists[size_class].pop_back();
+    return block;
+  }
+  return AllocateBlock(ClassSize(size_class), kBlockAlignment);
+}
+
+void S21SmallBlockPool::do_deallocate(void* ptr, std::size_t bytes,
+                                      std::size_t alignment) {
+  const int size_class = SizeClass(bytes, alignment);
+  if (size_class < 0) {
+    FreeBlock(ptr, alignment);
+    return;
+  }
+  ThreadCache* cache = Cache();
+  if (cache && cache->free_lists[size_class].size() < kMaxCachedBlocks) {
+    cache->free_lists[size_class].push_back(ptr);
+    return;
+  }
+  FreeBlock(ptr, kBlockAlignment);
+}
+
+bool S21SmallBlockPool::do_is_equal(
+    const std::pmr::memory_resource& other) const noexcept {
+  return this == &other;
+}
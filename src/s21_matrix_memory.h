@@ -0,0 +1,32 @@
+#ifndef SRC_S21_MATRIX_MEMORY_
+#define SRC_S21_MATRIX_MEMORY_
+
+#include <cstddef>
+#include <memory_resource>
+
+// Default memory resource of S21Matrix. Blocks up to kMaxBlockSize bytes
+// are rounded up to a power-of-two size class and recycled through
+// per-thread free lists, so creating and destroying small matrices does not
+// touch the shared heap. Every block is a separate upstream allocation,
+// which makes it safe to free a matrix on another thread than the one
+// that created it.
+class S21SmallBlockPool : public std::pmr::memory_resource {
+ public:
+  static constexpr std::size_t kMinBlockSize = 64;
+  static constexpr std::size_t kMaxBlockSize = 16 * 1024;
+  static constexpr std::size_t kBlockAlignment = 64;
+  static constexpr std::size_t kMaxCachedBlocks = 32;
+
+  static S21SmallBlockPool* Instance();
+
+ private:
+  S21SmallBlockPool() = default;
+
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+  void do_deallocate(void* ptr, std::size_t bytes,
+                     std::size_t alignment) override;
+  bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override;
+};
+
+#endif  // SRC_S21_MATRIX_MEMORY_
@@ -1,187 +1,379 @@
 #include "s21_matrix_oop.h"
 
-S21Matrix::S21Matrix() {
-  rows_ = 0, cols_ = 0;
-  matrix_ = nullptr;
-}
+#include <algorithm>
+#include <cstring>
+
+#include "s21_matrix_gemm.h"
+#include "s21_matrix_simd.h"
+#include "s21_matrix_stats.h"
+#include "s21_matrix_strassen.h"
+#include "s21_matrix_transpose.h"
+#include "s21_thread_pool.h"
+
+S21Matrix::S21Matrix() : S21Matrix(S21SmallBlockPool::Instance()) {}
+
+S21Matrix::S21Matrix(int rows, int cols)
+    : S21Matrix(rows, cols, S21SmallBlockPool::Instance()) {}
 
-S21Matrix::S21Matrix(int rows, int cols) : rows_(rows), cols_(cols) {
+S21Matrix::S21Matrix(std::pmr::memory_resource* resource)
+    : rows_(0), cols_(0), stride_(0), matrix_(nullptr), resource_(resource) {}
+
+S21Matrix::S21Matrix(int rows, int cols, std::pmr::memory_resource* resource)
+    : rows_(rows), cols_(cols), stride_(StrideFor(cols)), resource_(resource) {
   if (rows < 0 || cols < 0)
     throw std::invalid_argument("Number of rows or columns should be positive");
   MemoryAllocation();
 }
 
 S21Matrix::S21Matrix(const S21Matrix& other)
-    : rows_(other.rows_), cols_(other.cols_) {
+    : S21Matrix(other, other.resource_) {}
+
+S21Matrix::S21Matrix(const S21Matrix& other,
+                     std::pmr::memory_resource* resource)
+    : rows_(other.rows_),
+      cols_(other.cols_),
+      stride_(StrideFor(other.cols_)),
+      resource_(resource) {
   MemoryAllocation();
-  for (int row = 0; row < rows_; row++) {
-    for (int col = 0; col < cols_; col++) {
-      (*this)(row, col) = other(row, col);
-    }
-  }
+  CopyElements(other);
 }
 
 S21Matrix::S21Matrix(S21Matrix&& other)
-    : rows_(other.rows_), cols_(other.cols_) {
+    : rows_(other.rows_),
+      cols_(other.cols_),
+      stride_(other.stride_),
+      resource_(other.resource_),
+      capacity_(std::exchange(other.capacity_, 0)),
+      mapping_(std::exchange(other.mapping_, nullptr)),
+      mapping_size_(std::exchange(other.mapping_size_, 0)) {
   matrix_ = std::exchange(other.matrix_, nullptr);
-  other.rows_ = 0, other.cols_ = 0;
+  other.rows_ = 0, other.cols_ = 0, other.stride_ = 0;
+}
+
+S21Matrix::S21Matrix(S21MatrixProduct&& product)
+    : S21Matrix(std::move(product.result_)) {}
+
+S21Matrix::S21Matrix(S21ConstMatrixView view,
+                     std::pmr::memory_resource* resource)
+    : S21Matrix(view.GetRows(), view.GetCols(), resource) {
+  s21_views::Copy(view, View());
 }
 
 S21Matrix::~S21Matrix() { FreeMemory(); }
 
-bool S21Matrix::EqMatrix(const S21Matrix& other) {
+bool S21Matrix::EqMatrix(const S21Matrix& other) const {
   bool code = true;
   if (cols_ != other.cols_ || rows_ != other.rows_) code = false;
   for (int row = 0; row < rows_ && code; row++) {
-    for (int col = 0; col < cols_ && code; col++) {
-      if (S21Matrix::Fabs(matrix_[row][col] - other.matrix_[row][col]) > 1e-7)
-        code = false;
-    }
+    code = s21_kernels::AllClose(Row(row), other.Row(row), cols_, 1e-7);
   }
   return code;
 }
 
+bool S21Matrix::EqMatrix(S21ConstMatrixView other) const {
+  return s21_views::Equal(View(), other);
+}
+
 void S21Matrix::SumMatrix(const S21Matrix& other) {
   if (rows_ != other.rows_ || cols_ != other.cols_)
     throw std::out_of_range("Different matrix dimensions");
-  for (int row = 0; row < rows_; row++) {
-    for (int col = 0; col < cols_; col++) {
-      matrix_[row][col] += other.matrix_[row][col];
+  S21_STATS_SCOPE(s21_stats::Operation::kSum, rows_, cols_,
+                  (double)rows_ * cols_);
+  S21ThreadPool::ParallelFor(rows_, cols_, [&](int begin, int end) {
+    if (stride_ == other.stride_) {
+      s21_kernels::Add(Row(begin), other.Row(begin),
+                       (std::size_t)(end - begin) * stride_);
+    } else {
+      for (int row = begin; row < end; row++)
+        s21_kernels::Add(Row(row), other.Row(row), cols_);
     }
-  }
+  });
+}
+
+void S21Matrix::SumMatrix(S21ConstMatrixView other) {
+  S21_STATS_SCOPE(s21_stats::Operation::kSum, rows_, cols_,
+                  (double)rows_ * cols_);
+  s21_views::Add(other, View());
 }
 
 void S21Matrix::SubMatrix(const S21Matrix& other) {
   if (rows_ != other.rows_ || cols_ != other.cols_)
     throw std::out_of_range("Different matrix dimensions");
-  for (int row = 0; row < rows_; row++) {
-    for (int col = 0; col < cols_; col++) {
-      matrix_[row][col] -= other.matrix_[row][col];
+  S21_STATS_SCOPE(s21_stats::Operation::kSub, rows_, cols_,
+                  (double)rows_ * cols_);
+  S21ThreadPool::ParallelFor(rows_, cols_, [&](int begin, int end) {
+    if (stride_ == other.stride_) {
+      s21_kernels::Sub(Row(begin), other.Row(begin),
+                       (std::size_t)(end - begin) * stride_);
+    } else {
+      for (int row = begin; row < end; row++)
+        s21_kernels::Sub(Row(row), other.Row(row), cols_);
     }
-  }
+  });
+}
+
+void S21Matrix::SubMatrix(S21ConstMatrixView other) {
+  S21_STATS_SCOPE(s21_stats::Operation::kSub, rows_, cols_,
+                  (double)rows_ * cols_);
+  s21_views::Sub(other, View());
 }
 
 void S21Matrix::MulNumber(const double num) {
-  for (int row = 0; row < rows_; row++)
-    for (int col = 0; col < cols_; col++) matrix_[row][col] *= num;
+  S21_STATS_SCOPE(s21_stats::Operation::kMulNumber, rows_, cols_,
+                  (double)rows_ * cols_);
+  S21ThreadPool::ParallelFor(rows_, cols_, [&](int begin, int end) {
+    for (int row = begin; row < end; row++)
+      s21_kernels::Scale(Row(row), num, cols_);
+  });
 }
 
 void S21Matrix::MulMatrix(const S21Matrix& other) {
+  MulMatrixInto(*this, other, *this);
+}
+
+void S21Matrix::MulMatrix(const S21TransposedView& other) {
+  const S21Matrix& rhs = other.Transposed();
+  if (cols_ != rhs.cols_)
+    throw std::out_of_range(
+        "Invalid matrix sizes: number of cols of the first matrix must be "
+        "equal to the number of rows of the second matrix");
+  S21_STATS_SCOPE(s21_stats::Operation::kMulMatrix, rows_,
+                  std::max(cols_, rhs.rows_), 2.0 * rows_ * rhs.rows_ * cols_);
+  S21Matrix result(rows_, rhs.rows_, resource_);
+  s21_kernels::Gemm(s21_kernels::Op::kNoTrans, s21_kernels::Op::kTrans, rows_,
+                    rhs.rows_, cols_, matrix_, stride_, rhs.matrix_,
+                    rhs.stride_, result.matrix_, result.stride_);
+  FreeMemory();
+  *this = std::move(result);
+}
+
+void S21Matrix::MulMatrix(S21ConstMatrixView other) {
+  S21_STATS_SCOPE(s21_stats::Operation::kMulMatrix, rows_,
+                  std::max(cols_, other.GetCols()),
+                  2.0 * rows_ * other.GetCols() * cols_);
+  S21Matrix result(rows_, other.GetCols(), resource_);
+  s21_views::Multiply(View(), other, result.View());
+  FreeMemory();
+  *this = std::move(result);
+}
+
+void S21Matrix::MulMatrixReference(const S21Matrix& other) {
   if (cols_ != other.rows_)
     throw std::out_of_range(
         "Invalid matrix sizes: number of cols of the first matrix must be "
         "equal to the number of rows of the second matrix");
-  S21Matrix result(rows_, other.cols_);
-  for (int row = 0; row < rows_; row++) {
-    for (int col = 0; col < other.cols_; col++) {
-      for (int i = 0; i < cols_; i++) {
-        result.matrix_[row][col] += matrix_[row][i] * other.matrix_[i][col];
-      }
-    }
-  }
+  S21_STATS_SCOPE(s21_stats::Operation::kMulMatrix, rows_,
+                  std::max(cols_, other.cols_),
+                  2.0 * rows_ * other.cols_ * cols_);
+  S21Matrix result(rows_, other.cols_, resource_);
+  s21_kernels::GemmReference(rows_, other.cols_, cols_, matrix_, stride_,
+                             other.matrix_, other.stride_, result.matrix_,
+                             result.stride_);
   FreeMemory();
   *this = std::move(result);
 }
 
-S21Matrix S21Matrix::Transpose() {
-  S21Matrix result(rows_, cols_);
-  for (int row = 0; row < rows_; row++) {
-    for (int col = 0; col < cols_; col++) {
-      result.matrix_[col][row] = matrix_[row][col];
-    }
-  }
+void S21Matrix::MulMatrixStrassen(const S21Matrix& other, int crossover) {
+  if (cols_ != other.rows_)
+    throw std::out_of_range(
+        "Invalid matrix sizes: number of cols of the first matrix must be "
+        "equal to the number of rows of the second matrix");
+  if (crossover < 0)
+    throw std::invalid_argument("Strassen crossover should not be negative");
+  // Counted at the classical flop count, whatever the recursion saves.
+  S21_STATS_SCOPE(s21_stats::Operation::kMulMatrix, rows_,
+                  std::max(cols_, other.cols_),
+                  2.0 * rows_ * other.cols_ * cols_);
+  S21Matrix result(rows_, other.cols_, resource_);
+  if (crossover == 0) crossover = s21_kernels::kStrassenCrossover;
+  s21_kernels::Strassen(rows_, other.cols_, cols_, matrix_, stride_,
+                        other.matrix_, other.stride_, result.matrix_,
+                        result.stride_, crossover);
+  FreeMemory();
+  *this = std::move(result);
+}
+
+S21Matrix S21Matrix::Multiply(const S21Matrix& other) const {
+  S21Matrix result(resource_);
+  MulMatrixInto(*this, other, result);
   return result;
 }
 
-S21Matrix S21Matrix::CalcComplements() {
-  S21Matrix result(rows_, cols_);
-  if (rows_ != cols_ || rows_ <= 1 || cols_ <= 1)
-    throw std::invalid_argument("The matrix is not square");
-  for (int row = 0; row < rows_; row++) {
-    for (int col = 0; col < cols_; col++) {
-      S21Matrix minor(rows_ - 1, cols_ - 1);
-      minor = GetMinor(row, col);
-      double det = minor.Determinant();
-      result.matrix_[row][col] = det * MatrixPow(row + col);
-    }
+S21Matrix S21Matrix::Transpose() const {
+  S21Matrix result(resource_);
+  TransposeInto(*this, result);
+  return result;
+}
+
+void S21Matrix::TransposeInPlace() {
+  if (rows_ == cols_) {
+    S21_STATS_SCOPE(s21_stats::Operation::kTranspose, rows_, cols_, 0.0);
+    s21_kernels::TransposeInPlace(rows_, matrix_, stride_);
+  } else {
+    *this = Transpose();
   }
+}
+
+S21TransposedView S21Matrix::TransposedView() const {
+  return S21TransposedView(*this);
+}
+
+S21Matrix S21Matrix::CalcComplements() const {
+  S21Matrix result(resource_);
+  CalcComplementsInto(*this, result);
   return result;
 }
 
-double S21Matrix::Determinant() {
+double S21Matrix::Determinant() const {
   if (rows_ != cols_) throw std::invalid_argument("The matrix is not square");
+  S21_STATS_SCOPE(s21_stats::Operation::kDeterminant, rows_, cols_,
+                  2.0 / 3 * rows_ * rows_ * rows_);
   return DeterminantHelper();
 }
 
-S21Matrix S21Matrix::InverseMatrix() {
-  double det = Determinant();
-  if (det == 0 || (rows_ != cols_))
-    throw std::invalid_argument(
-        "Matrix determinant is 0 or matrix is not square");
-  S21Matrix result(rows_, cols_);
-  if (rows_ == 1 && cols_ == 1) {
-    result.matrix_[0][0] = 1 / matrix_[0][0];
-    return result;
-  }
-  result = CalcComplements();
-  result = result.Transpose();
-  result.MulNumber(1 / det);
+S21Matrix S21Matrix::InverseMatrix() const {
+  S21Matrix result(resource_);
+  InverseMatrixInto(*this, result);
   return result;
 }
 
-S21Matrix S21Matrix::operator+(S21Matrix& other) {
-  S21Matrix result(*this);
-  result.SumMatrix(other);
-  return result;
+S21LU S21Matrix::LU() const { return S21LU(*this); }
+
+S21Matrix S21Matrix::Solve(const S21Matrix& b) const {
+  S21_STATS_SCOPE(
+      s21_stats::Operation::kSolve, rows_, std::max(cols_, b.cols_),
+      2.0 / 3 * rows_ * rows_ * rows_ + 2.0 * rows_ * rows_ * b.cols_);
+  return LU().Solve(b);
 }
 
-S21Matrix S21Matrix::operator-(S21Matrix& other) {
-  S21Matrix result(*this);
-  result.SubMatrix(other);
-  return result;
+void S21Matrix::SumMatrixInto(const S21Matrix& a, const S21Matrix& b,
+                              S21Matrix& out) {
+  out = a + b;
 }
 
-S21Matrix S21Matrix::operator*(S21Matrix& other) {
-  S21Matrix result(*this);
-  result.MulMatrix(other);
-  return result;
+void S21Matrix::SubMatrixInto(const S21Matrix& a, const S21Matrix& b,
+                              S21Matrix& out) {
+  out = a - b;
 }
 
-S21Matrix S21Matrix::operator*(double num) {
-  S21Matrix result(*this);
-  result.MulNumber(num);
-  return result;
+void S21Matrix::MulNumberInto(const S21Matrix& a, double num,
+                              S21Matrix& out) {
+  out = a * num;
 }
 
-bool S21Matrix::operator==(S21Matrix& other) { return EqMatrix(other); }
+void S21Matrix::MulMatrixInto(const S21Matrix& a, const S21Matrix& b,
+                              S21Matrix& out) {
+  if (a.cols_ != b.rows_)
+    throw std::out_of_range(
+        "Invalid matrix sizes: number of cols of the first matrix must be "
+        "equal to the number of rows of the second matrix");
+  if (&out == &a || &out == &b) {
+    S21Matrix result(out.resource_);
+    MulMatrixInto(a, b, result);
+    out = std::move(result);
+    return;
+  }
+  S21_STATS_SCOPE(s21_stats::Operation::kMulMatrix, a.rows_,
+                  std::max(a.cols_, b.cols_),
+                  2.0 * a.rows_ * b.cols_ * a.cols_);
+  out.Reshape(a.rows_, b.cols_);
+  if (out.BufferSize())
+    std::memset(out.matrix_, 0, out.BufferSize() * sizeof(double));
+  s21_kernels::Gemm(a.rows_, b.cols_, a.cols_, a.matrix_, a.stride_,
+                    b.matrix_, b.stride_, out.matrix_, out.stride_);
+}
 
-bool S21Matrix::operator!=(S21Matrix& other) { return !EqMatrix(other); }
+void S21Matrix::TransposeInto(const S21Matrix& a, S21Matrix& out) {
+  if (&out == &a) {
+    out.TransposeInPlace();
+    return;
+  }
+  S21_STATS_SCOPE(s21_stats::Operation::kTranspose, a.rows_, a.cols_, 0.0);
+  out.Reshape(a.cols_, a.rows_);
+  s21_kernels::Transpose(a.rows_, a.cols_, a.matrix_, a.stride_, out.matrix_,
+                         out.stride_);
+}
 
-S21Matrix& S21Matrix::operator=(S21Matrix& other) {
-  if (this != &other) {
-    FreeMemory();
-    rows_ = other.rows_;
-    cols_ = other.cols_;
-    MemoryAllocation();
-    for (int i = 0; i < rows_; i++) {
-      for (int j = 0; j < cols_; j++) {
-        (*this)(i, j) = other(i, j);
+void S21Matrix::CalcComplementsInto(const S21Matrix& a, S21Matrix& out) {
+  const int n = a.rows_;
+  if (n != a.cols_ || n <= 1)
+    throw std::invalid_argument("The matrix is not square");
+  if (&out == &a) {
+    S21Matrix result(out.resource_);
+    CalcComplementsInto(a, result);
+    out = std::move(result);
+    return;
+  }
+  S21_STATS_SCOPE(s21_stats::Operation::kCalcComplements, n, n,
+                  2.0 / 3 * n * n * (n - 1.0) * (n - 1.0) * (n - 1.0));
+  out.Reshape(n, n);
+  const long minor_cost = (long)(n - 1) * (n - 1) * (n - 1) / 3;
+  S21ThreadPool::ParallelFor(n, n * (minor_cost + 1), [&](int begin, int end) {
+    // One scratch minor per task, overwritten for every element.
+    S21Matrix minor(n - 1, n - 1, out.resource_);
+    for (int row = begin; row < end; row++) {
+      for (int col = 0; col < n; col++) {
+        a.GetMinor(row, col, minor);
+        const double det = s21_views::Determinant(minor);
+        out.Row(row)[col] = (row + col) % 2 == 0 ? det : -det;
       }
     }
+  });
+}
+
+void S21Matrix::InverseMatrixInto(const S21Matrix& a, S21Matrix& out) {
+  if (a.rows_ != a.cols_ || a.rows_ == 0)
+    throw std::invalid_argument(
+        "Matrix determinant is 0 or matrix is not square");
+  S21_STATS_SCOPE(s21_stats::Operation::kInverse, a.rows_, a.cols_,
+                  2.0 * a.rows_ * a.rows_ * a.rows_);
+  const S21LU lu(a);
+  if (lu.IsSingular())
+    throw std::invalid_argument(
+        "Matrix determinant is 0 or matrix is not square");
+  lu.InverseInto(out);
+}
+
+bool S21Matrix::operator==(const S21Matrix& other) const {
+  return EqMatrix(other);
+}
+
+bool S21Matrix::operator!=(const S21Matrix& other) const {
+  return !EqMatrix(other);
+}
+
+S21Matrix& S21Matrix::operator=(const S21Matrix& other) {
+  if (this != &other) {
+    Reshape(other.rows_, other.cols_);
+    CopyElements(other);
   }
   return *this;
 }
 
 S21Matrix& S21Matrix::operator=(S21Matrix&& other) {
-  if (this != &other) {
+  // A buffer can only change owners within the same memory resource; a
+  // file mapping can always be taken over.
+  if (this != &other && !other.mapping_ &&
+      !resource_->is_equal(*other.resource_)) {
+    *this = static_cast<const S21Matrix&>(other);
+    other.FreeMemory();
+  } else if (this != &other) {
     FreeMemory();
     rows_ = std::exchange(other.rows_, 0);
     cols_ = std::exchange(other.cols_, 0);
+    stride_ = std::exchange(other.stride_, 0);
     matrix_ = std::exchange(other.matrix_, nullptr);
+    capacity_ = std::exchange(other.capacity_, 0);
+    mapping_ = std::exchange(other.mapping_, nullptr);
+    mapping_size_ = std::exchange(other.mapping_size_, 0);
   }
   return *this;
 }
 
+S21Matrix& S21Matrix::operator=(S21MatrixProduct&& product) {
+  return *this = std::move(product.result_);
+}
+
 S21Matrix& S21Matrix::operator+=(const S21Matrix& other) {
   SumMatrix(other);
   return *this;
@@ -206,19 +398,27 @@ double& S21Matrix::operator()(int row, int col) {
   if (row >= rows_ || col >= cols_) {
     throw std::out_of_range("Incorrect input, index is out of range");
   }
-  return matrix_[row][col];
+  return Row(row)[col];
 }
 
 const double& S21Matrix::operator()(int row, int col) const {
   if (row >= rows_ || col >= cols_) {
     throw std::out_of_range("Incorrect input, index is out of range");
   }
-  return matrix_[row][col];
+  return Row(row)[col];
 }
 
-int S21Matrix::GetCols() { return cols_; }
+int S21Matrix::GetCols() const { return cols_; }
+
+S21MatrixView S21Matrix::View() {
+  return S21MatrixView(matrix_, rows_, cols_, stride_);
+}
+
+S21ConstMatrixView S21Matrix::View() const {
+  return S21ConstMatrixView(matrix_, rows_, cols_, stride_);
+}
 
-int S21Matrix::GetRows() { return rows_; }
+int S21Matrix::GetRows() const { return rows_; }
 
 void S21Matrix::SetCols(int cols) { SetSize(rows_, cols); }
 
@@ -227,65 +427,190 @@ void S21Matrix::SetRows(int rows) { SetSize(rows, cols_); }
 void S21Matrix::SetSize(int rows, int cols) {
   if (rows <= 0 || cols <= 0)
     throw std::invalid_argument("Incorrect input, need rows, cols > 0");
-  S21Matrix temp(*this);
-  FreeMemory();
-  rows_ = rows;
-  cols_ = cols;
-  MemoryAllocation();
-  for (int i = 0; i < std::min(rows_, temp.rows_); i++) {
-    for (int j = 0; j < std::min(cols_, temp.cols_); j++) {
-      matrix_[i][j] = temp.matrix_[i][j];
-    }
+  Resize(rows, cols);
+}
+
+void S21Matrix::Resize(int rows, int cols) {
+  const int kept_rows = std::min(rows, rows_);
+  const int kept_cols = std::min(cols, cols_);
+  // The stride never shrinks, so narrower rows stay where they are.
+  int stride = std::max(stride_, StrideFor(cols));
+  double* buffer = matrix_;
+  std::size_t capacity = capacity_;
+  if ((std::size_t)rows * stride > capacity_) {
+    if (cols > stride_) stride = std::max(stride, 2 * stride_);
+    const int capacity_rows = rows > rows_ ? std::max(rows, 2 * rows_) : rows;
+    capacity = (std::size_t)capacity_rows * stride;
+    buffer = Allocate(capacity, rows, cols);
+  }
+  const bool moved = buffer != matrix_ || stride != stride_;
+  if (moved && kept_cols > 0) {
+    // In place the stride only grows, so rows move back, last row first.
+    for (int row = kept_rows - 1; row >= 0; row--)
+      std::memmove(buffer + (std::ptrdiff_t)row * stride, Row(row),
+                   kept_cols * sizeof(double));
   }
+  if (buffer != matrix_) {
+    FreeMemory();
+    matrix_ = buffer;
+    capacity_ = capacity;
+  }
+  // Everything right of the kept columns, row padding included, is zeroed;
+  // rows that neither moved nor changed width are already.
+  const bool widths_changed = moved || cols != cols_;
+  rows_ = rows, cols_ = cols, stride_ = stride;
+  for (int row = 0; row < kept_rows && widths_changed; row++)
+    std::fill(Row(row) + kept_cols, Row(row) + stride, 0.0);
+  for (int row = kept_rows; row < rows; row++)
+    std::fill(Row(row), Row(row) + stride, 0.0);
 }
 
-double S21Matrix::DeterminantHelper() {
-  if (rows_ == 0) return 1;
-  if (rows_ == 1) return matrix_[0][0];
-  if (rows_ == 2)
-    return matrix_[0][0] * matrix_[1][1] - matrix_[1][0] * matrix_[0][1];
-  double result = 0.0;
-  for (int col = 0; col < cols_; col++) {
-    S21Matrix minor(rows_ - 1, cols_ - 1);
-    double minor_det;
-    minor = GetMinor(0, col);
-    minor_det = minor.Determinant();
-    result += MatrixPow(col) * matrix_[0][col] * minor_det;
+void S21Matrix::AppendRow(const std::vector<double>& row) {
+  AppendRows(S21ConstMatrixView(row.data(), 1, (int)row.size(), 0));
+}
+
+void S21Matrix::AppendRows(S21ConstMatrixView rows) {
+  if (rows_ * cols_ != 0 && rows.GetCols() != cols_)
+    throw std::out_of_range("Different matrix dimensions");
+  if (rows.Data() >= matrix_ && rows.Data() < matrix_ + capacity_) {
+    // The view would not survive the reallocation.
+    AppendRows(S21Matrix(rows, resource_));
+    return;
   }
-  return result;
+  const int first = rows_;
+  Resize(rows_ + rows.GetRows(), rows.GetCols());
+  s21_views::Copy(rows, View().Submatrix(first, 0, rows.GetRows(), cols_));
 }
 
-S21Matrix S21Matrix::GetMinor(int m_row, int m_col) {
-  int i = 0, j = 0;
-  S21Matrix result(rows_ - 1, cols_ - 1);
-  for (int row = 0; row < rows_; row++) {
-    for (int col = 0; col < cols_; col++) {
-      if (row != m_row && col != m_col) {
-        result.matrix_[i][j++] = matrix_[row][col];
-        if (j == rows_ - 1) {
-          j = 0;
-          i++;
-        }
-      }
-    }
+void S21Matrix::AppendCol(const std::vector<double>& col) {
+  AppendCols(S21ConstMatrixView(col.data(), (int)col.size(), 1, 1));
+}
+
+void S21Matrix::AppendCols(S21ConstMatrixView cols) {
+  if (rows_ * cols_ != 0 && cols.GetRows() != rows_)
+    throw std::out_of_range("Different matrix dimensions");
+  if (cols.Data() >= matrix_ && cols.Data() < matrix_ + capacity_) {
+    AppendCols(S21Matrix(cols, resource_));
+    return;
+  }
+  const int first = cols_;
+  Resize(cols.GetRows(), cols_ + cols.GetCols());
+  s21_views::Copy(cols, View().Submatrix(0, first, rows_, cols.GetCols()));
+}
+
+void S21Matrix::ShrinkToFit() {
+  if (!mapping_ && capacity_ > (std::size_t)rows_ * StrideFor(cols_))
+    *this = S21Matrix(*this);
+}
+
+void S21Matrix::Reserve(int rows, int cols) {
+  if (rows < 0 || cols < 0)
+    throw std::invalid_argument("Number of rows or columns should be positive");
+  const std::size_t capacity = (std::size_t)rows * StrideFor(cols);
+  if (capacity <= capacity_) return;
+  double* buffer = Allocate(capacity, rows, cols);
+  if (BufferSize())
+    std::memcpy(buffer, matrix_, BufferSize() * sizeof(double));
+  const int rows_kept = rows_, cols_kept = cols_, stride_kept = stride_;
+  FreeMemory();
+  rows_ = rows_kept, cols_ = cols_kept, stride_ = stride_kept;
+  matrix_ = buffer;
+  capacity_ = capacity;
+}
+
+void S21Matrix::CopyElements(const S21Matrix& other) {
+  if (stride_ == other.stride_) {
+    if (BufferSize())
+      std::memcpy(matrix_, other.matrix_, BufferSize() * sizeof(double));
+  } else {
+    for (int row = 0; row < rows_; row++)
+      std::memcpy(Row(row), other.Row(row), cols_ * sizeof(double));
   }
+}
+
+void S21Matrix::Reshape(int rows, int cols) {
+  const int stride = StrideFor(cols);
+  if ((std::size_t)rows * stride > capacity_) {
+    FreeMemory();
+    rows_ = rows, cols_ = cols, stride_ = stride;
+    MemoryAllocation();
+  } else if (rows != rows_ || cols != cols_ || stride != stride_) {
+    // The callers write the elements; the padding of a reused buffer may
+    // still hold old ones.
+    rows_ = rows, cols_ = cols, stride_ = stride;
+    for (int row = 0; row < rows && cols < stride; row++)
+      std::fill(Row(row) + cols, Row(row) + stride, 0.0);
+  }
+}
+
+double S21Matrix::DeterminantHelper() const {
+  if (rows_ == 0) return 1;
+  if (rows_ == 1) return matrix_[0];
+  if (rows_ == 2) return matrix_[0] * Row(1)[1] - Row(1)[0] * matrix_[1];
+  return S21LU(*this).Determinant();
+}
+
+S21Matrix S21Matrix::GetMinor(int m_row, int m_col) const {
+  S21Matrix result(rows_ - 1, cols_ - 1, resource_);
+  GetMinor(m_row, m_col, result);
   return result;
 }
 
+void S21Matrix::GetMinor(int m_row, int m_col, S21MatrixView dst) const {
+  s21_views::Minor(View(), m_row, m_col, dst);
+}
+
+S21MatrixProduct::S21MatrixProduct(const S21Matrix& lhs,
+                                   const S21Matrix& rhs)
+    : S21MatrixProduct(lhs, false, rhs, false) {}
+
+S21MatrixProduct::S21MatrixProduct(const S21Matrix& lhs, bool lhs_transposed,
+                                   const S21Matrix& rhs, bool rhs_transposed)
+    : result_(lhs.resource_) {
+  using s21_kernels::Op;
+  const int rows = lhs_transposed ? lhs.cols_ : lhs.rows_;
+  const int inner = lhs_transposed ? lhs.rows_ : lhs.cols_;
+  const int rhs_inner = rhs_transposed ? rhs.cols_ : rhs.rows_;
+  const int cols = rhs_transposed ? rhs.rows_ : rhs.cols_;
+  if (inner != rhs_inner)
+    throw std::out_of_range(
+        "Invalid matrix sizes: number of cols of the first matrix must be "
+        "equal to the number of rows of the second matrix");
+  S21_STATS_SCOPE(s21_stats::Operation::kMulMatrix, rows,
+                  std::max(inner, cols), 2.0 * rows * cols * inner);
+  result_ = S21Matrix(rows, cols, lhs.resource_);
+  s21_kernels::Gemm(lhs_transposed ? Op::kTrans : Op::kNoTrans,
+                    rhs_transposed ? Op::kTrans : Op::kNoTrans, rows, cols,
+                    inner, lhs.matrix_, lhs.stride_, rhs.matrix_, rhs.stride_,
+                    result_.matrix_, result_.stride_);
+}
+
 int S21Matrix::MatrixPow(int value) { return value % 2 == 0 ? 1 : -1; }
 
 double S21Matrix::Fabs(double value) { return value < 0 ? -value : value; }
 
 void S21Matrix::MemoryAllocation() {
-  matrix_ = new double*[rows_];
-  for (int row = 0; row < rows_; row++) matrix_[row] = new double[cols_];
+  matrix_ = nullptr;
+  capacity_ = BufferSize();
+  if (capacity_ == 0) return;
+  matrix_ = Allocate(capacity_, rows_, cols_);
+  std::memset(matrix_, 0, BufferSize() * sizeof(double));
+}
+
+double* S21Matrix::Allocate(std::size_t capacity, [[maybe_unused]] int rows,
+                            [[maybe_unused]] int cols) {
+  S21_STATS_ALLOCATION(capacity * sizeof(double), rows, cols);
+  return static_cast<double*>(
+      resource_->allocate(capacity * sizeof(double), kAlignment));
 }
 
 void S21Matrix::FreeMemory() {
-  if (matrix_) {
-    for (int row = 0; row < rows_; row++) delete[] matrix_[row];
-    delete matrix_;
+  if (mapping_) {
+    Unmap(std::exchange(mapping_, nullptr), std::exchange(mapping_size_, 0));
+  } else if (matrix_) {
+    resource_->deallocate(matrix_, capacity_ * sizeof(double), kAlignment);
   }
-  rows_ = 0, cols_ = 0;
+  rows_ = 0, cols_ = 0, stride_ = 0;
   matrix_ = nullptr;
+  capacity_ = 0;
 }
@@ -1,38 +1,171 @@
 #ifndef SRC_S21_MATRIX_OOP_
 #define SRC_S21_MATRIX_OOP_
 
+#include <cstddef>
 #include <iostream>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "s21_matrix_memory.h"
+#include "s21_matrix_stats.h"
+#include "s21_matrix_view.h"
+#include "s21_thread_pool.h"
+
+class S21LU;
+class S21MatrixLeaf;
+class S21MatrixOwned;
+class S21MatrixProduct;
+class S21TransposedView;
+
+// Lazy expression nodes (see the operators below) that S21Matrix can be
+// constructed or assigned from.
+template <typename T>
+struct S21IsMatrixNode : std::false_type {};
 
 class S21Matrix {
+  friend class S21LU;
+  friend class S21MatrixLeaf;
+  friend class S21MatrixOwned;
+  friend class S21MatrixProduct;
+  friend class S21TransposedView;
+
  private:
-  int rows_, cols_;
-  double** matrix_;
+  // Elements live in one buffer, row-major, each row padded to stride_
+  // doubles so that every row starts on a kAlignment boundary. stride_ is
+  // StrideFor(cols_) unless resizing left spare columns.
+  static constexpr std::size_t kAlignment = 64;
+  static constexpr int kStrideStep = kAlignment / sizeof(double);
+
+  int rows_, cols_, stride_;
+  double* matrix_;
+  std::pmr::memory_resource* resource_;
+  // Doubles matrix_ points to; at least BufferSize(), more after Reserve
+  // or after shrinking.
+  std::size_t capacity_ = 0;
+  // Set when matrix_ points into a file mapping (see Map) instead of a
+  // buffer from resource_.
+  void* mapping_ = nullptr;
+  std::size_t mapping_size_ = 0;
+
+  double* Row(int row) { return matrix_ + (std::ptrdiff_t)row * stride_; }
+  const double* Row(int row) const {
+    return matrix_ + (std::ptrdiff_t)row * stride_;
+  }
+  std::size_t BufferSize() const { return (std::size_t)rows_ * stride_; }
+  static int StrideFor(int cols) {
+    return (cols + kStrideStep - 1) / kStrideStep * kStrideStep;
+  }
+  // Gives the matrix the shape rows x cols with unspecified elements and
+  // zeroed row padding, reallocating only when the capacity is too small.
+  void Reshape(int rows, int cols);
+  // SetSize without the argument checks.
+  void Resize(int rows, int cols);
+  // Elements of a matrix with the same shape.
+  void CopyElements(const S21Matrix& other);
+  // Counts an elementwise expression as the operation at its root, then
+  // assigns it.
+  template <typename E>
+  void Evaluate(const E& expr);
+  template <typename E>
+  void Assign(const E& expr);
+  template <typename E>
+  void EvaluateRows(const E& expr);
+  static void Unmap(void* mapping, std::size_t size);
 
  public:
+  // Buffers come from resource, by default S21SmallBlockPool. Copies,
+  // moves and every matrix an operation derives from this one use the same
+  // resource; assignment keeps the resource of the target.
   S21Matrix();
   S21Matrix(int rows, int cols);
+  explicit S21Matrix(std::pmr::memory_resource* resource);
+  S21Matrix(int rows, int cols, std::pmr::memory_resource* resource);
   S21Matrix(const S21Matrix& other);
+  S21Matrix(const S21Matrix& other, std::pmr::memory_resource* resource);
   S21Matrix(S21Matrix&& other);
+  template <typename E,
+            typename = std::enable_if_t<S21IsMatrixNode<E>::value>>
+  S21Matrix(const E& expr);
+  S21Matrix(S21MatrixProduct&& product);
+  // Copies the elements a view refers to.
+  explicit S21Matrix(
+      S21ConstMatrixView view,
+      std::pmr::memory_resource* resource = S21SmallBlockPool::Instance());
   ~S21Matrix();
 
-  bool EqMatrix(const S21Matrix& other);
+  bool EqMatrix(const S21Matrix& other) const;
+  bool EqMatrix(S21ConstMatrixView other) const;
   void SumMatrix(const S21Matrix& other);
+  void SumMatrix(S21ConstMatrixView other);
   void SubMatrix(const S21Matrix& other);
+  void SubMatrix(S21ConstMatrixView other);
   void MulNumber(const double num);
   void MulMatrix(const S21Matrix& other);
-  S21Matrix Transpose();
-  S21Matrix CalcComplements();
-  double Determinant();
-  S21Matrix InverseMatrix();
-
-  S21Matrix operator+(S21Matrix& other);
-  S21Matrix operator-(S21Matrix& other);
-  S21Matrix operator*(S21Matrix& other);
-  S21Matrix operator*(double num);
-  bool operator==(S21Matrix& other);
-  bool operator!=(S21Matrix& other);
-  S21Matrix& operator=(S21Matrix& other);
+  void MulMatrix(const S21TransposedView& other);
+  void MulMatrix(S21ConstMatrixView other);
+  void MulMatrixReference(const S21Matrix& other);
+  // Opt-in Strassen-Winograd product for large matrices; see
+  // s21_kernels::Strassen for when it pays off and what it costs in
+  // accuracy. crossover 0 selects the tuned default.
+  void MulMatrixStrassen(const S21Matrix& other, int crossover = 0);
+  // The product this * other as a new matrix, leaving this unchanged.
+  S21Matrix Multiply(const S21Matrix& other) const;
+  S21Matrix Transpose() const;
+  // Square matrices are transposed without allocating; other shapes are
+  // replaced by Transpose().
+  void TransposeInPlace();
+  // Zero-copy view of the transpose; valid while this matrix is alive and
+  // unchanged.
+  S21TransposedView TransposedView() const;
+  S21Matrix CalcComplements() const;
+  double Determinant() const;
+  S21Matrix InverseMatrix() const;
+  S21LU LU() const;
+  S21Matrix Solve(const S21Matrix& b) const;
+
+  // The operations above with the result written to out, whose buffer is
+  // reused whenever its capacity fits the result, and GEMM keeps its
+  // packing buffers per thread, so loops over fixed shapes do not allocate
+  // once warmed up. Work split between threads still allocates the task
+  // records of the thread pool. out may also be an operand: the
+  // elementwise operations then work in place, the others go through a
+  // temporary. InverseMatrixInto still allocates its factorization;
+  // S21LU::Factor and S21LU::InverseInto avoid that too.
+  static void SumMatrixInto(const S21Matrix& a, const S21Matrix& b,
+                            S21Matrix& out);
+  static void SubMatrixInto(const S21Matrix& a, const S21Matrix& b,
+                            S21Matrix& out);
+  static void MulNumberInto(const S21Matrix& a, double num, S21Matrix& out);
+  static void MulMatrixInto(const S21Matrix& a, const S21Matrix& b,
+                            S21Matrix& out);
+  static void TransposeInto(const S21Matrix& a, S21Matrix& out);
+  static void CalcComplementsInto(const S21Matrix& a, S21Matrix& out);
+  static void InverseMatrixInto(const S21Matrix& a, S21Matrix& out);
+
+  // Binary files; the format is described in s21_matrix_io.h. Load reads
+  // the elements into a new buffer and checks the checksum. Map opens the
+  // file copy-on-write with mmap instead: nothing is read until an element
+  // is touched, and changes to the matrix never reach the file.
+  void Save(const std::string& path) const;
+  static S21Matrix Load(
+      const std::string& path,
+      std::pmr::memory_resource* resource = S21SmallBlockPool::Instance());
+  static S21Matrix Map(
+      const std::string& path, bool verify_checksum = false,
+      std::pmr::memory_resource* resource = S21SmallBlockPool::Instance());
+
+  bool operator==(const S21Matrix& other) const;
+  bool operator!=(const S21Matrix& other) const;
+  S21Matrix& operator=(const S21Matrix& other);
   S21Matrix& operator=(S21Matrix&& other);
+  template <typename E,
+            typename = std::enable_if_t<S21IsMatrixNode<E>::value>>
+  S21Matrix& operator=(const E& expr);
+  S21Matrix& operator=(S21MatrixProduct&& product);
   S21Matrix& operator+=(const S21Matrix& other);
   S21Matrix& operator-=(const S21Matrix& other);
   S21Matrix& operator*=(const S21Matrix& other);
@@ -40,17 +173,385 @@ class S21Matrix {
   double& operator()(int row, int col);
   const double& operator()(int row, int col) const;
 
-  int GetCols();
-  int GetRows();
+  int GetCols() const;
+  int GetRows() const;
+  // Views of the whole matrix; see S21BasicMatrixView for slicing. They
+  // are invalidated by anything that reallocates the matrix.
+  S21MatrixView View();
+  S21ConstMatrixView View() const;
+  operator S21MatrixView() { return View(); }
+  operator S21ConstMatrixView() const { return View(); }
+  std::pmr::memory_resource* GetResource() const { return resource_; }
+  // Keep the elements that still fit and zero the new ones. Shrinking
+  // keeps the buffer; growing past the capacity grows it geometrically in
+  // both directions, like std::vector.
   void SetCols(int cols);
   void SetRows(int rows);
   void SetSize(int rows, int cols);
-  double DeterminantHelper();
-  S21Matrix GetMinor(int m_row, int m_col);
+  // Append the rows of a view below the last row, or its columns after the
+  // last column; an empty matrix takes the shape of the view. Appending k
+  // rows costs O(k * cols) amortized, k columns O(k * rows).
+  void AppendRow(const std::vector<double>& row);
+  void AppendRows(S21ConstMatrixView rows);
+  void AppendCol(const std::vector<double>& col);
+  void AppendCols(S21ConstMatrixView cols);
+  // Releases the spare rows and columns.
+  void ShrinkToFit();
+  // Makes room for rows x cols elements, so that SetSize and the *Into
+  // operations up to that shape keep the buffer. Never shrinks it.
+  void Reserve(int rows, int cols);
+  // Doubles the buffer holds, row padding included.
+  std::size_t GetCapacity() const { return capacity_; }
+  double DeterminantHelper() const;
+  S21Matrix GetMinor(int m_row, int m_col) const;
+  // Writes the minor into dst, which must be (rows - 1) x (cols - 1).
+  void GetMinor(int m_row, int m_col, S21MatrixView dst) const;
   int MatrixPow(int value);
   double Fabs(double value);
   void MemoryAllocation();
+  // capacity doubles from resource_ for a rows x cols matrix; every buffer
+  // is allocated here, so that the stats count it.
+  double* Allocate(std::size_t capacity, int rows, int cols);
   void FreeMemory();
 };
 
+// Transpose of an S21Matrix that is never materialized: MulMatrix and the
+// product operators read the underlying matrix column-wise instead.
+class S21TransposedView {
+ public:
+  explicit S21TransposedView(const S21Matrix& matrix) : matrix_(&matrix) {}
+
+  int GetRows() const { return matrix_->cols_; }
+  int GetCols() const { return matrix_->rows_; }
+  const double& operator()(int row, int col) const {
+    return (*matrix_)(col, row);
+  }
+  const S21Matrix& Transposed() const { return *matrix_; }
+  S21Matrix ToMatrix() const { return matrix_->Transpose(); }
+
+ private:
+  const S21Matrix* matrix_;
+};
+
+// Partially pivoted LU factorization PA = LU of a square matrix. L (unit
+// diagonal, not stored) and U share one packed matrix.
+class S21LU {
+ public:
+  explicit S21LU(const S21Matrix& matrix);
+  // Factors another matrix in the storage of this one.
+  void Factor(const S21Matrix& matrix);
+
+  int GetSize() const { return lu_.rows_; }
+  // A pivot fell within s21_views::SingularTolerance of zero; Solve and
+  // Inverse then throw.
+  bool IsSingular() const { return singular_; }
+  // The signed product of the pivots, 0 only for an exactly zero one.
+  double Determinant() const;
+  // Solves A * X = B for every column of B.
+  S21Matrix Solve(const S21Matrix& b) const;
+  S21Matrix Inverse() const;
+  // Solve and Inverse into a caller's matrix, reusing its buffer.
+  void SolveInto(const S21Matrix& b, S21Matrix& x) const;
+  void InverseInto(S21Matrix& out) const;
+  const S21Matrix& Packed() const { return lu_; }
+  // Row i of PA is row Pivots()[i] of A.
+  const std::vector<int>& Pivots() const { return pivots_; }
+
+ private:
+  // Forward and back substitution on the already permuted x.
+  void Substitute(S21Matrix& x) const;
+
+  S21Matrix lu_;
+  std::vector<int> pivots_;
+  int sign_;
+  bool singular_;
+};
+
+// Expression templates. operator+, operator- and scaling by a number build
+// nodes that hold their operands (lvalue matrices by reference, temporaries
+// and nodes by value); assigning a node to an S21Matrix evaluates the whole
+// chain in a single pass. Matrix products are computed eagerly with the
+// GEMM kernel when the node is built and then act as an operand. Nodes
+// refer to the lvalue matrices they were built from, so they should not
+// outlive the full expression.
+//
+// Every node can offer a buffer it owns (a temporary operand or a product
+// result) through Reusable(); a new matrix is evaluated into that buffer
+// instead of allocating its own. kElementOps counts the elementwise nodes
+// of an expression, leaves and products included as none.
+class S21MatrixLeaf {
+ public:
+  static constexpr int kElementOps = 0;
+
+  explicit S21MatrixLeaf(const S21Matrix& matrix) : matrix_(&matrix) {}
+
+  int GetRows() const { return matrix_->rows_; }
+  int GetCols() const { return matrix_->cols_; }
+  std::pmr::memory_resource* GetResource() const { return matrix_->resource_; }
+  const double* ReadRow(int row) const { return matrix_->Row(row); }
+  S21Matrix* Reusable() const { return nullptr; }
+
+ private:
+  const S21Matrix* matrix_;
+};
+
+class S21MatrixOwned {
+ public:
+  static constexpr int kElementOps = 0;
+
+  explicit S21MatrixOwned(S21Matrix&& matrix) : matrix_(std::move(matrix)) {}
+
+  int GetRows() const { return matrix_.rows_; }
+  int GetCols() const { return matrix_.cols_; }
+  std::pmr::memory_resource* GetResource() const { return matrix_.resource_; }
+  const double* ReadRow(int row) const { return matrix_.Row(row); }
+  S21Matrix* Reusable() const { return &matrix_; }
+
+ private:
+  mutable S21Matrix matrix_;
+};
+
+class S21MatrixProduct {
+  friend class S21Matrix;
+  friend const S21Matrix& S21Materialize(const S21MatrixProduct& product);
+
+ public:
+  // Counted as MulMatrix when it is built.
+  static constexpr int kElementOps = 0;
+
+  S21MatrixProduct(const S21Matrix& lhs, const S21Matrix& rhs);
+  // op(lhs) * op(rhs), where op transposes the operands that are flagged.
+  S21MatrixProduct(const S21Matrix& lhs, bool lhs_transposed,
+                   const S21Matrix& rhs, bool rhs_transposed);
+
+  int GetRows() const { return result_.rows_; }
+  int GetCols() const { return result_.cols_; }
+  std::pmr::memory_resource* GetResource() const { return result_.resource_; }
+  const double* ReadRow(int row) const { return result_.Row(row); }
+  S21Matrix* Reusable() const { return &result_; }
+
+ private:
+  mutable S21Matrix result_;
+};
+
+struct S21PlusOp {
+  static constexpr s21_stats::Operation kOperation = s21_stats::Operation::kSum;
+  static double Apply(double lhs, double rhs) { return lhs + rhs; }
+};
+
+struct S21MinusOp {
+  static constexpr s21_stats::Operation kOperation = s21_stats::Operation::kSub;
+  static double Apply(double lhs, double rhs) { return lhs - rhs; }
+};
+
+template <typename L, typename R, typename Op>
+class S21MatrixBinary {
+ public:
+  static constexpr s21_stats::Operation kOperation = Op::kOperation;
+  static constexpr int kElementOps = 1 + L::kElementOps + R::kElementOps;
+
+  S21MatrixBinary(L lhs, R rhs) : lhs_(std::move(lhs)), rhs_(std::move(rhs)) {
+    if (lhs_.GetRows() != rhs_.GetRows() || lhs_.GetCols() != rhs_.GetCols())
+      throw std::out_of_range("Different matrix dimensions");
+  }
+
+  int GetRows() const { return lhs_.GetRows(); }
+  int GetCols() const { return lhs_.GetCols(); }
+  std::pmr::memory_resource* GetResource() const {
+    return lhs_.GetResource();
+  }
+
+  struct RowReader {
+    decltype(std::declval<const L&>().ReadRow(0)) lhs;
+    decltype(std::declval<const R&>().ReadRow(0)) rhs;
+    double operator[](int col) const { return Op::Apply(lhs[col], rhs[col]); }
+  };
+  RowReader ReadRow(int row) const {
+    return {lhs_.ReadRow(row), rhs_.ReadRow(row)};
+  }
+  S21Matrix* Reusable() const {
+    S21Matrix* buffer = lhs_.Reusable();
+    return buffer ? buffer : rhs_.Reusable();
+  }
+
+ private:
+  L lhs_;
+  R rhs_;
+};
+
+template <typename E>
+class S21MatrixScaled {
+ public:
+  static constexpr s21_stats::Operation kOperation =
+      s21_stats::Operation::kMulNumber;
+  static constexpr int kElementOps = 1 + E::kElementOps;
+
+  S21MatrixScaled(E expr, double num) : expr_(std::move(expr)), num_(num) {}
+
+  int GetRows() const { return expr_.GetRows(); }
+  int GetCols() const { return expr_.GetCols(); }
+  std::pmr::memory_resource* GetResource() const {
+    return expr_.GetResource();
+  }
+
+  struct RowReader {
+    decltype(std::declval<const E&>().ReadRow(0)) expr;
+    double num;
+    double operator[](int col) const { return expr[col] * num; }
+  };
+  RowReader ReadRow(int row) const { return {expr_.ReadRow(row), num_}; }
+  S21Matrix* Reusable() const { return expr_.Reusable(); }
+
+ private:
+  E expr_;
+  double num_;
+};
+
+template <>
+struct S21IsMatrixNode<S21MatrixProduct> : std::true_type {};
+template <typename L, typename R, typename Op>
+struct S21IsMatrixNode<S21MatrixBinary<L, R, Op>> : std::true_type {};
+template <typename E>
+struct S21IsMatrixNode<S21MatrixScaled<E>> : std::true_type {};
+
+template <typename T>
+struct S21IsMatrixOperand
+    : std::integral_constant<bool, std::is_same<T, S21Matrix>::value ||
+                                       S21IsMatrixNode<T>::value> {};
+
+// Lvalue matrices become leaves, expiring matrices are moved into the
+// expression, nodes are stored by value.
+template <typename T>
+struct S21Operand {
+  using Type = std::decay_t<T>;
+};
+template <>
+struct S21Operand<S21Matrix&> {
+  using Type = S21MatrixLeaf;
+};
+template <>
+struct S21Operand<const S21Matrix&> {
+  using Type = S21MatrixLeaf;
+};
+template <>
+struct S21Operand<const S21Matrix> {
+  using Type = S21MatrixLeaf;
+};
+template <>
+struct S21Operand<S21Matrix> {
+  using Type = S21MatrixOwned;
+};
+template <typename T>
+using S21OperandT = typename S21Operand<T>::Type;
+
+template <typename L, typename R>
+using S21EnableIfOperands =
+    std::enable_if_t<S21IsMatrixOperand<std::decay_t<L>>::value &&
+                     S21IsMatrixOperand<std::decay_t<R>>::value>;
+
+inline const S21Matrix& S21Materialize(const S21Matrix& matrix) {
+  return matrix;
+}
+inline const S21Matrix& S21Materialize(const S21MatrixProduct& product) {
+  return product.result_;
+}
+template <typename E>
+S21Matrix S21Materialize(const E& expr) {
+  return S21Matrix(expr);
+}
+
+template <typename L, typename R, typename = S21EnableIfOperands<L, R>>
+S21MatrixBinary<S21OperandT<L>, S21OperandT<R>, S21PlusOp> operator+(
+    L&& lhs, R&& rhs) {
+  return {S21OperandT<L>(std::forward<L>(lhs)),
+          S21OperandT<R>(std::forward<R>(rhs))};
+}
+
+template <typename L, typename R, typename = S21EnableIfOperands<L, R>>
+S21MatrixBinary<S21OperandT<L>, S21OperandT<R>, S21MinusOp> operator-(
+    L&& lhs, R&& rhs) {
+  return {S21OperandT<L>(std::forward<L>(lhs)),
+          S21OperandT<R>(std::forward<R>(rhs))};
+}
+
+template <typename E, typename = S21EnableIfOperands<E, E>>
+S21MatrixScaled<S21OperandT<E>> operator*(E&& expr, double num) {
+  return {S21OperandT<E>(std::forward<E>(expr)), num};
+}
+
+template <typename E, typename = S21EnableIfOperands<E, E>>
+S21MatrixScaled<S21OperandT<E>> operator*(double num, E&& expr) {
+  return {S21OperandT<E>(std::forward<E>(expr)), num};
+}
+
+template <typename L, typename R, typename = S21EnableIfOperands<L, R>>
+S21MatrixProduct operator*(L&& lhs, R&& rhs) {
+  return S21MatrixProduct(S21Materialize(lhs), S21Materialize(rhs));
+}
+
+template <typename L, typename = S21EnableIfOperands<L, L>>
+S21MatrixProduct operator*(L&& lhs, const S21TransposedView& rhs) {
+  return S21MatrixProduct(S21Materialize(lhs), false, rhs.Transposed(), true);
+}
+
+template <typename R, typename = S21EnableIfOperands<R, R>>
+S21MatrixProduct operator*(const S21TransposedView& lhs, R&& rhs) {
+  return S21MatrixProduct(lhs.Transposed(), true, S21Materialize(rhs), false);
+}
+
+inline S21MatrixProduct operator*(const S21TransposedView& lhs,
+                                  const S21TransposedView& rhs) {
+  return S21MatrixProduct(lhs.Transposed(), true, rhs.Transposed(), true);
+}
+
+template <typename E, typename>
+S21Matrix::S21Matrix(const E& expr) : S21Matrix(expr.GetResource()) {
+  Evaluate(expr);
+}
+
+template <typename E, typename>
+S21Matrix& S21Matrix::operator=(const E& expr) {
+  Evaluate(expr);
+  return *this;
+}
+
+template <typename E>
+void S21Matrix::Evaluate(const E& expr) {
+  if constexpr (E::kElementOps > 0) {
+    S21_STATS_SCOPE(E::kOperation, expr.GetRows(), expr.GetCols(),
+                    (double)E::kElementOps * expr.GetRows() * expr.GetCols());
+    Assign(expr);
+  } else {
+    Assign(expr);
+  }
+}
+
+template <typename E>
+void S21Matrix::Assign(const E& expr) {
+  // Elementwise nodes only read the element they produce, so the target may
+  // also appear as an operand; a shape change means it cannot.
+  const int rows = expr.GetRows(), cols = expr.GetCols();
+  if (rows_ != rows || cols_ != cols) {
+    S21Matrix* buffer = expr.Reusable();
+    if (buffer && (std::size_t)rows * StrideFor(cols) > capacity_) {
+      buffer->EvaluateRows(expr);
+      *this = std::move(*buffer);
+      return;
+    }
+    Reshape(rows, cols);
+  }
+  EvaluateRows(expr);
+}
+
+template <typename E>
+void S21Matrix::EvaluateRows(const E& expr) {
+  S21ThreadPool::ParallelFor(rows_, cols_, [this, &expr](int begin, int end) {
+    for (int row = begin; row < end; row++) {
+      const auto reader = expr.ReadRow(row);
+      double* dst = Row(row);
+      for (int col = 0; col < cols_; col++) dst[col] = reader[col];
+    }
+  });
+}
+
 #endif  // SRC_S21_MATRIX_OOP_
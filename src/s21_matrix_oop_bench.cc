@@ -0,0 +1,677 @@
+#include <benchmark/benchmark.h>
+
+#include <complex>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+#include "s21_basic_matrix.h"
+#include "s21_inverse_tracker.h"
+#include "s21_matrix_batch.h"
+#include "s21_matrix_eigen.h"
+#include "s21_matrix_file.h"
+#include "s21_matrix_oop.h"
+#include "s21_matrix_solvers.h"
+#include "s21_sparse_matrix.h"
+#include "s21_vector.h"
+
+namespace {
+
+constexpr long kDoubleBytes = sizeof(double);
+
+S21Matrix Filled(int rows, int cols, int seed) {
+  S21Matrix matrix(rows, cols);
+  for (int i = 0; i < rows; i++)
+    for (int j = 0; j < cols; j++)
+      matrix(i, j) = ((i * 31 + j * 17 + seed) % 23) / 7.0 - 1.5;
+  return matrix;
+}
+
+// Diagonally dominant, so that LU never meets a zero pivot.
+S21Matrix Invertible(int size) {
+  S21Matrix matrix = Filled(size, size, 5);
+  for (int i = 0; i < size; i++) matrix(i, i) += size;
+  return matrix;
+}
+
+// Reports FLOP/s and bytes/s from per-iteration counts.
+void SetRates(benchmark::State& state, double flops, double bytes) {
+  state.counters["FLOP/s"] =
+      benchmark::Counter(flops, benchmark::Counter::kIsIterationInvariantRate,
+                         benchmark::Counter::OneK::kIs1000);
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+}
+
+void BM_MulMatrix(benchmark::State& state) {
+  const int n = state.range(0);
+  S21Matrix a = Filled(n, n, 1);
+  S21Matrix b = Filled(n, n, 2);
+  for (auto _ : state) {
+    S21Matrix c(a);
+    c.MulMatrix(b);
+    benchmark::DoNotOptimize(c(0, 0));
+  }
+  SetRates(state, 2.0 * n * n * n, 3.0 * n * n * kDoubleBytes);
+}
+BENCHMARK(BM_MulMatrix)->RangeMultiplier(4)->Range(1, 1024)->Arg(2048);
+
+void BM_MulMatrixInto(benchmark::State& state) {
+  const int n = state.range(0);
+  S21Matrix a = Filled(n, n, 1);
+  S21Matrix b = Filled(n, n, 2);
+  S21Matrix c(n, n);
+  for (auto _ : state) {
+    S21Matrix::MulMatrixInto(a, b, c);
+    benchmark::DoNotOptimize(c(0, 0));
+  }
+  SetRates(state, 2.0 * n * n * n, 3.0 * n * n * kDoubleBytes);
+}
+BENCHMARK(BM_MulMatrixInto)->RangeMultiplier(4)->Range(1, 1024);
+
+template <typename T>
+void BM_GenericMulMatrix(benchmark::State& state) {
+  const int n = state.range(0);
+  const S21Matrix a = Filled(n, n, 1), b = Filled(n, n, 2);
+  const S21GenericMatrix<T> lhs(a.View()), rhs(b.View());
+  for (auto _ : state) {
+    S21GenericMatrix<T> c = lhs * rhs;
+    benchmark::DoNotOptimize(c(0, 0));
+  }
+  SetRates(state, 2.0 * n * n * n, 3.0 * n * n * sizeof(T));
+}
+BENCHMARK_TEMPLATE(BM_GenericMulMatrix, float)
+    ->RangeMultiplier(4)
+    ->Range(16, 1024);
+BENCHMARK_TEMPLATE(BM_GenericMulMatrix, double)
+    ->RangeMultiplier(4)
+    ->Range(16, 1024);
+// Counted at 2 n^3 flops like the real types, though it runs four real
+// products.
+BENCHMARK_TEMPLATE(BM_GenericMulMatrix, std::complex<double>)
+    ->RangeMultiplier(4)
+    ->Range(16, 1024);
+
+void BM_MulMatrixStrassen(benchmark::State& state) {
+  const int n = state.range(0);
+  S21Matrix a = Filled(n, n, 1);
+  S21Matrix b = Filled(n, n, 2);
+  for (auto _ : state) {
+    S21Matrix c(a);
+    c.MulMatrixStrassen(b, state.range(1));
+    benchmark::DoNotOptimize(c(0, 0));
+  }
+  // Rates count the classical 2n^3, so they compare directly with Gemm.
+  SetRates(state, 2.0 * n * n * n, 3.0 * n * n * kDoubleBytes);
+}
+BENCHMARK(BM_MulMatrixStrassen)
+    ->ArgsProduct({{1024, 2048, 4096}, {128, 256, 512}});
+
+void BM_MulMatrixTransposed(benchmark::State& state) {
+  const int n = state.range(0);
+  S21Matrix a = Filled(n, n, 1);
+  S21Matrix b = Filled(n, n, 2);
+  for (auto _ : state) {
+    S21Matrix c(a);
+    c.MulMatrix(b.TransposedView());
+    benchmark::DoNotOptimize(c(0, 0));
+  }
+  SetRates(state, 2.0 * n * n * n, 3.0 * n * n * kDoubleBytes);
+}
+BENCHMARK(BM_MulMatrixTransposed)->RangeMultiplier(4)->Range(1, 1024);
+
+void BM_MulMatrixReference(benchmark::State& state) {
+  const int n = state.range(0);
+  S21Matrix a = Filled(n, n, 1);
+  S21Matrix b = Filled(n, n, 2);
+  for (auto _ : state) {
+    S21Matrix c(a);
+    c.MulMatrixReference(b);
+    benchmark::DoNotOptimize(c(0, 0));
+  }
+  SetRates(state, 2.0 * n * n * n, 3.0 * n * n * kDoubleBytes);
+}
+BENCHMARK(BM_MulMatrixReference)->RangeMultiplier(4)->Range(1, 512);
+
+void BM_Transpose(benchmark::State& state) {
+  const int n = state.range(0);
+  S21Matrix a = Filled(n, n, 1);
+  for (auto _ : state) {
+    S21Matrix t = a.Transpose();
+    benchmark::DoNotOptimize(t(0, 0));
+  }
+  SetRates(state, 0, 2.0 * n * n * kDoubleBytes);
+}
+BENCHMARK(BM_Transpose)->RangeMultiplier(4)->Range(1, 4096);
+
+void BM_TransposeInPlace(benchmark::State& state) {
+  const int n = state.range(0);
+  S21Matrix a = Filled(n, n, 1);
+  for (auto _ : state) {
+    a.TransposeInPlace();
+    benchmark::DoNotOptimize(a(0, 0));
+  }
+  SetRates(state, 0, 2.0 * n * n * kDoubleBytes);
+}
+BENCHMARK(BM_TransposeInPlace)->RangeMultiplier(4)->Range(1, 4096);
+
+void BM_Determinant(benchmark::State& state) {
+  const int n = state.range(0);
+  S21Matrix a = Invertible(n);
+  for (auto _ : state) benchmark::DoNotOptimize(a.Determinant());
+  SetRates(state, 2.0 / 3.0 * n * n * n, 2.0 * n * n * kDoubleBytes);
+}
+BENCHMARK(BM_Determinant)->RangeMultiplier(4)->Range(1, 1024);
+
+void BM_InverseMatrix(benchmark::State& state) {
+  const int n = state.range(0);
+  S21Matrix a = Invertible(n);
+  for (auto _ : state) {
+    S21Matrix inverse = a.InverseMatrix();
+    benchmark::DoNotOptimize(inverse(0, 0));
+  }
+  SetRates(state, 2.0 * n * n * n, 3.0 * n * n * kDoubleBytes);
+}
+BENCHMARK(BM_InverseMatrix)->RangeMultiplier(4)->Range(1, 1024);
+
+// One changed row per iteration, the update BM_InverseMatrix replaces.
+void BM_InverseTrackerSetRow(benchmark::State& state) {
+  const int n = state.range(0);
+  S21InverseTracker tracker(Invertible(n));
+  const S21Vector row(Invertible(n).View().Row(n / 2));
+  S21Vector changed(row);
+  int iteration = 0;
+  for (auto _ : state) {
+    changed(iteration++ % n) += 0.5;
+    tracker.SetRow(n / 2, changed);
+    benchmark::DoNotOptimize(tracker.Determinant());
+  }
+  SetRates(state, 6.0 * n * n, 3.0 * n * n * kDoubleBytes);
+}
+BENCHMARK(BM_InverseTrackerSetRow)->RangeMultiplier(4)->Range(16, 1024);
+
+// Rank-k updates of a 1024 x 1024 inverse.
+void BM_InverseTrackerUpdate(benchmark::State& state) {
+  const int n = 1024, k = state.range(0);
+  S21InverseTracker tracker(Invertible(n));
+  S21Matrix u = Filled(n, k, 1), v = Filled(n, k, 2);
+  u.MulNumber(1e-3);
+  for (auto _ : state) {
+    tracker.Update(u, v);
+    benchmark::DoNotOptimize(tracker.Determinant());
+    v.MulNumber(-1.0);
+  }
+  SetRates(state, 6.0 * n * n * k, 3.0 * n * n * kDoubleBytes);
+}
+BENCHMARK(BM_InverseTrackerUpdate)->RangeMultiplier(4)->Range(1, 64);
+
+// Solving through the inverse, the way the solvers below replace.
+void BM_SolveByInverse(benchmark::State& state) {
+  const int n = state.range(0);
+  S21Matrix a = Invertible(n);
+  S21Matrix b = Filled(n, 8, 3);
+  for (auto _ : state) {
+    S21Matrix x = a.InverseMatrix() * b;
+    benchmark::DoNotOptimize(x(0, 0));
+  }
+  SetRates(state, 8.0 / 3 * n * n * n, 1.0 * n * n * kDoubleBytes);
+}
+BENCHMARK(BM_SolveByInverse)->RangeMultiplier(4)->Range(16, 1024);
+
+void BM_CholeskySolve(benchmark::State& state) {
+  const int n = state.range(0);
+  S21Matrix a = Invertible(n);
+  a += a.Transpose();
+  S21Matrix b = Filled(n, 8, 3);
+  for (auto _ : state) {
+    S21Matrix x = S21Cholesky(a).Solve(b);
+    benchmark::DoNotOptimize(x(0, 0));
+  }
+  SetRates(state, 1.0 / 3 * n * n * n + 32.0 * n * n,
+           1.0 * n * n * kDoubleBytes);
+}
+BENCHMARK(BM_CholeskySolve)->RangeMultiplier(4)->Range(16, 1024)->Arg(2048);
+
+void BM_QRSolve(benchmark::State& state) {
+  const int n = state.range(0);
+  S21Matrix a = Invertible(n);
+  S21Matrix b = Filled(n, 8, 3);
+  for (auto _ : state) {
+    S21Matrix x = S21QR(a).Solve(b);
+    benchmark::DoNotOptimize(x(0, 0));
+  }
+  SetRates(state, 4.0 / 3 * n * n * n, 1.0 * n * n * kDoubleBytes);
+}
+BENCHMARK(BM_QRSolve)->RangeMultiplier(4)->Range(16, 1024);
+
+// Iterations are bounded by the tolerance; the rates are per solve.
+void BM_ConjugateGradient(benchmark::State& state) {
+  const int n = state.range(0);
+  S21Matrix a = Invertible(n);
+  a += a.Transpose();
+  const S21Vector b(Filled(n, 1, 3).View());
+  s21_solvers::Options options;
+  options.tolerance = 1e-8;
+  int iterations = 0;
+  for (auto _ : state) {
+    S21Vector x;
+    iterations = s21_solvers::ConjugateGradient(
+                     s21_solvers::MatrixOperator(a), b, x, options,
+                     s21_solvers::Jacobi(a))
+                     .iterations;
+    benchmark::DoNotOptimize(x.Data());
+  }
+  state.counters["iterations"] = iterations;
+  SetRates(state, 2.0 * iterations * n * n,
+           1.0 * iterations * n * n * kDoubleBytes);
+}
+BENCHMARK(BM_ConjugateGradient)->RangeMultiplier(4)->Range(64, 4096);
+
+void BM_Gmres(benchmark::State& state) {
+  const int n = state.range(0);
+  const S21Matrix a = Invertible(n);
+  const S21Vector b(Filled(n, 1, 3).View());
+  s21_solvers::Options options;
+  options.tolerance = 1e-8;
+  int iterations = 0;
+  for (auto _ : state) {
+    S21Vector x;
+    iterations =
+        s21_solvers::Gmres(s21_solvers::MatrixOperator(a), b, x, options)
+            .iterations;
+    benchmark::DoNotOptimize(x.Data());
+  }
+  state.counters["iterations"] = iterations;
+  SetRates(state, 2.0 * iterations * n * n,
+           1.0 * iterations * n * n * kDoubleBytes);
+}
+BENCHMARK(BM_Gmres)->RangeMultiplier(4)->Range(64, 4096);
+
+// The flop counts are those of the reductions and back-transformations;
+// divide and conquer adds up to as much again, less with deflation.
+void BM_SymmetricEigen(benchmark::State& state) {
+  const int n = state.range(0), vectors = state.range(1);
+  S21Matrix a = Invertible(n);
+  a += a.Transpose();
+  for (auto _ : state) {
+    const S21SymmetricEigen eigen(a, vectors);
+    benchmark::DoNotOptimize(eigen.Values().data());
+  }
+  SetRates(state, (vectors ? 4.0 / 3 + 2.0 : 4.0 / 3) * n * n * n,
+           1.0 * n * n * kDoubleBytes);
+}
+BENCHMARK(BM_SymmetricEigen)
+    ->ArgsProduct({{64, 256, 1024, 2048}, {0, 1}});
+
+void BM_Svd(benchmark::State& state) {
+  const int n = state.range(0), vectors = state.range(1);
+  const S21Matrix a = Invertible(n);
+  for (auto _ : state) {
+    const S21SVD svd(a, vectors);
+    benchmark::DoNotOptimize(svd.Values().data());
+  }
+  SetRates(state, (vectors ? 8.0 / 3 + 4.0 : 8.0 / 3) * n * n * n,
+           1.0 * n * n * kDoubleBytes);
+}
+BENCHMARK(BM_Svd)
+    ->ArgsProduct({{64, 256, 1024, 2048}, {0, 1}});
+
+// Top singular triplets of a 2048 x 2048 matrix, against the full
+// decomposition of BM_Svd: six products of A with rank + 10 vectors.
+void BM_RandomizedSvd(benchmark::State& state) {
+  const int n = 2048, rank = state.range(0);
+  const S21Matrix a = Invertible(n);
+  for (auto _ : state) {
+    const S21SVD svd = S21SVD::Randomized(a, rank);
+    benchmark::DoNotOptimize(svd.Values().data());
+  }
+  SetRates(state, 12.0 * n * n * (rank + 10.0), 6.0 * n * n * kDoubleBytes);
+}
+BENCHMARK(BM_RandomizedSvd)->Arg(5)->Arg(20)->Arg(100);
+
+void BM_CalcComplements(benchmark::State& state) {
+  const int n = state.range(0);
+  S21Matrix a = Invertible(n);
+  for (auto _ : state) {
+    S21Matrix complements = a.CalcComplements();
+    benchmark::DoNotOptimize(complements(0, 0));
+  }
+  const double minor = n - 1.0;
+  SetRates(state, 2.0 / 3.0 * n * n * minor * minor * minor,
+           2.0 * n * n * kDoubleBytes);
+}
+BENCHMARK(BM_CalcComplements)->RangeMultiplier(2)->Range(2, 64);
+
+void BM_SumMatrix(benchmark::State& state) {
+  const int n = state.range(0);
+  S21Matrix a = Filled(n, n, 1);
+  S21Matrix b = Filled(n, n, 2);
+  for (auto _ : state) {
+    a.SumMatrix(b);
+    benchmark::ClobberMemory();
+  }
+  SetRates(state, 1.0 * n * n, 3.0 * n * n * kDoubleBytes);
+}
+BENCHMARK(BM_SumMatrix)->RangeMultiplier(4)->Range(1, 4096);
+
+void BM_SubMatrix(benchmark::State& state) {
+  const int n = state.range(0);
+  S21Matrix a = Filled(n, n, 1);
+  S21Matrix b = Filled(n, n, 2);
+  for (auto _ : state) {
+    a.SubMatrix(b);
+    benchmark::ClobberMemory();
+  }
+  SetRates(state, 1.0 * n * n, 3.0 * n * n * kDoubleBytes);
+}
+BENCHMARK(BM_SubMatrix)->RangeMultiplier(4)->Range(1, 4096);
+
+void BM_MulNumber(benchmark::State& state) {
+  const int n = state.range(0);
+  S21Matrix a = Filled(n, n, 1);
+  for (auto _ : state) {
+    a.MulNumber(1.0);
+    benchmark::ClobberMemory();
+  }
+  SetRates(state, 1.0 * n * n, 2.0 * n * n * kDoubleBytes);
+}
+BENCHMARK(BM_MulNumber)->RangeMultiplier(4)->Range(1, 4096);
+
+void BM_EqMatrix(benchmark::State& state) {
+  const int n = state.range(0);
+  S21Matrix a = Filled(n, n, 1);
+  S21Matrix b(a);
+  for (auto _ : state) benchmark::DoNotOptimize(a.EqMatrix(b));
+  SetRates(state, 1.0 * n * n, 2.0 * n * n * kDoubleBytes);
+}
+BENCHMARK(BM_EqMatrix)->RangeMultiplier(4)->Range(1, 4096);
+
+void BM_FusedExpression(benchmark::State& state) {
+  const int n = state.range(0);
+  S21Matrix a = Filled(n, n, 1);
+  S21Matrix b = Filled(n, n, 2);
+  S21Matrix c = Filled(n, n, 3);
+  S21Matrix result(n, n);
+  for (auto _ : state) {
+    result = a + b * 2.0 - c;
+    benchmark::ClobberMemory();
+  }
+  SetRates(state, 3.0 * n * n, 4.0 * n * n * kDoubleBytes);
+}
+BENCHMARK(BM_FusedExpression)->RangeMultiplier(4)->Range(1, 4096);
+
+void BM_Copy(benchmark::State& state) {
+  const int n = state.range(0);
+  S21Matrix a = Filled(n, n, 1);
+  for (auto _ : state) {
+    S21Matrix copy(a);
+    benchmark::DoNotOptimize(copy(0, 0));
+  }
+  SetRates(state, 0, 2.0 * n * n * kDoubleBytes);
+}
+BENCHMARK(BM_Copy)->RangeMultiplier(4)->Range(1, 4096);
+
+void BM_Move(benchmark::State& state) {
+  const int n = state.range(0);
+  S21Matrix a = Filled(n, n, 1);
+  for (auto _ : state) {
+    S21Matrix moved(std::move(a));
+    a = std::move(moved);
+    benchmark::DoNotOptimize(a(0, 0));
+  }
+  SetRates(state, 0, 0);
+}
+BENCHMARK(BM_Move)->RangeMultiplier(4)->Range(1, 4096);
+
+void BM_SetSize(benchmark::State& state) {
+  const int n = state.range(0);
+  S21Matrix a = Filled(n, n, 1);
+  for (auto _ : state) {
+    a.SetSize(n + 1, n + 1);
+    a.SetSize(n, n);
+    benchmark::DoNotOptimize(a(0, 0));
+  }
+  // After the first growth only the new row and column are written.
+  SetRates(state, 0, (2.0 * n + 1) * kDoubleBytes);
+}
+BENCHMARK(BM_SetSize)->RangeMultiplier(4)->Range(1, 4096);
+
+void BM_AppendRow(benchmark::State& state) {
+  const int n = state.range(0);
+  const std::vector<double> row(n, 1.0);
+  for (auto _ : state) {
+    S21Matrix a;
+    for (int i = 0; i < n; i++) a.AppendRow(row);
+    benchmark::DoNotOptimize(a(0, 0));
+  }
+  SetRates(state, 0, 1.0 * n * n * kDoubleBytes);
+}
+BENCHMARK(BM_AppendRow)->RangeMultiplier(4)->Range(4, 4096);
+
+void BM_AppendCol(benchmark::State& state) {
+  const int n = state.range(0);
+  const std::vector<double> col(n, 1.0);
+  for (auto _ : state) {
+    S21Matrix a;
+    for (int i = 0; i < n; i++) a.AppendCol(col);
+    benchmark::DoNotOptimize(a(0, 0));
+  }
+  SetRates(state, 0, 1.0 * n * n * kDoubleBytes);
+}
+BENCHMARK(BM_AppendCol)->RangeMultiplier(4)->Range(4, 4096);
+
+constexpr char kBenchFile[] = "s21_bench_matrix.bin";
+
+void BM_Save(benchmark::State& state) {
+  const int n = state.range(0);
+  const S21Matrix a = Filled(n, n, 1);
+  for (auto _ : state) a.Save(kBenchFile);
+  std::remove(kBenchFile);
+  SetRates(state, 0, (double)n * n * kDoubleBytes);
+}
+BENCHMARK(BM_Save)->RangeMultiplier(4)->Range(64, 4096);
+
+void BM_Load(benchmark::State& state) {
+  const int n = state.range(0);
+  Filled(n, n, 1).Save(kBenchFile);
+  for (auto _ : state) {
+    S21Matrix loaded = S21Matrix::Load(kBenchFile);
+    benchmark::DoNotOptimize(loaded(0, 0));
+  }
+  std::remove(kBenchFile);
+  SetRates(state, 0, (double)n * n * kDoubleBytes);
+}
+BENCHMARK(BM_Load)->RangeMultiplier(4)->Range(64, 4096);
+
+// Opening a mapped matrix and reading one element; the rest is never
+// paged in.
+void BM_Map(benchmark::State& state) {
+  const int n = state.range(0);
+  Filled(n, n, 1).Save(kBenchFile);
+  for (auto _ : state) {
+    S21Matrix mapped = S21Matrix::Map(kBenchFile);
+    benchmark::DoNotOptimize(mapped(n - 1, n - 1));
+  }
+  std::remove(kBenchFile);
+  SetRates(state, 0, 0);
+}
+BENCHMARK(BM_Map)->RangeMultiplier(4)->Range(64, 4096);
+
+// Operands on disk, blocks limited to a quarter of one operand's size.
+void BM_OutOfCoreMulMatrix(benchmark::State& state) {
+  const int n = state.range(0);
+  Filled(n, n, 1).Save("s21_bench_a.bin");
+  Filled(n, n, 2).Save("s21_bench_b.bin");
+  const S21MatrixFile a("s21_bench_a.bin"), b("s21_bench_b.bin");
+  for (auto _ : state)
+    a.MulMatrix(b, "s21_bench_c.bin", (std::size_t)n * n * kDoubleBytes / 4);
+  for (const char* path : {"s21_bench_a.bin", "s21_bench_b.bin",
+                           "s21_bench_c.bin"})
+    std::remove(path);
+  SetRates(state, 2.0 * n * n * n, 3.0 * n * n * kDoubleBytes);
+}
+BENCHMARK(BM_OutOfCoreMulMatrix)->RangeMultiplier(2)->Range(256, 2048);
+
+S21Vector VectorFilled(int size, int seed) {
+  S21Vector vector(size);
+  for (int i = 0; i < size; i++) vector(i) = ((i * 13 + seed) % 19) / 5.0 - 2;
+  return vector;
+}
+
+// GEMV reads every element of A once, so it is bound by memory bandwidth
+// once A leaves the caches; bytes/s is the figure to compare.
+void BM_Gemv(benchmark::State& state) {
+  const int n = state.range(0);
+  S21Matrix a = Filled(n, n, 1);
+  S21Vector x = VectorFilled(n, 2);
+  S21Vector y(n);
+  for (auto _ : state) {
+    y.Gemv(1.0, a, x);
+    benchmark::DoNotOptimize(y.Data());
+  }
+  SetRates(state, 2.0 * n * n, (n + 2.0) * n * kDoubleBytes);
+}
+BENCHMARK(BM_Gemv)->RangeMultiplier(4)->Range(16, 4096)->Arg(8192);
+
+void BM_GemvTransposed(benchmark::State& state) {
+  const int n = state.range(0);
+  S21Matrix a = Filled(n, n, 1);
+  S21Vector x = VectorFilled(n, 2);
+  S21Vector y(n);
+  for (auto _ : state) {
+    y.GemvTransposed(1.0, a, x);
+    benchmark::DoNotOptimize(y.Data());
+  }
+  SetRates(state, 2.0 * n * n, (n + 2.0) * n * kDoubleBytes);
+}
+BENCHMARK(BM_GemvTransposed)->RangeMultiplier(4)->Range(16, 4096)->Arg(8192);
+
+// The n x 1 matrix product S21Vector replaces.
+void BM_MulMatrixColumn(benchmark::State& state) {
+  const int n = state.range(0);
+  S21Matrix a = Filled(n, n, 1);
+  S21Matrix x = Filled(n, 1, 2);
+  for (auto _ : state) {
+    S21Matrix y = a * x;
+    benchmark::DoNotOptimize(y(0, 0));
+  }
+  SetRates(state, 2.0 * n * n, (n + 2.0) * n * kDoubleBytes);
+}
+BENCHMARK(BM_MulMatrixColumn)->RangeMultiplier(4)->Range(16, 4096);
+
+void BM_Axpy(benchmark::State& state) {
+  const int n = state.range(0);
+  S21Vector x = VectorFilled(n, 1);
+  S21Vector y = VectorFilled(n, 2);
+  for (auto _ : state) {
+    y.Axpy(1e-9, x);
+    benchmark::DoNotOptimize(y.Data());
+  }
+  SetRates(state, 2.0 * n, 3.0 * n * kDoubleBytes);
+}
+BENCHMARK(BM_Axpy)->RangeMultiplier(8)->Range(1 << 10, 1 << 25);
+
+void BM_Dot(benchmark::State& state) {
+  const int n = state.range(0);
+  S21Vector x = VectorFilled(n, 1);
+  S21Vector y = VectorFilled(n, 2);
+  for (auto _ : state) benchmark::DoNotOptimize(x.Dot(y));
+  SetRates(state, 2.0 * n, 2.0 * n * kDoubleBytes);
+}
+BENCHMARK(BM_Dot)->RangeMultiplier(8)->Range(1 << 10, 1 << 25);
+
+void BM_Norm2(benchmark::State& state) {
+  const int n = state.range(0);
+  S21Vector x = VectorFilled(n, 1);
+  for (auto _ : state) benchmark::DoNotOptimize(x.Norm2());
+  SetRates(state, 2.0 * n, 1.0 * n * kDoubleBytes);
+}
+BENCHMARK(BM_Norm2)->RangeMultiplier(8)->Range(1 << 10, 1 << 25);
+
+// About 2% of the elements are non-zero.
+S21SparseMatrix SparseFilled(int size) {
+  S21Matrix dense = Filled(size, size, 1);
+  for (int i = 0; i < size; i++)
+    for (int j = 0; j < size; j++)
+      if ((i * 7 + j * 13) % 50 != 0) dense(i, j) = 0;
+  return S21SparseMatrix(dense);
+}
+
+void BM_SparseMulVector(benchmark::State& state) {
+  const int n = state.range(0);
+  S21SparseMatrix a = SparseFilled(n);
+  std::vector<double> x(n, 1.0);
+  for (auto _ : state) benchmark::DoNotOptimize(a.MulVector(x));
+  const double nonzero_bytes = a.NonZeros() * (kDoubleBytes + sizeof(int));
+  SetRates(state, 2.0 * a.NonZeros(),
+           nonzero_bytes + 2.0 * n * kDoubleBytes);
+}
+BENCHMARK(BM_SparseMulVector)->RangeMultiplier(4)->Range(64, 4096);
+
+void BM_SparseMulMatrix(benchmark::State& state) {
+  const int n = state.range(0);
+  S21SparseMatrix a = SparseFilled(n);
+  S21Matrix b = Filled(n, n, 2);
+  for (auto _ : state) {
+    S21Matrix c = a * b;
+    benchmark::DoNotOptimize(c(0, 0));
+  }
+  SetRates(state, 2.0 * a.NonZeros() * n, 2.0 * n * n * kDoubleBytes);
+}
+BENCHMARK(BM_SparseMulMatrix)->RangeMultiplier(4)->Range(64, 1024);
+
+constexpr int kBatchCount = 4096;
+
+S21MatrixBatch InvertibleBatch(int size) {
+  S21MatrixBatch batch(kBatchCount, size, size);
+  for (int i = 0; i < kBatchCount; i++)
+    for (int row = 0; row < size; row++)
+      for (int col = 0; col < size; col++)
+        batch(i, row, col) = ((i + row * 31 + col * 17) % 23) / 7.0 - 1.5 +
+                             (row == col ? size : 0);
+  return batch;
+}
+
+void BM_BatchMulMatrix(benchmark::State& state) {
+  const int n = state.range(0);
+  S21MatrixBatch a = InvertibleBatch(n);
+  for (auto _ : state) {
+    S21MatrixBatch c = a * a;
+    benchmark::DoNotOptimize(c(0, 0, 0));
+  }
+  SetRates(state, 2.0 * n * n * n * kBatchCount,
+           3.0 * n * n * kBatchCount * kDoubleBytes);
+}
+BENCHMARK(BM_BatchMulMatrix)->DenseRange(3, 16, 13)->Arg(4)->Arg(8);
+
+void BM_BatchInverseMatrix(benchmark::State& state) {
+  const int n = state.range(0);
+  S21MatrixBatch a = InvertibleBatch(n);
+  for (auto _ : state) {
+    S21MatrixBatch inverse = a.InverseMatrix();
+    benchmark::DoNotOptimize(inverse(0, 0, 0));
+  }
+  SetRates(state, 2.0 * n * n * n * kBatchCount,
+           2.0 * n * n * kBatchCount * kDoubleBytes);
+}
+BENCHMARK(BM_BatchInverseMatrix)->DenseRange(3, 16, 13)->Arg(4)->Arg(8);
+
+// The same work as BM_BatchInverseMatrix, one S21Matrix at a time.
+void BM_SingleInverseMatrix(benchmark::State& state) {
+  const int n = state.range(0);
+  S21MatrixBatch batch = InvertibleBatch(n);
+  std::vector<S21Matrix> matrices;
+  for (int i = 0; i < kBatchCount; i++) matrices.push_back(batch.Get(i));
+  for (auto _ : state) {
+    for (const S21Matrix& matrix : matrices) {
+      S21Matrix inverse = S21Matrix(matrix).InverseMatrix();
+      benchmark::DoNotOptimize(inverse(0, 0));
+    }
+  }
+  SetRates(state, 2.0 * n * n * n * kBatchCount,
+           2.0 * n * n * kBatchCount * kDoubleBytes);
+}
+BENCHMARK(BM_SingleInverseMatrix)->DenseRange(3, 16, 13)->Arg(4)->Arg(8);
+
+}  // namespace
+
+BENCHMARK_MAIN();
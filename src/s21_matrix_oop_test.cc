@@ -1,7 +1,133 @@
 #include "s21_matrix_oop.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <memory_resource>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include <gtest/gtest.h>
 
+#include "s21_basic_matrix.h"
+#include "s21_fixed_matrix.h"
+#include "s21_inverse_tracker.h"
+#include "s21_matrix_batch.h"
+#include "s21_matrix_eigen.h"
+#include "s21_matrix_file.h"
+#include "s21_matrix_simd.h"
+#include "s21_matrix_solvers.h"
+#include "s21_matrix_stats.h"
+#include "s21_sparse_matrix.h"
+#include "s21_thread_pool.h"
+#include "s21_vector.h"
+
+// Forwards to the default heap and counts what passes through.
+class CountingResource : public std::pmr::memory_resource {
+ public:
+  int allocations = 0;
+  int live = 0;
+
+ private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    allocations++, live++;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+  void do_deallocate(void* ptr, std::size_t bytes,
+                     std::size_t alignment) override {
+    live--;
+    std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+  }
+  bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+};
+
+// Every global allocation, including the aligned buffers of the kernels.
+// All forms are replaced so that sanitizers do not pair their own new with
+// this delete. Not inlined, as GCC would then take malloc and free for a
+// mismatch with new and delete.
+std::atomic<long> global_allocations{0};
+
+[[gnu::noinline]] void* CountedAllocate(std::size_t bytes,
+                                        std::size_t alignment) noexcept {
+  global_allocations++;
+  if (alignment <= alignof(std::max_align_t))
+    return std::malloc(bytes ? bytes : 1);
+  const std::size_t size = (bytes + alignment - 1) / alignment * alignment;
+  return std::aligned_alloc(alignment, size ? size : alignment);
+}
+
+void* CountedNew(std::size_t bytes, std::size_t alignment) {
+  if (void* ptr = CountedAllocate(bytes, alignment)) return ptr;
+  throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void CountedFree(void* ptr) noexcept { std::free(ptr); }
+
+void* operator new(std::size_t bytes) { return CountedNew(bytes, 0); }
+void* operator new[](std::size_t bytes) { return CountedNew(bytes, 0); }
+void* operator new(std::size_t bytes, std::align_val_t alignment) {
+  return CountedNew(bytes, static_cast<std::size_t>(alignment));
+}
+void* operator new[](std::size_t bytes, std::align_val_t alignment) {
+  return CountedNew(bytes, static_cast<std::size_t>(alignment));
+}
+void* operator new(std::size_t bytes, const std::nothrow_t&) noexcept {
+  return CountedAllocate(bytes, 0);
+}
+void* operator new[](std::size_t bytes, const std::nothrow_t&) noexcept {
+  return CountedAllocate(bytes, 0);
+}
+void* operator new(std::size_t bytes, std::align_val_t alignment,
+                   const std::nothrow_t&) noexcept {
+  return CountedAllocate(bytes, static_cast<std::size_t>(alignment));
+}
+void* operator new[](std::size_t bytes, std::align_val_t alignment,
+                     const std::nothrow_t&) noexcept {
+  return CountedAllocate(bytes, static_cast<std::size_t>(alignment));
+}
+void operator delete(void* ptr) noexcept { CountedFree(ptr); }
+void operator delete[](void* ptr) noexcept { CountedFree(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { CountedFree(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { CountedFree(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept {
+  CountedFree(ptr);
+}
+void operator delete[](void* ptr, std::align_val_t) noexcept {
+  CountedFree(ptr);
+}
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept {
+  CountedFree(ptr);
+}
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept {
+  CountedFree(ptr);
+}
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+  CountedFree(ptr);
+}
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+  CountedFree(ptr);
+}
+void operator delete(void* ptr, std::align_val_t,
+                     const std::nothrow_t&) noexcept {
+  CountedFree(ptr);
+}
+void operator delete[](void* ptr, std::align_val_t,
+                       const std::nothrow_t&) noexcept {
+  CountedFree(ptr);
+}
+
 TEST(Constructor_tests, default_constructor_1) {
   S21Matrix basic;
   EXPECT_EQ(basic.GetRows(), 0);
@@ -26,6 +152,21 @@ TEST(Constructor_tests, copy_constructor) {
   basic = result;
 }
 
+TEST(Constructor_tests, copy_constructor_values) {
+  S21Matrix basic(5, 11);
+  for (int i = 0; i < 5; i++)
+    for (int j = 0; j < 11; j++) basic(i, j) = i * 11 + j;
+  S21Matrix result(basic);
+  S21Matrix assigned(3, 3);
+  assigned = basic;
+  for (int i = 0; i < 5; i++) {
+    for (int j = 0; j < 11; j++) {
+      EXPECT_DOUBLE_EQ(result(i, j), i * 11 + j);
+      EXPECT_DOUBLE_EQ(assigned(i, j), i * 11 + j);
+    }
+  }
+}
+
 TEST(Constructor_tests, move_constructor) {
   S21Matrix basic(2, 3);
   S21Matrix result(std::move(basic));
@@ -590,6 +731,1839 @@ TEST(functionalTest, equal2) {
   EXPECT_TRUE(a == b);
 }
 
+void FillSequence(S21Matrix& matrix, int seed) {
+  for (int i = 0; i < matrix.GetRows(); i++)
+    for (int j = 0; j < matrix.GetCols(); j++)
+      matrix(i, j) = ((i * 31 + j * 17 + seed) % 23) / 7.0 - 1.5;
+}
+
+TEST(functionalTest, multmatrix_Blocked) {
+  using s21_kernels::SimdLevel;
+  const SimdLevel initial = s21_kernels::ActiveSimdLevel();
+  const int sizes[][3] = {{1, 1, 1},    {5, 7, 3},     {33, 40, 35},
+                          {129, 67, 257}, {300, 130, 520}, {64, 64, 64}};
+  for (const auto& size : sizes) {
+    S21Matrix a(size[0], size[2]);
+    S21Matrix b(size[2], size[1]);
+    FillSequence(a, 1);
+    FillSequence(b, 2);
+    S21Matrix reference(a);
+    reference.MulMatrixReference(b);
+    // Every level's micro-kernel, including its edge tiles.
+    for (SimdLevel level : {SimdLevel::kScalar, SimdLevel::kSse2,
+                            SimdLevel::kAvx2, SimdLevel::kAvx512}) {
+      s21_kernels::SetSimdLevel(level);
+      S21Matrix blocked(a);
+      blocked.MulMatrix(b);
+      EXPECT_EQ(blocked.GetRows(), size[0]);
+      EXPECT_EQ(blocked.GetCols(), size[1]);
+      EXPECT_TRUE(blocked == reference);
+    }
+  }
+  s21_kernels::SetSimdLevel(initial);
+}
+
+TEST(functionalTest, multmatrix_Reference_Exception) {
+  S21Matrix a(2, 3);
+  S21Matrix b(2, 2);
+  EXPECT_ANY_THROW(a.MulMatrixReference(b));
+}
+
+TEST(functionalFuncTest, transpose_rectangular) {
+  const int sizes[][2] = {{1, 1}, {3, 5}, {1, 100}, {70, 33}, {130, 257}};
+  for (const auto& size : sizes) {
+    S21Matrix a(size[0], size[1]);
+    FillSequence(a, 3);
+    const S21Matrix transposed = a.Transpose();
+    ASSERT_EQ(transposed.GetRows(), size[1]);
+    ASSERT_EQ(transposed.GetCols(), size[0]);
+    for (int i = 0; i < size[0]; i++)
+      for (int j = 0; j < size[1]; j++) EXPECT_EQ(transposed(j, i), a(i, j));
+  }
+}
+
+TEST(functionalFuncTest, transpose_in_place) {
+  for (int size : {1, 2, 31, 100}) {
+    S21Matrix square(size, size);
+    FillSequence(square, 4);
+    const S21Matrix expected = square.Transpose();
+    square.TransposeInPlace();
+    EXPECT_TRUE(square == expected);
+  }
+  S21Matrix rect(3, 5);
+  FillSequence(rect, 5);
+  const S21Matrix expected = rect.Transpose();
+  rect.TransposeInPlace();
+  EXPECT_EQ(rect.GetRows(), 5);
+  EXPECT_EQ(rect.GetCols(), 3);
+  EXPECT_TRUE(rect == expected);
+}
+
+TEST(functionalTest, multmatrix_TransposedView) {
+  const int sizes[][3] = {{5, 7, 3}, {33, 40, 35}, {129, 67, 257}};
+  for (const auto& size : sizes) {
+    S21Matrix a(size[0], size[2]);
+    S21Matrix a_t(size[2], size[0]);
+    S21Matrix b_t(size[1], size[2]);
+    FillSequence(a, 1);
+    FillSequence(a_t, 1);
+    FillSequence(b_t, 2);
+    S21Matrix b = b_t.Transpose();
+    S21Matrix reference(a);
+    reference.MulMatrixReference(b);
+
+    S21TransposedView view = b_t.TransposedView();
+    EXPECT_EQ(view.GetRows(), size[2]);
+    EXPECT_EQ(view.GetCols(), size[1]);
+    EXPECT_EQ(view(1, 2), b_t(2, 1));
+    S21Matrix product(a);
+    product.MulMatrix(view);
+    EXPECT_TRUE(product == reference);
+    S21Matrix from_operator = a * view;
+    EXPECT_TRUE(from_operator == reference);
+
+    S21Matrix lhs_reference = a_t.Transpose();
+    lhs_reference.MulMatrixReference(b);
+    S21Matrix lhs_view = a_t.TransposedView() * b;
+    EXPECT_TRUE(lhs_view == lhs_reference);
+    S21Matrix both_views = a_t.TransposedView() * b_t.TransposedView();
+    EXPECT_TRUE(both_views == lhs_reference);
+  }
+  S21Matrix a(2, 3);
+  S21Matrix b(2, 2);
+  EXPECT_ANY_THROW(a.MulMatrix(b.TransposedView()));
+  EXPECT_ANY_THROW(S21Matrix(a * b.TransposedView()));
+}
+
+TEST(functionalTest, simd_levels_bit_identical) {
+  using s21_kernels::SimdLevel;
+  const SimdLevel initial = s21_kernels::ActiveSimdLevel();
+  S21Matrix a(7, 19);
+  S21Matrix b(7, 19);
+  FillSequence(a, 3);
+  FillSequence(b, 4);
+  s21_kernels::SetSimdLevel(SimdLevel::kScalar);
+  S21Matrix sum = a + b;
+  S21Matrix diff = a - b;
+  S21Matrix scaled = a * 0.3;
+  const SimdLevel levels[] = {SimdLevel::kSse2, SimdLevel::kAvx2,
+                              SimdLevel::kAvx512};
+  for (SimdLevel level : levels) {
+    s21_kernels::SetSimdLevel(level);
+    EXPECT_LE(s21_kernels::ActiveSimdLevel(),
+              s21_kernels::DetectedSimdLevel());
+    S21Matrix simd_sum = a + b;
+    S21Matrix simd_diff = a - b;
+    S21Matrix simd_scaled = a * 0.3;
+    for (int i = 0; i < a.GetRows(); i++) {
+      for (int j = 0; j < a.GetCols(); j++) {
+        EXPECT_EQ(simd_sum(i, j), sum(i, j));
+        EXPECT_EQ(simd_diff(i, j), diff(i, j));
+        EXPECT_EQ(simd_scaled(i, j), scaled(i, j));
+      }
+    }
+    EXPECT_TRUE(simd_sum == sum);
+    simd_sum(6, 18) += 1e-6;
+    EXPECT_FALSE(simd_sum == sum);
+    simd_sum(6, 18) = sum(6, 18);
+    simd_sum(0, 1) -= 1e-6;
+    EXPECT_FALSE(simd_sum == sum);
+  }
+  s21_kernels::SetSimdLevel(initial);
+}
+
+TEST(functionalFuncTest, lu_solve) {
+  S21Matrix a(3, 3);
+  a(0, 0) = 2, a(0, 1) = 1, a(0, 2) = -1;
+  a(1, 0) = -3, a(1, 1) = -1, a(1, 2) = 2;
+  a(2, 0) = -2, a(2, 1) = 1, a(2, 2) = 2;
+  S21Matrix b(3, 2);
+  b(0, 0) = 8, b(1, 0) = -11, b(2, 0) = -3;
+  b(0, 1) = 1, b(1, 1) = -1, b(2, 1) = 1;
+  S21Matrix x = a.Solve(b);
+  EXPECT_NEAR(x(0, 0), 2, 1e-12);
+  EXPECT_NEAR(x(1, 0), 3, 1e-12);
+  EXPECT_NEAR(x(2, 0), -1, 1e-12);
+  S21Matrix check = a * x;
+  EXPECT_TRUE(check == b);
+  S21LU lu = a.LU();
+  EXPECT_EQ(lu.GetSize(), 3);
+  EXPECT_FALSE(lu.IsSingular());
+  EXPECT_NEAR(lu.Determinant(), a.Determinant(), 1e-12);
+  EXPECT_NEAR(lu.Determinant(), -1, 1e-12);
+}
+
+TEST(functionalFuncTest, lu_inverse_large) {
+  const int n = 12;
+  S21Matrix a(n, n);
+  FillSequence(a, 5);
+  for (int i = 0; i < n; i++) a(i, i) += n;
+  S21Matrix inverse = a.InverseMatrix();
+  S21Matrix product = a * inverse;
+  S21Matrix identity(n, n);
+  for (int i = 0; i < n; i++) identity(i, i) = 1;
+  EXPECT_TRUE(product == identity);
+}
+
+TEST(functionalFuncTest, lu_determinant_pivoting) {
+  S21Matrix a(3, 3);
+  a(0, 1) = 1, a(1, 2) = 1, a(2, 0) = 1;
+  EXPECT_DOUBLE_EQ(a.Determinant(), 1);
+  a(2, 0) = 0;
+  EXPECT_TRUE(a.LU().IsSingular());
+  EXPECT_DOUBLE_EQ(a.Determinant(), 0);
+}
+
+TEST(functionalFuncTest, lu_Exception) {
+  S21Matrix rectangle(3, 2);
+  EXPECT_ANY_THROW(rectangle.LU());
+  S21Matrix singular(2, 2);
+  S21Matrix b(2, 1);
+  EXPECT_ANY_THROW(singular.Solve(b));
+  S21Matrix square(2, 2);
+  square(0, 0) = 1, square(1, 1) = 1;
+  S21Matrix wrong_rows(3, 1);
+  EXPECT_ANY_THROW(square.Solve(wrong_rows));
+}
+
+// Elimination leaves a last pivot of about 1e-16 instead of 0, which
+// must still count as singular. The determinant is that rounding noise.
+TEST(functionalFuncTest, lu_nearly_singular) {
+  S21Matrix a(3, 3);
+  for (int i = 0; i < 9; i++) a(i / 3, i % 3) = i + 1;
+  EXPECT_TRUE(a.LU().IsSingular());
+  EXPECT_NEAR(a.Determinant(), 0, 1e-14);
+  EXPECT_THROW(a.InverseMatrix(), std::invalid_argument);
+  EXPECT_THROW(a.Solve(S21Matrix(3, 1)), std::invalid_argument);
+  S21Matrix scratch(a);
+  EXPECT_EQ(s21_views::Determinant(scratch), a.Determinant());
+  // Scaling does not change the verdict.
+  S21Matrix scaled = a * 1e-200;
+  EXPECT_THROW(scaled.InverseMatrix(), std::invalid_argument);
+  S21Matrix tiny(1, 1);
+  tiny(0, 0) = 1e-300;
+  EXPECT_DOUBLE_EQ(tiny.InverseMatrix()(0, 0), 1e300);
+  EXPECT_THROW(S21Matrix().InverseMatrix(), std::invalid_argument);
+  EXPECT_THROW(S21InverseTracker{a}, std::invalid_argument);
+
+  S21GenericMatrix<long double> generic(3, 3);
+  for (int i = 0; i < 9; i++) generic(i / 3, i % 3) = i + 1;
+  EXPECT_NEAR(generic.Determinant(), 0, 1e-14);
+  EXPECT_THROW(generic.InverseMatrix(), std::invalid_argument);
+  EXPECT_THROW(S21GenericMatrix<float>().InverseMatrix(),
+               std::invalid_argument);
+  const S21FixedMatrix<3, 3> fixed = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+  EXPECT_THROW(fixed.InverseMatrix(), std::invalid_argument);
+  S21FixedMatrix<4, 4> fixed_large;
+  for (int i = 0; i < 16; i++) fixed_large(i / 4, i % 4) = i + 1;
+  EXPECT_NEAR(fixed_large.Determinant(), 0, 1e-11);
+  EXPECT_THROW(fixed_large.InverseMatrix(), std::invalid_argument);
+  S21MatrixBatch batch(2, 3, 3);
+  batch.Set(0, a);
+  batch.Set(1, scaled);
+  for (double det : batch.Determinant()) EXPECT_NEAR(det, 0, 1e-14);
+  EXPECT_THROW(batch.InverseMatrix(), std::invalid_argument);
+  EXPECT_THROW(S21MatrixBatch(2, 0, 0).InverseMatrix(), std::invalid_argument);
+}
+
+// Pivots below the singularity tolerance of a badly scaled matrix still
+// enter the determinant.
+TEST(functionalFuncTest, lu_determinant_scaling) {
+  S21Matrix a(3, 3), b(4, 4);
+  a(0, 0) = 1e8, a(1, 1) = 1e8, a(2, 2) = 1e-8;
+  b(0, 0) = 1e10, b(1, 1) = 1, b(2, 2) = 1, b(3, 3) = 1e-7;
+  EXPECT_DOUBLE_EQ(a.Determinant(), 1e8);
+  EXPECT_DOUBLE_EQ(b.Determinant(), 1e3);
+  EXPECT_DOUBLE_EQ(a.LU().Determinant(), 1e8);
+  S21Matrix scratch(b);
+  EXPECT_DOUBLE_EQ(s21_views::Determinant(scratch), 1e3);
+  EXPECT_DOUBLE_EQ(b.CalcComplements()(0, 0), 1e-7);
+  S21GenericMatrix<long double> generic(4, 4);
+  S21FixedMatrix<4, 4> fixed;
+  for (int i = 0; i < 4; i++) generic(i, i) = b(i, i), fixed(i, i) = b(i, i);
+  EXPECT_NEAR(generic.Determinant(), 1e3L, 1e-12L);
+  EXPECT_DOUBLE_EQ(fixed.Determinant(), 1e3);
+  S21MatrixBatch batch(2, 4, 4);
+  batch.Set(0, b);
+  batch.Set(1, b * 2.0);
+  EXPECT_DOUBLE_EQ(batch.Determinant()[0], 1e3);
+  EXPECT_DOUBLE_EQ(batch.Determinant()[1], 16e3);
+}
+
+void ExpectBitIdentical(const S21Matrix& lhs, const S21Matrix& rhs) {
+  ASSERT_EQ(lhs.GetRows(), rhs.GetRows());
+  ASSERT_EQ(lhs.GetCols(), rhs.GetCols());
+  for (int i = 0; i < lhs.GetRows(); i++)
+    for (int j = 0; j < lhs.GetCols(); j++) ASSERT_EQ(lhs(i, j), rhs(i, j));
+}
+
+TEST(threadPoolTest, deterministic_results) {
+  S21Matrix a(300, 270);
+  S21Matrix b(270, 310);
+  S21Matrix c(300, 270);
+  S21Matrix square(7, 7);
+  FillSequence(a, 6);
+  FillSequence(b, 7);
+  FillSequence(c, 8);
+  FillSequence(square, 9);
+  const long threshold = S21ThreadPool::GetSerialThreshold();
+  S21ThreadPool::SetSerialThreshold(0);
+  S21Matrix expected[5];
+  const int thread_counts[] = {1, 3, 4};
+  for (int threads : thread_counts) {
+    S21ThreadPool::SetThreadCount(threads);
+    EXPECT_EQ(S21ThreadPool::GetThreadCount(), threads);
+    S21Matrix results[5] = {a * b, a + c, a - c, a * 1.7,
+                            square.CalcComplements()};
+    for (int i = 0; i < 5; i++) {
+      if (threads == 1)
+        expected[i] = results[i];
+      else
+        ExpectBitIdentical(results[i], expected[i]);
+    }
+  }
+  S21ThreadPool::SetThreadCount(0);
+  S21ThreadPool::SetSerialThreshold(threshold);
+}
+
+TEST(threadPoolTest, external_executor) {
+  int calls = 0;
+  S21ThreadPool::SetExecutor(
+      [&calls](int chunks, const std::function<void(int)>& run_chunk) {
+        calls++;
+        for (int chunk = chunks - 1; chunk >= 0; chunk--) run_chunk(chunk);
+      });
+  S21ThreadPool::SetThreadCount(4);
+  const long threshold = S21ThreadPool::GetSerialThreshold();
+  S21ThreadPool::SetSerialThreshold(0);
+  S21Matrix a(40, 40);
+  S21Matrix b(40, 40);
+  FillSequence(a, 1);
+  FillSequence(b, 2);
+  S21Matrix sum = a + b;
+  EXPECT_GT(calls, 0);
+  EXPECT_DOUBLE_EQ(sum(3, 5), a(3, 5) + b(3, 5));
+  S21ThreadPool::SetExecutor(nullptr);
+  S21ThreadPool::SetSerialThreshold(threshold);
+  S21ThreadPool::SetThreadCount(0);
+}
+
+TEST(threadPoolTest, parallel_for_covers_range) {
+  S21ThreadPool::SetThreadCount(3);
+  std::vector<int> hits(1000);
+  S21ThreadPool::ParallelFor(1000, 1L << 20, [&hits](int begin, int end) {
+    for (int i = begin; i < end; i++) hits[i]++;
+  });
+  for (int hit : hits) EXPECT_EQ(hit, 1);
+  EXPECT_ANY_THROW(S21ThreadPool::ParallelFor(
+      100, 1L << 20, [](int, int) { throw std::runtime_error("chunk"); }));
+  EXPECT_ANY_THROW(S21ThreadPool::SetThreadCount(-1));
+  S21ThreadPool::SetThreadCount(0);
+}
+
+TEST(expressionTest, fused_chain) {
+  S21Matrix a(5, 6);
+  S21Matrix b(5, 4);
+  S21Matrix c(4, 6);
+  S21Matrix d(5, 6);
+  FillSequence(a, 1);
+  FillSequence(b, 2);
+  FillSequence(c, 3);
+  FillSequence(d, 4);
+  S21Matrix expected(b);
+  expected.MulMatrix(c);
+  expected.SumMatrix(a);
+  expected.SubMatrix(d);
+  S21Matrix result = a + b * c - d;
+  EXPECT_TRUE(result == expected);
+
+  S21Matrix scaled = a * 2 + 0.5 * d - a;
+  for (int i = 0; i < 5; i++)
+    for (int j = 0; j < 6; j++)
+      EXPECT_DOUBLE_EQ(scaled(i, j), a(i, j) * 2 + 0.5 * d(i, j) - a(i, j));
+}
+
+TEST(expressionTest, assign_and_alias) {
+  S21Matrix a(3, 3);
+  S21Matrix b(3, 3);
+  FillSequence(a, 1);
+  FillSequence(b, 2);
+  S21Matrix expected(a);
+  expected.SumMatrix(b);
+  expected.MulNumber(3);
+  a = (a + b) * 3;
+  EXPECT_TRUE(a == expected);
+
+  S21Matrix target(1, 7);
+  target = b - b;
+  EXPECT_EQ(target.GetRows(), 3);
+  EXPECT_EQ(target.GetCols(), 3);
+  EXPECT_DOUBLE_EQ(target(2, 2), 0);
+
+  S21Matrix product(2, 2);
+  product = a * b;
+  S21Matrix eager(a);
+  eager.MulMatrix(b);
+  EXPECT_TRUE(product == eager);
+}
+
+TEST(expressionTest, Exception) {
+  S21Matrix a(3, 3);
+  S21Matrix b(3, 2);
+  EXPECT_ANY_THROW(a + b * 2);
+  EXPECT_ANY_THROW(a * b + a);
+  EXPECT_ANY_THROW(b * b);
+}
+
+TEST(expressionTest, allocations) {
+  S21ThreadPool::SetThreadCount(1);
+  CountingResource counter;
+  S21Matrix a(4, 4, &counter);
+  S21Matrix b(4, 4, &counter);
+  S21Matrix c(4, 4, &counter);
+  FillSequence(a, 1);
+  FillSequence(b, 2);
+  FillSequence(c, 3);
+
+  counter.allocations = 0;
+  S21Matrix chain = (a + b) * 2 - c + a;
+  EXPECT_EQ(counter.allocations, 1);
+  EXPECT_EQ(chain.GetResource(), &counter);
+
+  counter.allocations = 0;
+  chain = a - b + c;
+  EXPECT_EQ(counter.allocations, 0);
+
+  counter.allocations = 0;
+  S21Matrix with_product = a * b + c - a;
+  EXPECT_EQ(counter.allocations, 1);
+
+  counter.allocations = 0;
+  S21Matrix from_temporary = a.Transpose() + b + c;
+  EXPECT_EQ(counter.allocations, 1);
+
+  S21Matrix moved_from(a);
+  counter.allocations = 0;
+  S21Matrix stolen = std::move(moved_from) * 3 + b;
+  EXPECT_EQ(counter.allocations, 0);
+  EXPECT_EQ(moved_from.GetRows(), 0);
+
+  S21Matrix expected(a);
+  expected.MulNumber(3);
+  expected.SumMatrix(b);
+  EXPECT_TRUE(stolen == expected);
+  EXPECT_TRUE(from_temporary == a.Transpose() + b + c);
+  S21ThreadPool::SetThreadCount(0);
+}
+
+TEST(expressionTest, const_operands) {
+  const S21Matrix a(2, 2);
+  S21Matrix b(2, 2);
+  b(0, 0) = 1;
+  S21Matrix sum = a + b;
+  S21Matrix copy(2, 2);
+  copy = sum;
+  EXPECT_TRUE(copy == b);
+  EXPECT_TRUE(b == a + b);
+  EXPECT_FALSE(sum != a + b);
+}
+
+TEST(intoTest, matches_and_reuses) {
+  S21ThreadPool::SetThreadCount(1);
+  CountingResource counter;
+  S21Matrix a(5, 5, &counter), b(5, 5, &counter), out(&counter);
+  FillSequence(a, 1);
+  FillSequence(b, 2);
+  a(0, 0) += 50;
+  out.Reserve(5, 9);
+  const std::size_t capacity = out.GetCapacity();
+  const S21Matrix product = a * b, sum = a + b, difference = a - b,
+                  scaled = a * 3, transpose = a.Transpose(),
+                  complements = a.CalcComplements(),
+                  inverse = a.InverseMatrix(), solution = a.Solve(b);
+
+  counter.allocations = 0;
+  S21Matrix::MulMatrixInto(a, b, out);
+  EXPECT_TRUE(out == product);
+  S21Matrix::SumMatrixInto(a, b, out);
+  EXPECT_TRUE(out == sum);
+  S21Matrix::SubMatrixInto(a, b, out);
+  EXPECT_TRUE(out == difference);
+  S21Matrix::MulNumberInto(a, 3, out);
+  EXPECT_TRUE(out == scaled);
+  S21Matrix::TransposeInto(a, out);
+  EXPECT_TRUE(out == transpose);
+  EXPECT_EQ(counter.allocations, 0);
+  // Only the scratch minor of the single task and the factorization.
+  S21Matrix::CalcComplementsInto(a, out);
+  EXPECT_TRUE(out == complements);
+  S21Matrix::InverseMatrixInto(a, out);
+  EXPECT_TRUE(out == inverse);
+  EXPECT_EQ(counter.allocations, 2);
+  S21LU lu(b);
+  lu.Factor(a);
+  counter.allocations = 0;
+  lu.InverseInto(out);
+  EXPECT_TRUE(out == inverse);
+  lu.SolveInto(b, out);
+  EXPECT_TRUE(out == solution);
+  EXPECT_EQ(counter.allocations, 0);
+  EXPECT_EQ(out.GetCapacity(), capacity);
+
+  // out as an operand.
+  S21Matrix alias(a);
+  S21Matrix::MulMatrixInto(alias, b, alias);
+  EXPECT_TRUE(alias == product);
+  alias = a;
+  S21Matrix::SubMatrixInto(b, alias, alias);
+  EXPECT_TRUE(alias == b - a);
+  S21Matrix wide(2, 3);
+  FillSequence(wide, 3);
+  alias = wide;
+  S21Matrix::TransposeInto(alias, alias);
+  EXPECT_TRUE(alias == wide.Transpose());
+  alias = b;
+  lu.SolveInto(alias, alias);
+  EXPECT_TRUE(alias == solution);
+  S21ThreadPool::SetThreadCount(0);
+}
+
+// Products above the size GEMM packs its operands for keep the packing
+// buffers of the thread between calls.
+TEST(intoTest, packed_product_reuses) {
+  S21ThreadPool::SetThreadCount(1);
+  const int n = 128;
+  S21Matrix a(n, n), b(n, n), out(n, n), transposed(n, n);
+  FillSequence(a, 1);
+  FillSequence(b, 2);
+  S21Matrix expected(a);
+  expected.MulMatrixReference(b);
+  S21Matrix::MulMatrixInto(a, b, out);
+  const long before = global_allocations;
+  for (int i = 0; i < 3; i++) {
+    S21Matrix::MulMatrixInto(a, b, out);
+    S21Matrix::TransposeInto(out, transposed);
+    S21Matrix::SumMatrixInto(transposed, a, transposed);
+  }
+  EXPECT_EQ(global_allocations - before, 0);
+  EXPECT_TRUE(out == expected);
+  EXPECT_TRUE(transposed == expected.Transpose() + a);
+  S21ThreadPool::SetThreadCount(0);
+}
+
+TEST(intoTest, Exception) {
+  S21Matrix a(2, 3), b(2, 2), out;
+  EXPECT_THROW(S21Matrix::MulMatrixInto(a, a, out), std::out_of_range);
+  EXPECT_THROW(S21Matrix::SumMatrixInto(a, b, out), std::out_of_range);
+  EXPECT_THROW(S21Matrix::CalcComplementsInto(a, out), std::invalid_argument);
+  EXPECT_THROW(S21Matrix::InverseMatrixInto(b, out), std::invalid_argument);
+  EXPECT_THROW(out.Reserve(-1, 2), std::invalid_argument);
+}
+
+TEST(Getter_And_Setter, capacity) {
+  CountingResource counter;
+  S21Matrix matrix(3, 3, &counter);
+  FillSequence(matrix, 1);
+  const S21Matrix original(matrix);
+  matrix.Reserve(20, 20);
+  EXPECT_TRUE(matrix == original);
+  counter.allocations = 0;
+  matrix.SetSize(20, 17);
+  matrix.SetSize(2, 2);
+  matrix.SetSize(3, 3);
+  EXPECT_EQ(counter.allocations, 0);
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      const double value = i < 2 && j < 2 ? original(i, j) : 0.0;
+      EXPECT_DOUBLE_EQ(matrix(i, j), value);
+    }
+  }
+  matrix.SetSize(2, 11);
+  matrix(1, 10) = 7;
+  matrix.SetSize(2, 4);
+  matrix.SetSize(2, 11);
+  EXPECT_DOUBLE_EQ(matrix(1, 10), 0);
+  EXPECT_DOUBLE_EQ(matrix(1, 1), original(1, 1));
+  EXPECT_EQ(counter.allocations, 0);
+}
+
+TEST(Getter_And_Setter, append) {
+  CountingResource counter;
+  S21Matrix matrix(&counter);
+  for (int i = 0; i < 1000; i++)
+    matrix.AppendRow({1.0 * i, 2.0 * i, 3.0 * i});
+  EXPECT_EQ(matrix.GetRows(), 1000);
+  EXPECT_LE(counter.allocations, 12);
+  for (int j = 0; j < 100; j++)
+    matrix.AppendCol(std::vector<double>(1000, j));
+  EXPECT_EQ(matrix.GetCols(), 103);
+  EXPECT_LE(counter.allocations, 24);
+  EXPECT_DOUBLE_EQ(matrix(999, 2), 2997);
+  EXPECT_DOUBLE_EQ(matrix(500, 102), 99);
+  EXPECT_GT(matrix.GetCapacity(), 1000u * 104);
+
+  // Spare columns and rows do not change what the matrix holds.
+  const S21Matrix copy(matrix);
+  S21Matrix sum(copy);
+  sum.SumMatrix(matrix);
+  EXPECT_TRUE(sum == copy * 2);
+  matrix.Save("s21_append.bin");
+  EXPECT_TRUE(S21Matrix::Load("s21_append.bin") == copy);
+  std::remove("s21_append.bin");
+  matrix.ShrinkToFit();
+  EXPECT_EQ(matrix.GetCapacity(), 1000u * 104);
+  EXPECT_TRUE(matrix == copy);
+
+  S21Matrix block(2, 2);
+  FillSequence(block, 1);
+  block.AppendRows(block);
+  block.AppendCols(block.View().Submatrix(0, 0, 4, 1));
+  EXPECT_EQ(block.GetRows(), 4);
+  EXPECT_DOUBLE_EQ(block(3, 1), block(1, 1));
+  EXPECT_DOUBLE_EQ(block(2, 2), block(0, 0));
+  EXPECT_THROW(block.AppendRow({1, 2}), std::out_of_range);
+  EXPECT_THROW(block.AppendCol({1, 2}), std::out_of_range);
+}
+
+TEST(memoryTest, arena) {
+  CountingResource upstream;
+  {
+    std::pmr::monotonic_buffer_resource arena(&upstream);
+    S21Matrix a(3, 3, &arena);
+    S21Matrix b(3, 3, &arena);
+    FillSequence(a, 1);
+    FillSequence(b, 2);
+    S21Matrix sum = a + b;
+    S21Matrix product = a * b;
+    S21Matrix shifted = a + b * 4;
+    S21Matrix inverse = shifted.InverseMatrix();
+    S21Matrix copy(product);
+    EXPECT_EQ(sum.GetResource(), &arena);
+    EXPECT_EQ(product.GetResource(), &arena);
+    EXPECT_EQ(inverse.GetResource(), &arena);
+    EXPECT_EQ(copy.GetResource(), &arena);
+    EXPECT_GT(upstream.live, 0);
+
+    S21Matrix on_heap(copy, S21SmallBlockPool::Instance());
+    EXPECT_TRUE(on_heap == copy);
+    on_heap = std::move(sum);
+    EXPECT_EQ(on_heap.GetResource(), S21SmallBlockPool::Instance());
+    EXPECT_DOUBLE_EQ(on_heap(1, 1), a(1, 1) + b(1, 1));
+  }
+  EXPECT_EQ(upstream.live, 0);
+}
+
+TEST(memoryTest, small_block_reuse) {
+  const double* first;
+  {
+    S21Matrix matrix(3, 3);
+    EXPECT_EQ(matrix.GetResource(), S21SmallBlockPool::Instance());
+    first = &matrix(0, 0);
+  }
+  S21Matrix again(3, 3);
+  EXPECT_EQ(&again(0, 0), first);
+  EXPECT_DOUBLE_EQ(again(2, 2), 0);
+  S21Matrix large(200, 200);
+  large(199, 199) = 1;
+  EXPECT_DOUBLE_EQ(large(199, 199), 1);
+}
+
+TEST(viewTest, slicing) {
+  S21Matrix matrix(4, 5);
+  FillSequence(matrix, 1);
+  S21MatrixView block = matrix.View().Submatrix(1, 2, 2, 3);
+  EXPECT_EQ(block.GetRows(), 2);
+  EXPECT_EQ(block.GetCols(), 3);
+  EXPECT_EQ(block(1, 2), matrix(2, 4));
+  block(0, 0) = 42;
+  EXPECT_EQ(matrix(1, 2), 42);
+
+  S21ConstMatrixView whole = static_cast<const S21Matrix&>(matrix).View();
+  EXPECT_EQ(whole.Row(3)(0, 4), matrix(3, 4));
+  EXPECT_EQ(whole.Col(2).GetRows(), 4);
+  EXPECT_EQ(whole.Col(2)(3, 0), matrix(3, 2));
+  S21ConstMatrixView diagonal = whole.Diagonal();
+  EXPECT_EQ(diagonal.GetRows(), 4);
+  for (int i = 0; i < 4; i++) EXPECT_EQ(diagonal(i, 0), matrix(i, i));
+  S21ConstMatrixView transposed = block.Transposed();
+  EXPECT_EQ(transposed.GetRows(), 3);
+  EXPECT_EQ(transposed(2, 1), matrix(2, 4));
+  EXPECT_TRUE(S21Matrix(transposed) == S21Matrix(block).Transpose());
+
+  EXPECT_THROW(block(2, 0), std::out_of_range);
+  EXPECT_THROW(whole.Submatrix(3, 0, 2, 1), std::out_of_range);
+  EXPECT_THROW(whole.Row(-1), std::out_of_range);
+  EXPECT_THROW(S21MatrixView(nullptr, -1, 1, 1), std::invalid_argument);
+}
+
+TEST(viewTest, kernels_on_blocks) {
+  S21Matrix a(6, 6);
+  S21Matrix b(6, 6);
+  FillSequence(a, 1);
+  FillSequence(b, 2);
+  S21Matrix expected(a);
+  expected.MulMatrix(b);
+
+  // C = A * B assembled from 3 x 3 blocks written through views.
+  S21Matrix c(6, 6);
+  S21Matrix scratch(3, 3);
+  for (int i = 0; i < 6; i += 3) {
+    for (int j = 0; j < 6; j += 3) {
+      for (int k = 0; k < 6; k += 3) {
+        s21_views::Multiply(a.View().Submatrix(i, k, 3, 3),
+                            b.View().Submatrix(k, j, 3, 3), scratch);
+        s21_views::Add(scratch, c.View().Submatrix(i, j, 3, 3));
+      }
+    }
+  }
+  EXPECT_TRUE(c == expected);
+  EXPECT_TRUE(c.EqMatrix(expected.View()));
+
+  // Operands with strides Gemm cannot read take the generic path.
+  S21Matrix outer(6, 6);
+  s21_views::Multiply(a.View().Diagonal(), b.View().Diagonal().Transposed(),
+                      outer);
+  EXPECT_DOUBLE_EQ(outer(2, 3), a(2, 2) * b(3, 3));
+  S21Matrix product(a);
+  product.MulMatrix(b.View().Transposed());
+  EXPECT_TRUE(product == a * b.TransposedView());
+
+  S21Matrix sum(3, 3);
+  sum.SumMatrix(a.View().Submatrix(3, 3, 3, 3));
+  sum.SubMatrix(a.View().Submatrix(3, 3, 3, 3).Transposed().Transposed());
+  EXPECT_TRUE(sum == S21Matrix(3, 3));
+  s21_views::Scale(0, a.View().Row(0));
+  for (int j = 0; j < 6; j++) EXPECT_EQ(a(0, j), 0);
+  s21_views::Copy(b.View().Col(0), a.View().Diagonal());
+  for (int i = 0; i < 6; i++) EXPECT_EQ(a(i, i), b(i, 0));
+
+  EXPECT_THROW(sum.SumMatrix(a.View()), std::out_of_range);
+  EXPECT_THROW(s21_views::Multiply(a, b.View().Row(0), c), std::out_of_range);
+  EXPECT_THROW(s21_views::Multiply(a, b, scratch), std::out_of_range);
+}
+
+TEST(viewTest, minor_without_copy) {
+  S21Matrix rect(4, 6);
+  FillSequence(rect, 3);
+  S21Matrix minor(3, 5);
+  rect.GetMinor(1, 4, minor);
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 5; j++)
+      EXPECT_EQ(minor(i, j), rect(i < 1 ? i : i + 1, j < 4 ? j : j + 1));
+  }
+  EXPECT_TRUE(minor == rect.GetMinor(1, 4));
+  EXPECT_THROW(rect.GetMinor(4, 0, minor), std::out_of_range);
+  EXPECT_THROW(rect.GetMinor(0, 0, S21Matrix(3, 3)), std::out_of_range);
+
+  S21Matrix square(7, 7);
+  FillSequence(square, 4);
+  for (int i = 0; i < 7; i++) square(i, i) += 7;
+  S21Matrix complements = square.CalcComplements();
+  S21Matrix scratch(6, 6);
+  square.GetMinor(2, 5, scratch);
+  EXPECT_EQ(s21_views::Determinant(scratch),
+            square.GetMinor(2, 5).Determinant());
+  EXPECT_EQ(complements(2, 5), -square.GetMinor(2, 5).Determinant());
+  // S21LU is the same elimination on its own copy; strided views work too.
+  S21Matrix packed(square), copy(square);
+  std::vector<int> pivots(7);
+  bool singular = true;
+  s21_views::FactorLU(packed, pivots.data(), singular);
+  EXPECT_FALSE(singular);
+  EXPECT_EQ(pivots, square.LU().Pivots());
+  ExpectBitIdentical(packed, square.LU().Packed());
+  EXPECT_NEAR(s21_views::Determinant(copy.View().Transposed()),
+              square.Determinant(), 1e-9 * std::fabs(square.Determinant()));
+  // A * adj(A) = det(A) * I.
+  S21Matrix identity = square * complements.TransposedView();
+  identity.MulNumber(1 / square.Determinant());
+  for (int i = 0; i < 7; i++)
+    for (int j = 0; j < 7; j++) EXPECT_NEAR(identity(i, j), i == j, 1e-9);
+}
+
+// Roughly one element in seven is non-zero.
+S21Matrix Sparse(int rows, int cols, int seed) {
+  S21Matrix matrix(rows, cols);
+  for (int i = 0; i < rows; i++)
+    for (int j = 0; j < cols; j++)
+      if ((i * 13 + j * 7 + seed) % 7 == 0) matrix(i, j) = i - j + 0.5;
+  return matrix;
+}
+
+TEST(sparseTest, conversions) {
+  S21Matrix dense = Sparse(9, 12, 1);
+  dense(0, 1) = 1e-9;
+  S21SparseMatrix csr(dense);
+  S21SparseMatrix dropped(dense, 1e-6);
+  EXPECT_EQ(csr.NonZeros(), dropped.NonZeros() + 1);
+  EXPECT_TRUE(csr.ToDense() == dense);
+  EXPECT_EQ(dropped(0, 1), 0);
+  EXPECT_EQ(csr(0, 1), 1e-9);
+  EXPECT_EQ(csr.Offsets().size(), 10u);
+
+  S21SparseMatrix csc = csr.ToFormat(S21SparseMatrix::Format::kCsc);
+  EXPECT_EQ(csc.GetFormat(), S21SparseMatrix::Format::kCsc);
+  EXPECT_EQ(csc.Offsets().size(), 13u);
+  EXPECT_TRUE(csc == csr);
+  EXPECT_TRUE(csc.ToDense() == dense);
+  EXPECT_TRUE(S21SparseMatrix(dense, 0, S21SparseMatrix::Format::kCsc)
+                  .ToFormat(S21SparseMatrix::Format::kCsr)
+                  .Values() == csr.Values());
+
+  S21SparseMatrix transposed = csr.Transpose();
+  EXPECT_EQ(transposed.GetRows(), 12);
+  EXPECT_TRUE(transposed.ToDense() == dense.Transpose());
+
+  S21SparseMatrix from_triplets(
+      3, 4, {{2, 3, 1.0}, {0, 1, 2.0}, {2, 3, 4.0}, {1, 1, 1.0}, {1, 1, -1.0}});
+  EXPECT_EQ(from_triplets.NonZeros(), 2);
+  EXPECT_EQ(from_triplets(2, 3), 5.0);
+  EXPECT_EQ(from_triplets(0, 1), 2.0);
+  EXPECT_EQ(from_triplets(1, 1), 0.0);
+
+  EXPECT_THROW(csr(9, 0), std::out_of_range);
+  EXPECT_THROW(S21SparseMatrix(dense, -1), std::invalid_argument);
+  EXPECT_THROW(S21SparseMatrix(2, 2, {{2, 0, 1.0}}), std::out_of_range);
+}
+
+TEST(sparseTest, products) {
+  S21Matrix dense = Sparse(300, 250, 2);
+  S21Matrix rhs(250, 17);
+  S21Matrix lhs(11, 300);
+  FillSequence(rhs, 3);
+  FillSequence(lhs, 4);
+  std::vector<double> x(250);
+  for (int i = 0; i < 250; i++) x[i] = (i % 5) - 2.0;
+
+  for (auto format :
+       {S21SparseMatrix::Format::kCsr, S21SparseMatrix::Format::kCsc}) {
+    S21SparseMatrix sparse(dense, 0, format);
+    std::vector<double> y = sparse.MulVector(x);
+    for (int i = 0; i < 300; i++) {
+      double expected = 0;
+      for (int j = 0; j < 250; j++) expected += dense(i, j) * x[j];
+      EXPECT_NEAR(y[i], expected, 1e-9);
+    }
+    EXPECT_TRUE(sparse * rhs == dense * rhs);
+    EXPECT_TRUE(lhs * sparse == lhs * dense);
+    EXPECT_THROW(sparse.MulVector(y), std::out_of_range);
+    EXPECT_THROW(sparse * lhs, std::out_of_range);
+    EXPECT_THROW(rhs * sparse, std::out_of_range);
+  }
+
+  const S21SparseMatrix sparse(dense);
+  const std::vector<double> serial = sparse.MulVector(x);
+  const S21Matrix serial_product = sparse * rhs;
+  const long threshold = S21ThreadPool::GetSerialThreshold();
+  S21ThreadPool::SetSerialThreshold(0);
+  S21ThreadPool::SetThreadCount(4);
+  EXPECT_TRUE(sparse.MulVector(x) == serial);
+  ExpectBitIdentical(sparse * rhs, serial_product);
+  S21ThreadPool::SetThreadCount(0);
+  S21ThreadPool::SetSerialThreshold(threshold);
+}
+
+TEST(sparseTest, arithmetic) {
+  S21Matrix a = Sparse(20, 30, 1);
+  S21Matrix b = Sparse(20, 30, 3);
+  b(0, 0) = a(0, 0) = 2;
+  S21SparseMatrix sparse_a(a);
+  S21SparseMatrix sparse_b(b, 0, S21SparseMatrix::Format::kCsc);
+  S21Matrix sum = a + b;
+  EXPECT_TRUE((sparse_a + sparse_b).ToDense() == sum);
+  S21SparseMatrix difference = sparse_a - S21SparseMatrix(a);
+  EXPECT_EQ(difference.NonZeros(), 0);
+  EXPECT_TRUE((2.0 * sparse_a * 0.5) == sparse_a);
+  sparse_b *= 0;
+  EXPECT_EQ(sparse_b.NonZeros(), 0);
+  EXPECT_TRUE(sparse_a != sparse_b);
+  EXPECT_FALSE(sparse_a == S21SparseMatrix(30, 20));
+  EXPECT_THROW(sparse_a += S21SparseMatrix(30, 20), std::out_of_range);
+}
+
+TEST(vectorTest, blas1) {
+  using s21_kernels::SimdLevel;
+  const int size = 40000 + 3;
+  S21Vector x(size), y(size);
+  for (int i = 0; i < size; i++) {
+    x(i) = ((i * 7) % 11) / 3.0 - 1.5;
+    y(i) = ((i * 5) % 13) / 4.0 - 1.0;
+  }
+  double dot = 0, l1 = 0, l2 = 0, linf = 0;
+  for (int i = 0; i < size; i++) {
+    dot += x(i) * y(i);
+    l1 += std::fabs(x(i));
+    l2 += x(i) * x(i);
+    linf = std::max(linf, std::fabs(x(i)));
+  }
+  EXPECT_NEAR(x.Dot(y), dot, 1e-9);
+  EXPECT_NEAR(x.Norm1(), l1, 1e-9);
+  EXPECT_NEAR(x.Norm2(), std::sqrt(l2), 1e-9);
+  EXPECT_EQ(x.NormInf(), linf);
+
+  S21Vector z = x + 2.0 * y;
+  S21Vector axpy(x);
+  axpy.Axpy(2.0, y);
+  EXPECT_TRUE(axpy == z);
+  EXPECT_TRUE(z - x == y * 2.0);
+  EXPECT_FALSE(z == x);
+
+  // Reductions give the same bits on every SIMD level and thread count.
+  const SimdLevel initial = s21_kernels::ActiveSimdLevel();
+  s21_kernels::SetSimdLevel(SimdLevel::kScalar);
+  const double scalar_dot = x.Dot(y), scalar_norm = x.Norm1();
+  for (SimdLevel level :
+       {SimdLevel::kSse2, SimdLevel::kAvx2, SimdLevel::kAvx512}) {
+    s21_kernels::SetSimdLevel(level);
+    EXPECT_EQ(x.Dot(y), scalar_dot);
+    EXPECT_EQ(x.Norm1(), scalar_norm);
+  }
+  s21_kernels::SetSimdLevel(initial);
+  const long threshold = S21ThreadPool::GetSerialThreshold();
+  S21ThreadPool::SetSerialThreshold(0);
+  S21ThreadPool::SetThreadCount(3);
+  EXPECT_EQ(x.Dot(y), scalar_dot);
+  S21ThreadPool::SetThreadCount(0);
+  S21ThreadPool::SetSerialThreshold(threshold);
+
+  const S21Vector huge{3e200, 4e200}, tiny{3e-200, 4e-200};
+  EXPECT_DOUBLE_EQ(huge.Norm2(), 5e200);
+  EXPECT_DOUBLE_EQ(tiny.Norm2(), 5e-200);
+  EXPECT_EQ(S21Vector().Norm2(), 0);
+}
+
+TEST(vectorTest, gemv) {
+  S21Matrix a(300, 70);
+  FillSequence(a, 2);
+  S21Vector x(70), t(300);
+  for (int i = 0; i < 70; i++) x(i) = (i % 5) - 2.0;
+  for (int i = 0; i < 300; i++) t(i) = (i % 3) - 1.0;
+  S21Matrix column(70, 1);
+  for (int i = 0; i < 70; i++) column(i, 0) = x(i);
+  EXPECT_TRUE(S21Vector(S21Matrix(a * column).View()) == a * x);
+  S21Vector y(t);
+  y.Gemv(2.0, a, x, -1.0);
+  S21Vector transposed(70);
+  transposed.GemvTransposed(1.0, a, t);
+  for (int i = 0; i < 300; i++) {
+    double expected = 0;
+    for (int j = 0; j < 70; j++) expected += a(i, j) * x(j);
+    EXPECT_NEAR(y(i), 2 * expected - t(i), 1e-9);
+  }
+  for (int j = 0; j < 70; j++) {
+    double expected = 0;
+    for (int i = 0; i < 300; i++) expected += a(i, j) * t(i);
+    EXPECT_NEAR(transposed(j), expected, 1e-9);
+  }
+
+  // Views: a block of a, a strided column as x, a row of a matrix as y.
+  const S21ConstMatrixView block = a.View().Submatrix(10, 5, 20, 30);
+  S21Vector x_block(a.View().Col(0).Submatrix(0, 0, 30, 1));
+  S21Matrix out(2, 20);
+  s21_views::Gemv(1.0, block, a.View().Col(0).Submatrix(0, 0, 30, 1), 0.0,
+                  out.View().Row(1));
+  S21Vector expected(20);
+  expected.Gemv(1.0, S21Matrix(block), x_block);
+  EXPECT_TRUE(S21Vector(out.View().Row(1)) == expected);
+  s21_views::Gemv(1.0, block.Submatrix(0, 0, 20, 29).Diagonal().Transposed(),
+                  x_block.View().Submatrix(0, 0, 20, 1), 0.0,
+                  out.View().Submatrix(0, 0, 1, 1));
+  double diagonal = 0;
+  for (int i = 0; i < 20; i++) diagonal += a(10 + i, 5 + i) * x_block(i);
+  EXPECT_NEAR(out(0, 0), diagonal, 1e-9);
+
+  // x is the output vector.
+  S21Matrix small(3, 3);
+  for (int i = 0; i < 9; i++) small(i / 3, i % 3) = i + 1;
+  S21Vector v{1, 2, 3};
+  v.Gemv(1.0, small, v);
+  EXPECT_TRUE(v == S21Vector({14, 32, 50}));
+  v = S21Vector{1, 2, 3};
+  v.GemvTransposed(1.0, small, v, 1.0);
+  EXPECT_TRUE(v == S21Vector({31, 38, 45}));
+  S21Matrix strided(3, 2);
+  for (int i = 0; i < 3; i++) strided(i, 0) = i + 1;
+  s21_views::Gemv(1.0, small, strided.View().Col(0), 0.0,
+                  strided.View().Col(0));
+  EXPECT_TRUE(S21Vector(strided.View().Col(0)) == S21Vector({14, 32, 50}));
+}
+
+TEST(vectorTest, Exception) {
+  S21Vector x{1, 2, 3};
+  S21Matrix a(2, 2);
+  EXPECT_THROW(x(3), std::out_of_range);
+  EXPECT_THROW(x.Dot(S21Vector(2)), std::out_of_range);
+  EXPECT_THROW(x += S21Vector(4), std::out_of_range);
+  EXPECT_THROW(a * x, std::out_of_range);
+  EXPECT_THROW(S21Vector(a.View()), std::invalid_argument);
+  EXPECT_THROW(x.SetSize(-1), std::invalid_argument);
+  x.SetSize(5);
+  EXPECT_EQ(x(4), 0);
+  EXPECT_EQ(x(2), 3);
+}
+
+void ExpectNear(const S21Matrix& lhs, const S21Matrix& rhs, double epsilon) {
+  ASSERT_EQ(lhs.GetRows(), rhs.GetRows());
+  ASSERT_EQ(lhs.GetCols(), rhs.GetCols());
+  for (int i = 0; i < lhs.GetRows(); i++)
+    for (int j = 0; j < lhs.GetCols(); j++)
+      EXPECT_NEAR(lhs(i, j), rhs(i, j), epsilon);
+}
+
+// a * a^T + size * I, symmetric positive definite and well conditioned.
+S21Matrix PositiveDefinite(int size) {
+  S21Matrix a(size, size);
+  FillSequence(a, 6);
+  S21Matrix spd = a * a.Transpose();
+  for (int i = 0; i < size; i++) spd(i, i) += size;
+  return spd;
+}
+
+TEST(solverTest, cholesky) {
+  const int n = 150;
+  const S21Matrix a = PositiveDefinite(n);
+  S21Matrix b(n, 3);
+  FillSequence(b, 7);
+  const S21Cholesky cholesky(a);
+  ASSERT_TRUE(cholesky.IsPositiveDefinite());
+  ExpectNear(cholesky.Lower() * cholesky.Lower().Transpose(), a, 1e-8);
+  const S21Matrix x = cholesky.Solve(b);
+  ExpectNear(x, a.Solve(b), 1e-9);
+  ExpectNear(a * x, b, 1e-8);
+  const S21Matrix small = PositiveDefinite(5);
+  EXPECT_NEAR(S21Cholesky(small).Determinant(), S21LU(small).Determinant(),
+              1e-6 * std::fabs(S21LU(small).Determinant()));
+
+  S21Matrix indefinite(a);
+  indefinite(100, 100) = -1e6;
+  S21Cholesky factor(indefinite);
+  EXPECT_FALSE(factor.IsPositiveDefinite());
+  EXPECT_THROW(factor.Solve(b), std::invalid_argument);
+  EXPECT_THROW(factor.Determinant(), std::invalid_argument);
+  factor.Factor(a);
+  EXPECT_TRUE(factor.IsPositiveDefinite());
+  EXPECT_THROW(factor.Solve(S21Matrix(n - 1, 1)), std::out_of_range);
+  EXPECT_THROW(S21Cholesky(S21Matrix(2, 3)), std::invalid_argument);
+}
+
+TEST(solverTest, qr) {
+  S21Matrix a(200, 90);
+  S21Matrix b(200, 2);
+  FillSequence(a, 1);
+  FillSequence(b, 2);
+  for (int i = 0; i < 90; i++) a(i, i) += 10;
+  const S21QR qr(a);
+  ASSERT_TRUE(qr.IsFullRank());
+  const S21Matrix q = qr.Q();
+  ExpectNear(q * qr.R(), a, 1e-9);
+  S21Matrix identity(90, 90);
+  for (int i = 0; i < 90; i++) identity(i, i) = 1;
+  ExpectNear(q.Transpose() * q, identity, 1e-12);
+  // The least-squares residual is orthogonal to the columns of a.
+  const S21Matrix x = qr.Solve(b);
+  EXPECT_EQ(x.GetRows(), 90);
+  ExpectNear(a.Transpose() * (a * x - b), S21Matrix(90, 2), 1e-8);
+
+  const S21Matrix square = PositiveDefinite(70);
+  const S21Matrix rhs(b.View().Submatrix(0, 0, 70, 2));
+  ExpectNear(S21QR(square).Solve(rhs), square.Solve(rhs), 1e-9);
+
+  S21Matrix deficient(a);
+  for (int i = 0; i < 200; i++) deficient(i, 5) = 2 * deficient(i, 3);
+  EXPECT_FALSE(S21QR(deficient).IsFullRank());
+  EXPECT_THROW(S21QR(deficient).Solve(b), std::invalid_argument);
+  EXPECT_THROW(S21QR(S21Matrix(2, 3)), std::invalid_argument);
+  EXPECT_THROW(qr.Solve(S21Matrix(90, 1)), std::out_of_range);
+}
+
+TEST(solverTest, iterative) {
+  const int n = 120;
+  const S21Matrix spd = PositiveDefinite(n);
+  S21Matrix general(n, n);
+  FillSequence(general, 3);
+  for (int i = 0; i < n; i++) general(i, i) += 2 * n;
+  S21Matrix b(n, 4);
+  FillSequence(b, 5);
+  s21_solvers::Options options;
+  options.tolerance = 1e-12;
+
+  S21Vector x;
+  const S21Vector rhs(b.View().Col(0));
+  s21_solvers::Report report = s21_solvers::ConjugateGradient(
+      s21_solvers::MatrixOperator(spd), rhs, x, options);
+  EXPECT_TRUE(report.converged);
+  EXPECT_LE(report.residual, 1e-12);
+  EXPECT_TRUE(spd * x == rhs);
+  S21Vector jacobi_x;
+  const s21_solvers::Report jacobi = s21_solvers::ConjugateGradient(
+      s21_solvers::MatrixOperator(spd), rhs, jacobi_x, options,
+      s21_solvers::Jacobi(spd));
+  EXPECT_TRUE(jacobi.converged);
+  EXPECT_TRUE(jacobi_x == x);
+
+  // A small restart forces several GMRES cycles.
+  options.restart = 5;
+  options.max_iterations = 500;
+  for (const auto& preconditioner :
+       {s21_solvers::Preconditioner(), s21_solvers::Jacobi(general)}) {
+    S21Vector y;
+    report = s21_solvers::Gmres(s21_solvers::MatrixOperator(general), rhs, y,
+                                options, preconditioner);
+    EXPECT_TRUE(report.converged);
+    EXPECT_TRUE(general * y == rhs);
+  }
+
+  // Every column at once, with a matrix-free operator.
+  const s21_solvers::Operator sparse = [&](const S21Vector& in,
+                                           S21Vector& out) {
+    for (int i = 0; i < n; i++)
+      out(i) = 4 * in(i) - (i > 0 ? in(i - 1) : 0) -
+               (i + 1 < n ? in(i + 1) : 0);
+  };
+  S21Matrix tridiagonal(n, n);
+  for (int i = 0; i < n; i++) {
+    tridiagonal(i, i) = 4;
+    if (i > 0) tridiagonal(i, i - 1) = tridiagonal(i - 1, i) = -1;
+  }
+  const long threshold = S21ThreadPool::GetSerialThreshold();
+  S21ThreadPool::SetSerialThreshold(0);
+  S21ThreadPool::SetThreadCount(3);
+  for (bool cg : {true, false}) {
+    S21Matrix solution;
+    const std::vector<s21_solvers::Report> reports =
+        cg ? s21_solvers::ConjugateGradient(sparse, b, solution, options)
+           : s21_solvers::Gmres(sparse, b, solution, options);
+    ASSERT_EQ(reports.size(), 4u);
+    for (const auto& column : reports) EXPECT_TRUE(column.converged);
+    ExpectNear(tridiagonal * solution, b, 1e-9);
+  }
+  S21ThreadPool::SetThreadCount(0);
+  S21ThreadPool::SetSerialThreshold(threshold);
+
+  options.max_iterations = 2;
+  S21Vector limited;
+  report = s21_solvers::ConjugateGradient(s21_solvers::MatrixOperator(spd),
+                                          rhs, limited, options);
+  EXPECT_EQ(report.iterations, 2);
+  EXPECT_FALSE(report.converged);
+  // A zero right-hand side returns x = 0 without iterating.
+  S21Vector zero{1, 2};
+  const S21Matrix pair(2, 2);
+  EXPECT_TRUE(s21_solvers::Gmres(s21_solvers::MatrixOperator(pair),
+                                 S21Vector(2), zero)
+                  .converged);
+  EXPECT_TRUE(zero == S21Vector(2));
+  EXPECT_THROW(s21_solvers::Jacobi(S21Matrix(2, 2)), std::invalid_argument);
+}
+
+TEST(inverseTrackerTest, updates) {
+  const int n = 60;
+  S21Matrix a(n, n);
+  FillSequence(a, 4);
+  for (int i = 0; i < n; i++) a(i, i) += n;
+  S21InverseTracker tracker(a);
+  EXPECT_NEAR(tracker.Determinant(), a.Determinant(),
+              1e-9 * std::fabs(a.Determinant()));
+
+  S21Vector row(n), col(n);
+  for (int i = 0; i < n; i++) {
+    row(i) = (i % 7) - 3.0;
+    col(i) = (i % 5) * 0.5;
+  }
+  row(10) += n;
+  col(20) += n;
+  tracker.SetRow(10, row);
+  tracker.SetCol(20, col);
+  S21Vector u{1, 2}, v{3, 4};
+  u.SetSize(n);
+  v.SetSize(n);
+  tracker.RankOneUpdate(u, v);
+  // Narrow updates go through Gemv, wide ones through GEMM.
+  S21Matrix product(n, n);
+  for (int rank : {3, 8}) {
+    S21Matrix left(n, rank), right(n, rank);
+    FillSequence(left, rank);
+    FillSequence(right, 9);
+    left.MulNumber(0.1);
+    tracker.Update(left, right);
+    product += left * right.Transpose();
+  }
+  EXPECT_EQ(tracker.UpdatesSinceRefactor(), 5);
+  EXPECT_EQ(tracker.Refactorizations(), 0);
+
+  for (int i = 0; i < n; i++) a(10, i) = row(i);
+  for (int i = 0; i < n; i++) a(i, 20) = col(i);
+  for (int i = 0; i < n; i++)
+    for (int j = 0; j < n; j++) a(i, j) += u(i) * v(j);
+  a += product;
+  ExpectNear(tracker.Matrix(), a, 1e-12);
+  ExpectNear(tracker.Inverse(), a.InverseMatrix(), 1e-12);
+  EXPECT_NEAR(tracker.Determinant(), a.Determinant(),
+              1e-9 * std::fabs(a.Determinant()));
+  EXPECT_LE(tracker.Drift(), 1e-14);
+  S21Matrix b(n, 2);
+  FillSequence(b, 1);
+  ExpectNear(tracker.Solve(b), a.Solve(b), 1e-12);
+  const S21Vector x = tracker.Solve(S21Vector(b.View().Col(0)));
+  EXPECT_NEAR(x(5), tracker.Solve(b)(5, 0), 1e-15);
+
+  // A drift check after every update refactors once the error exceeds an
+  // unreachable tolerance.
+  tracker.SetCheckInterval(1);
+  tracker.SetTolerance(1e-300);
+  tracker.RankOneUpdate(v, u);
+  EXPECT_EQ(tracker.Refactorizations(), 1);
+  EXPECT_EQ(tracker.UpdatesSinceRefactor(), 0);
+}
+
+TEST(inverseTrackerTest, singular_updates) {
+  S21Matrix identity(3, 3);
+  for (int i = 0; i < 3; i++) identity(i, i) = 1;
+  S21InverseTracker tracker(identity);
+  // Zeroing the only non-zero of a row makes the matrix singular.
+  EXPECT_THROW(tracker.SetRow(1, S21Vector(3)), std::invalid_argument);
+  ExpectNear(tracker.Matrix(), identity, 0);
+  EXPECT_EQ(tracker.Determinant(), 1);
+  // 1 + v^T u close to 0 goes through a new factorization.
+  const S21Vector u{1, 0, 0}, v{-1 + 1e-9, 0, 0};
+  tracker.RankOneUpdate(u, v);
+  EXPECT_EQ(tracker.Refactorizations(), 1);
+  EXPECT_DOUBLE_EQ(tracker.Determinant(), 1 + v(0));
+  EXPECT_DOUBLE_EQ(tracker.Inverse()(0, 0), 1 / (1 + v(0)));
+
+  EXPECT_THROW(S21InverseTracker(S21Matrix(2, 3)), std::invalid_argument);
+  EXPECT_THROW(S21InverseTracker(S21Matrix(2, 2)), std::invalid_argument);
+  EXPECT_THROW(tracker.SetRow(3, S21Vector(3)), std::out_of_range);
+  EXPECT_THROW(tracker.SetCol(0, S21Vector(2)), std::out_of_range);
+  EXPECT_THROW(tracker.Update(S21Matrix(3, 2), S21Matrix(3, 1)),
+               std::out_of_range);
+  EXPECT_THROW(tracker.Solve(S21Matrix(2, 2)), std::out_of_range);
+  EXPECT_THROW(tracker.SetCheckInterval(-1), std::invalid_argument);
+  EXPECT_THROW(tracker.SetTolerance(0), std::invalid_argument);
+}
+
+// Uniform entries in [-1, 1]; FillSequence repeats itself and has a low
+// rank.
+S21Matrix RandomMatrix(int rows, int cols, unsigned seed) {
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+  S21Matrix matrix(rows, cols);
+  for (int i = 0; i < rows; i++)
+    for (int j = 0; j < cols; j++) matrix(i, j) = uniform(generator);
+  return matrix;
+}
+
+S21Matrix Identity(int size) {
+  S21Matrix identity(size, size);
+  for (int i = 0; i < size; i++) identity(i, i) = 1;
+  return identity;
+}
+
+// matrix * diag(values).
+S21Matrix ScaleColumns(S21Matrix matrix, const std::vector<double>& values) {
+  for (int i = 0; i < matrix.GetRows(); i++)
+    for (int j = 0; j < matrix.GetCols(); j++) matrix(i, j) *= values[j];
+  return matrix;
+}
+
+TEST(eigenTest, symmetric) {
+  const int n = 150;
+  const S21Matrix r = RandomMatrix(n, n, 1);
+  const S21Matrix a = r + r.Transpose();
+  const S21SymmetricEigen eigen(a);
+  ASSERT_EQ(eigen.GetSize(), n);
+  const std::vector<double>& values = eigen.Values();
+  EXPECT_TRUE(std::is_sorted(values.begin(), values.end()));
+  const S21Matrix& v = eigen.Vectors();
+  ExpectNear(a * v, ScaleColumns(v, values), 1e-11);
+  ExpectNear(v.Transpose() * v, Identity(n), 1e-12);
+  const S21SymmetricEigen values_only(a, false);
+  EXPECT_EQ(values_only.Vectors().GetRows(), 0);
+  for (int i = 0; i < n; i++)
+    EXPECT_NEAR(values_only.Values()[i], values[i], 1e-12);
+
+  // Only the lower triangle is read.
+  S21Matrix lower(a);
+  for (int i = 0; i < n; i++)
+    for (int j = i + 1; j < n; j++) lower(i, j) = 0;
+  EXPECT_EQ(S21SymmetricEigen(lower, false).Values(), values_only.Values());
+
+  // Repeated eigenvalues deflate in the merges.
+  const S21Matrix q = S21QR(RandomMatrix(n, n, 2)).Q();
+  std::vector<double> clustered(n);
+  for (int i = 0; i < n; i++) clustered[i] = i < 60 ? 1.0 : i < 100 ? 2.5 : i;
+  const S21Matrix b = ScaleColumns(q, clustered) * q.Transpose();
+  const S21SymmetricEigen repeated(b);
+  for (int i = 0; i < n; i++)
+    EXPECT_NEAR(repeated.Values()[i], clustered[i], 1e-12 * n);
+  ExpectNear(b * repeated.Vectors(),
+             ScaleColumns(repeated.Vectors(), repeated.Values()), 1e-11 * n);
+  ExpectNear(repeated.Vectors().Transpose() * repeated.Vectors(), Identity(n),
+             1e-12);
+
+  EXPECT_TRUE(S21SymmetricEigen(S21Matrix(0, 0)).Values().empty());
+  EXPECT_EQ(S21SymmetricEigen(S21Matrix(3, 3)).Values(),
+            std::vector<double>(3));
+  EXPECT_THROW(S21SymmetricEigen(S21Matrix(2, 3)), std::invalid_argument);
+}
+
+TEST(svdTest, decomposition) {
+  S21Matrix tall = RandomMatrix(140, 60, 3);
+  S21Matrix wide = RandomMatrix(50, 110, 4);
+  // FillSequence repeats every 23 rows and columns.
+  S21Matrix deficient(100, 100);
+  FillSequence(deficient, 5);
+  for (const S21Matrix* a : {&tall, &wide, &deficient}) {
+    const int k = std::min(a->GetRows(), a->GetCols());
+    const S21SVD svd(*a);
+    ASSERT_EQ(svd.U().GetRows(), a->GetRows());
+    ASSERT_EQ(svd.U().GetCols(), k);
+    ASSERT_EQ(svd.V().GetRows(), a->GetCols());
+    ASSERT_EQ(svd.V().GetCols(), k);
+    const std::vector<double>& values = svd.Values();
+    EXPECT_TRUE(std::is_sorted(values.rbegin(), values.rend()));
+    EXPECT_GE(values.back(), 0);
+    ExpectNear(ScaleColumns(svd.U(), values) * svd.V().Transpose(), *a,
+               1e-11 * k);
+    ExpectNear(svd.U().Transpose() * svd.U(), Identity(k), 1e-12);
+    ExpectNear(svd.V().Transpose() * svd.V(), Identity(k), 1e-12);
+    const S21SVD values_only(*a, false);
+    EXPECT_EQ(values_only.U().GetRows(), 0);
+    for (int i = 0; i < k; i++)
+      EXPECT_NEAR(values_only.Values()[i], values[i], 1e-12 * k);
+  }
+  EXPECT_EQ(S21SVD(tall).Rank(), 60);
+  EXPECT_EQ(S21SVD(deficient).Rank(), 23);
+  EXPECT_EQ(S21SVD(S21Matrix(4, 3)).Rank(), 0);
+
+  // Repeated, graded and zero singular values deflate in the merges.
+  const int n = 120;
+  const S21Matrix q1 = S21QR(RandomMatrix(n, n, 8)).Q();
+  const S21Matrix q2 = S21QR(RandomMatrix(n, n, 9)).Q();
+  std::vector<double> spectrum(n);
+  for (int i = 0; i < n; i++)
+    spectrum[i] = i < 40 ? 3.0 : i < 70 ? std::pow(10.0, (40 - i) / 3.0)
+                                        : i < 90 ? 1e-12 : 0.0;
+  const S21Matrix b = ScaleColumns(q1, spectrum) * q2.Transpose();
+  const S21SVD structured(b);
+  for (int i = 0; i < n; i++)
+    EXPECT_NEAR(structured.Values()[i], spectrum[i], 1e-14 * n);
+  ExpectNear(ScaleColumns(structured.U(), structured.Values()) *
+                 structured.V().Transpose(),
+             b, 1e-13 * n);
+  ExpectNear(structured.U().Transpose() * structured.U(), Identity(n), 1e-12);
+  ExpectNear(structured.V().Transpose() * structured.V(), Identity(n), 1e-12);
+  EXPECT_EQ(structured.Rank(), 90);
+}
+
+TEST(svdTest, randomized) {
+  const S21Matrix a = RandomMatrix(300, 12, 6) * RandomMatrix(12, 200, 7);
+  const S21SVD full(a);
+  EXPECT_EQ(full.Rank(), 12);
+  const S21SVD top = S21SVD::Randomized(a, 8);
+  ASSERT_EQ(top.U().GetCols(), 8);
+  ASSERT_EQ(top.V().GetCols(), 8);
+  for (int i = 0; i < 8; i++)
+    EXPECT_NEAR(top.Values()[i], full.Values()[i], 1e-10 * full.Values()[0]);
+  ExpectNear(top.U().Transpose() * top.U(), Identity(8), 1e-12);
+  ExpectNear(top.V().Transpose() * top.V(), Identity(8), 1e-12);
+  // With the whole range sampled the decomposition is exact.
+  const S21SVD exact = S21SVD::Randomized(a, 12, 4, 0);
+  ExpectNear(ScaleColumns(exact.U(), exact.Values()) * exact.V().Transpose(),
+             a, 1e-11);
+  EXPECT_THROW(S21SVD::Randomized(a, 201), std::invalid_argument);
+  EXPECT_THROW(S21SVD::Randomized(a, 5, -1), std::invalid_argument);
+}
+
+TEST(batchTest, matches_single_matrices) {
+  const int count = 13, size = 5;
+  S21MatrixBatch a(count, size, size);
+  S21MatrixBatch b(count, size, 2);
+  for (int i = 0; i < count; i++) {
+    S21Matrix matrix(size, size);
+    FillSequence(matrix, i);
+    // Diagonally dominant, with the largest entry of the first column
+    // moving around so that lanes pivot differently.
+    for (int r = 0; r < size; r++) matrix(r, r) += 4;
+    matrix(i % size, 0) += 8;
+    a.Set(i, matrix);
+    S21Matrix rhs(size, 2);
+    FillSequence(rhs, i + 40);
+    b.Set(i, rhs);
+  }
+  EXPECT_EQ(a(3, 1, 2), a.Get(3)(1, 2));
+
+  const std::vector<double> determinants = a.Determinant();
+  const S21MatrixBatch inverse = a.InverseMatrix();
+  const S21MatrixBatch product = a * b;
+  const S21MatrixBatch solution = a.Solve(b);
+  const S21MatrixBatch sum = a + a * 2.0;
+  ASSERT_EQ((int)determinants.size(), count);
+  for (int i = 0; i < count; i++) {
+    S21Matrix single = a.Get(i);
+    const double det = single.Determinant();
+    EXPECT_NEAR(determinants[i], det, 1e-9 * std::fabs(det));
+    ExpectNear(inverse.Get(i), single.InverseMatrix(), 1e-9);
+    ExpectNear(product.Get(i), single * b.Get(i), 1e-12);
+    ExpectNear(solution.Get(i), single.Solve(b.Get(i)), 1e-9);
+    ExpectNear(sum.Get(i), single * 3.0, 1e-12);
+  }
+  S21MatrixBatch identity = a * inverse;
+  for (int i = 0; i < count; i++)
+    for (int r = 0; r < size; r++)
+      for (int c = 0; c < size; c++)
+        EXPECT_NEAR(identity(i, r, c), r == c, 1e-9);
+  EXPECT_TRUE(sum - a == a * 2.0);
+  EXPECT_TRUE(sum != a);
+}
+
+TEST(batchTest, Exception) {
+  S21MatrixBatch singular(3, 2, 2);
+  singular.Set(0, S21Matrix(2, 2));
+  singular(1, 0, 0) = singular(1, 1, 1) = 1;
+  singular(2, 0, 1) = singular(2, 1, 0) = 1;
+  const std::vector<double> determinants = singular.Determinant();
+  EXPECT_EQ(determinants[0], 0);
+  EXPECT_EQ(determinants[1], 1);
+  EXPECT_EQ(determinants[2], -1);
+  EXPECT_THROW(singular.InverseMatrix(), std::invalid_argument);
+  EXPECT_THROW(singular.Solve(singular), std::invalid_argument);
+  EXPECT_THROW(singular(3, 0, 0), std::out_of_range);
+  EXPECT_THROW(singular.Set(0, S21Matrix(3, 3)), std::out_of_range);
+  EXPECT_THROW(singular += S21MatrixBatch(2, 2, 2), std::out_of_range);
+  EXPECT_THROW(singular *= S21MatrixBatch(3, 3, 2), std::out_of_range);
+  EXPECT_THROW(S21MatrixBatch(2, 2, 3).Determinant(), std::invalid_argument);
+  EXPECT_THROW(S21MatrixBatch(-1, 2, 2), std::invalid_argument);
+}
+
+TEST(ioTest, round_trip) {
+  const char* path = "s21_io_test.bin";
+  for (int size : {0, 1, 7, 130}) {
+    S21Matrix a(size, size + 3), resized(2, 2);
+    FillSequence(a, size);
+    a.Save(path);
+    EXPECT_TRUE(S21Matrix::Load(path) == a);
+    S21Matrix mapped = S21Matrix::Map(path, true);
+    EXPECT_EQ(mapped.GetRows(), size);
+    EXPECT_EQ(mapped.GetCols(), size + 3);
+    EXPECT_TRUE(mapped == a);
+    if (size == 0) continue;
+    mapped(0, 0) += 1;
+    EXPECT_TRUE(S21Matrix::Map(path) == a);
+    const S21Matrix product = mapped * a.Transpose();
+    EXPECT_TRUE(product == S21Matrix(mapped) * a.Transpose());
+    resized = std::move(mapped);
+    resized.SetSize(size + 1, size);
+    EXPECT_DOUBLE_EQ(resized(0, 0), a(0, 0) + 1);
+  }
+  // Columns dropped in place leave no trace in the row padding.
+  auto file_bytes = [&](const S21Matrix& matrix) {
+    matrix.Save(path);
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), {});
+  };
+  S21Matrix narrowed(3, 8), fresh(3, 4), out(2, 8);
+  FillSequence(narrowed, 1);
+  narrowed.SetSize(3, 4);
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 4; j++) fresh(i, j) = narrowed(i, j);
+  EXPECT_EQ(file_bytes(narrowed), file_bytes(fresh));
+  FillSequence(out, 2);
+  S21Matrix::TransposeInto(fresh, out);
+  EXPECT_EQ(file_bytes(out), file_bytes(fresh.Transpose()));
+  std::remove(path);
+}
+
+TEST(ioTest, Exception) {
+  const char* path = "s21_io_test.bin";
+  S21Matrix a(4, 5);
+  FillSequence(a, 1);
+  a.Save(path);
+  {
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(64 + 8);
+    file.put(42);
+  }
+  EXPECT_THROW(S21Matrix::Load(path), std::invalid_argument);
+  EXPECT_THROW(S21Matrix::Map(path, true), std::invalid_argument);
+  EXPECT_NO_THROW(S21Matrix::Map(path));
+  {
+    std::ofstream file(path, std::ios::binary | std::ios::app);
+    file.put(0);
+  }
+  EXPECT_THROW(S21Matrix::Load(path), std::invalid_argument);
+  EXPECT_THROW(S21Matrix::Map(path), std::invalid_argument);
+  {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << "matrix";
+  }
+  EXPECT_THROW(S21Matrix::Load(path), std::invalid_argument);
+  EXPECT_THROW(S21Matrix::Map(path), std::invalid_argument);
+  std::remove(path);
+  EXPECT_THROW(S21Matrix::Load(path), std::runtime_error);
+  EXPECT_THROW(S21Matrix::Map(path), std::runtime_error);
+}
+
+TEST(outOfCoreTest, blocks_and_product) {
+  S21Matrix a(70, 45), b(45, 90);
+  FillSequence(a, 1);
+  FillSequence(b, 2);
+  a.Save("s21_ooc_a.bin");
+  b.Save("s21_ooc_b.bin");
+  const S21MatrixFile lhs("s21_ooc_a.bin"), rhs("s21_ooc_b.bin");
+  EXPECT_EQ(lhs.GetRows(), 70);
+  EXPECT_EQ(rhs.GetCols(), 90);
+  S21Matrix block(3, 4);
+  lhs.ReadBlock(10, 20, block);
+  EXPECT_TRUE(block == S21Matrix(a.View().Submatrix(10, 20, 3, 4)));
+  S21Matrix transposed = a.Transpose();
+  lhs.ReadBlock(0, 0, transposed.View().Transposed());
+  EXPECT_TRUE(transposed == a.Transpose());
+  // 16 x 16 blocks, so every dimension ends in a partial block.
+  const std::size_t budgets[] = {5 * 16 * 16 * sizeof(double), 1 << 30};
+  for (std::size_t budget : budgets) {
+    const S21MatrixFile product = lhs.MulMatrix(rhs, "s21_ooc_c.bin", budget);
+    const S21Matrix expected = a * b;
+    EXPECT_TRUE(S21Matrix::Load("s21_ooc_c.bin") == expected);
+    EXPECT_EQ(product.GetRows(), 70);
+  }
+  S21MatrixFile written = S21MatrixFile::Create("s21_ooc_c.bin", 5, 6);
+  written.WriteBlock(1, 2, block);
+  EXPECT_THROW(S21Matrix::Load("s21_ooc_c.bin"), std::invalid_argument);
+  written.Sync();
+  const S21Matrix loaded = S21Matrix::Load("s21_ooc_c.bin");
+  EXPECT_TRUE(S21Matrix(loaded.View().Submatrix(1, 2, 3, 4)) == block);
+  EXPECT_DOUBLE_EQ(loaded(0, 0), 0);
+  std::remove("s21_ooc_a.bin");
+  std::remove("s21_ooc_b.bin");
+  std::remove("s21_ooc_c.bin");
+}
+
+TEST(outOfCoreTest, Exception) {
+  S21Matrix(3, 4).Save("s21_ooc_a.bin");
+  S21MatrixFile file("s21_ooc_a.bin");
+  S21Matrix block(2, 2);
+  EXPECT_THROW(file.ReadBlock(2, 0, block), std::out_of_range);
+  EXPECT_THROW(file.ReadBlock(0, -1, block), std::out_of_range);
+  EXPECT_THROW(file.WriteBlock(0, 0, block), std::runtime_error);
+  EXPECT_THROW(file.MulMatrix(file, "s21_ooc_c.bin", 1 << 20),
+               std::out_of_range);
+  S21MatrixFile square = S21MatrixFile::Create("s21_ooc_b.bin", 4, 4);
+  EXPECT_THROW(file.MulMatrix(square, "s21_ooc_c.bin", 64),
+               std::invalid_argument);
+  EXPECT_THROW(S21MatrixFile("s21_ooc_missing.bin"), std::runtime_error);
+  EXPECT_THROW(S21MatrixFile::Create("s21_ooc_c.bin", -1, 2),
+               std::invalid_argument);
+  std::remove("s21_ooc_a.bin");
+  std::remove("s21_ooc_b.bin");
+  std::remove("s21_ooc_c.bin");
+}
+
+TEST(strassenTest, matches_reference) {
+  // Small crossovers, so odd and rectangular shapes recurse and get padded.
+  const int shapes[][3] = {{70, 45, 90}, {100, 100, 100}, {33, 64, 17}};
+  for (const auto& shape : shapes) {
+    S21Matrix a(shape[0], shape[1]), b(shape[1], shape[2]);
+    FillSequence(a, 1);
+    FillSequence(b, 2);
+    S21Matrix expected(a);
+    expected.MulMatrixReference(b);
+    for (int crossover : {0, 8, 16}) {
+      S21Matrix product(a);
+      product.MulMatrixStrassen(b, crossover);
+      EXPECT_TRUE(product.EqMatrix(expected));
+    }
+  }
+
+  S21Matrix a(96, 80), b(80, 72);
+  FillSequence(a, 3);
+  FillSequence(b, 4);
+  S21Matrix serial(a);
+  serial.MulMatrixStrassen(b, 8);
+  const long threshold = S21ThreadPool::GetSerialThreshold();
+  S21ThreadPool::SetSerialThreshold(0);
+  S21ThreadPool::SetThreadCount(4);
+  S21Matrix parallel(a);
+  parallel.MulMatrixStrassen(b, 8);
+  ExpectBitIdentical(parallel, serial);
+  S21ThreadPool::SetThreadCount(0);
+  S21ThreadPool::SetSerialThreshold(threshold);
+}
+
+TEST(strassenTest, Exception) {
+  S21Matrix a(3, 4), b(3, 4);
+  EXPECT_THROW(a.MulMatrixStrassen(b), std::out_of_range);
+  EXPECT_THROW(a.MulMatrixStrassen(b.Transpose(), -1), std::invalid_argument);
+}
+
+constexpr S21FixedMatrix<3, 3> kFixed = {4, -2, 1, 1, 6, -2, 1, 0, 0};
+static_assert(kFixed.Determinant() == -2, "constexpr determinant");
+static_assert(kFixed.Transpose()(0, 2) == 1, "constexpr transpose");
+static_assert((kFixed * kFixed.InverseMatrix()).EqMatrix(
+                  S21FixedMatrix<3, 3>{1, 0, 0, 0, 1, 0, 0, 0, 1}),
+              "constexpr inverse");
+
+TEST(fixedMatrixTest, matches_dynamic) {
+  S21FixedMatrix<4, 4> fixed;
+  for (int i = 0; i < 4; i++)
+    for (int j = 0; j < 4; j++) fixed(i, j) = ((i * 7 + j * 3) % 5) - 2 + i * j;
+  S21Matrix dynamic = fixed;
+  EXPECT_DOUBLE_EQ(fixed.Determinant(), dynamic.Determinant());
+  EXPECT_TRUE(S21Matrix(fixed.InverseMatrix()) == dynamic.InverseMatrix());
+  EXPECT_TRUE(S21Matrix(fixed.CalcComplements()) == dynamic.CalcComplements());
+  EXPECT_TRUE(S21Matrix(fixed * fixed) == fixed.ToMatrix() * dynamic);
+  EXPECT_TRUE((S21FixedMatrix<4, 4>(dynamic) == fixed));
+
+  S21FixedMatrix<2, 3> rect = {1, 2, 3, 4, 5, 6};
+  S21FixedMatrix<3, 2> transposed = rect.Transpose();
+  S21FixedMatrix<2, 2> product = rect * transposed;
+  EXPECT_DOUBLE_EQ(product(0, 0), 14);
+  EXPECT_DOUBLE_EQ(product(1, 1), 77);
+  EXPECT_DOUBLE_EQ((product.Get<0, 1>()), 32);
+  rect *= 2;
+  rect += rect;
+  rect -= S21FixedMatrix<2, 3>{1, 1, 1, 1, 1, 1};
+  EXPECT_DOUBLE_EQ(rect(1, 2), 23);
+
+  S21FixedMatrix<1, 1> single = {4};
+  EXPECT_DOUBLE_EQ(single.InverseMatrix()(0, 0), 0.25);
+}
+
+TEST(fixedMatrixTest, Exception) {
+  S21FixedMatrix<3, 3> singular = {1, 1, 3, 4, 4, 6, 4, 4, 9};
+  EXPECT_ANY_THROW(singular.InverseMatrix());
+  S21FixedMatrix<5, 5> singular_large;
+  EXPECT_DOUBLE_EQ(singular_large.Determinant(), 0);
+  EXPECT_ANY_THROW(singular_large.InverseMatrix());
+  S21Matrix wrong(2, 3);
+  EXPECT_ANY_THROW((S21FixedMatrix<3, 2>(wrong)));
+  EXPECT_ANY_THROW((S21FixedMatrix<2, 2>{1, 2, 3}));
+}
+
+// The closed-form determinant of these overflows or underflows; the
+// inverse must not depend on it.
+TEST(fixedMatrixTest, inverse_scaling) {
+  S21FixedMatrix<3, 3> huge = {2e150, 1e150, 0, 0, 1e150, 0, 0, 0, 1e150};
+  S21FixedMatrix<2, 2> diagonal = {1e200, 0, 0, 1e200};
+  S21FixedMatrix<3, 3> tiny = huge * 1e-260;
+  const S21Matrix expected = huge.ToMatrix().InverseMatrix();
+  const S21FixedMatrix<3, 3> inverse = huge.InverseMatrix();
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      EXPECT_DOUBLE_EQ(inverse(i, j) * 1e150, expected(i, j) * 1e150);
+      EXPECT_DOUBLE_EQ(tiny.InverseMatrix()(i, j) * 1e-110,
+                       expected(i, j) * 1e150);
+    }
+  }
+  EXPECT_DOUBLE_EQ(diagonal.InverseMatrix()(1, 1), 1e-200);
+  S21FixedMatrix<3, 3> singular = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+  EXPECT_THROW((singular * 1e150).InverseMatrix(), std::invalid_argument);
+  EXPECT_THROW((singular * 1e-150).InverseMatrix(), std::invalid_argument);
+  EXPECT_THROW((S21FixedMatrix<2, 2>{}).InverseMatrix(),
+               std::invalid_argument);
+}
+
+static_assert(std::is_same<BasicS21Matrix<double>, S21Matrix>::value,
+              "S21Matrix is the double matrix");
+
+// The same checks for every element type.
+template <typename T>
+void CheckElementType() {
+  using Matrix = BasicS21Matrix<T>;
+  const double values[] = {2, 5, 7, 6, 3, 4, 5, -2, -3};
+  Matrix a(3, 3), identity(3, 3), expected(3, 3);
+  for (int i = 0; i < 9; i++) a(i / 3, i % 3) = T(values[i]);
+  for (int i = 0; i < 3; i++) identity(i, i) = T(1);
+  const Matrix& constant = a;
+  EXPECT_LE(std::abs(constant.Determinant() - T(-1)), 1e-4);
+  const Matrix inverse = constant.InverseMatrix();
+  const Matrix product = a * inverse;
+  EXPECT_TRUE(product == identity);
+  EXPECT_TRUE(constant.Multiply(inverse) == identity);
+  Matrix complements = constant.CalcComplements();
+  const Matrix adjugate = complements.Transpose() * T(-1);
+  EXPECT_TRUE(adjugate == inverse);
+  expected = a * T(3);
+  a += a;
+  a += a * T(0.5);
+  EXPECT_TRUE(a == expected);
+  a -= expected;
+  EXPECT_TRUE(a == Matrix(3, 3));
+  EXPECT_THROW(a.InverseMatrix(), std::invalid_argument);
+  EXPECT_THROW(a(3, 0), std::out_of_range);
+  EXPECT_THROW(a *= Matrix(2, 2), std::out_of_range);
+  EXPECT_THROW(Matrix(2, 3).Determinant(), std::invalid_argument);
+  Matrix nan(1, 1);
+  nan(0, 0) = T(NAN);
+  EXPECT_TRUE(nan == Matrix(1, 1));
+}
+
+TEST(genericMatrixTest, element_types) {
+  CheckElementType<float>();
+  CheckElementType<double>();
+  CheckElementType<long double>();
+  CheckElementType<std::complex<double>>();
+}
+
+TEST(genericMatrixTest, complex_values) {
+  using Complex = std::complex<double>;
+  BasicS21Matrix<Complex> a(2, 2);
+  a(0, 0) = Complex(1, 1), a(0, 1) = Complex(2, 0);
+  a(1, 0) = Complex(0, -1), a(1, 1) = Complex(3, 2);
+  const Complex det = a.Determinant();
+  EXPECT_NEAR(det.real(), 1, 1e-12);
+  EXPECT_NEAR(det.imag(), 7, 1e-12);
+  BasicS21Matrix<Complex> identity(2, 2);
+  identity(0, 0) = identity(1, 1) = 1;
+  EXPECT_TRUE(a * a.InverseMatrix() == identity);
+  EXPECT_FALSE(a == a * Complex(0, 1));
+
+  // Large enough for the packed GEMM path, as four real products.
+  const int m = 40, k = 50, n = 30;
+  BasicS21Matrix<Complex> lhs(m, k), rhs(k, n), expected(m, n);
+  for (int i = 0; i < m; i++)
+    for (int p = 0; p < k; p++) lhs(i, p) = Complex(i - p, (i * p) % 7 - 3);
+  for (int p = 0; p < k; p++)
+    for (int j = 0; j < n; j++) rhs(p, j) = Complex((p + j) % 5, p - 2 * j);
+  for (int i = 0; i < m; i++)
+    for (int j = 0; j < n; j++)
+      for (int p = 0; p < k; p++) expected(i, j) += lhs(i, p) * rhs(p, j);
+  EXPECT_TRUE(lhs * rhs == expected);
+  const BasicS21Matrix<std::complex<float>> single =
+      BasicS21Matrix<std::complex<float>>(lhs.View()) *
+      BasicS21Matrix<std::complex<float>>(rhs.View());
+  for (int i = 0; i < m; i++) {
+    for (int j = 0; j < n; j++) {
+      EXPECT_FLOAT_EQ(single(i, j).real(), expected(i, j).real());
+      EXPECT_FLOAT_EQ(single(i, j).imag(), expected(i, j).imag());
+    }
+  }
+}
+
+TEST(genericMatrixTest, conversion_and_mixed_precision) {
+  S21Matrix dense(4, 5);
+  FillSequence(dense, 3);
+  BasicS21Matrix<float> single(dense.View());
+  const BasicS21Matrix<long double> extended(single.View());
+  EXPECT_FLOAT_EQ(single(3, 4), dense(3, 4));
+  EXPECT_EQ(extended(2, 1), (long double)single(2, 1));
+  single.SetSize(2, 6);
+  EXPECT_FLOAT_EQ(single(1, 4), dense(1, 4));
+  EXPECT_EQ(single(1, 5), 0);
+  // Summed in float, every 1 added to 1e8 would be lost.
+  const int n = 1000;
+  BasicS21Matrix<float> row(1, n + 1), ones(n + 1, 1);
+  for (int i = 0; i <= n; i++) row(0, i) = i == 0 ? 1e8f : 1, ones(i, 0) = 1;
+  EXPECT_EQ((row * ones)(0, 0), 1e8f + n);
+  // The same through the packed GEMM path.
+  const int size = 64;
+  BasicS21Matrix<float> rows(size, n + 1), columns(n + 1, size);
+  for (int r = 0; r < size; r++) {
+    for (int i = 0; i <= n; i++) {
+      rows(r, i) = i == 0 ? 1e8f : 1;
+      columns(i, r) = 1;
+    }
+  }
+  const BasicS21Matrix<float> sums = rows * columns;
+  for (int r = 0; r < size; r++)
+    for (int c = 0; c < size; c++) EXPECT_EQ(sums(r, c), 1e8f + n);
+}
+
+TEST(statsTest, shape_buckets) {
+  EXPECT_EQ(s21_stats::ShapeBucket(0, 7), 0);
+  EXPECT_EQ(s21_stats::ShapeBucket(1, 1), 1);
+  EXPECT_EQ(s21_stats::ShapeBucket(3, 2), 2);
+  EXPECT_EQ(s21_stats::ShapeBucket(5, 64), 7);
+  EXPECT_EQ(s21_stats::ShapeBucket(1 << 20, 1), s21_stats::kShapeBuckets - 1);
+  EXPECT_EQ(s21_stats::ShapeLabel(0), "0");
+  EXPECT_EQ(s21_stats::ShapeLabel(2), "2-3");
+  EXPECT_EQ(s21_stats::ShapeLabel(7), "64-127");
+  EXPECT_EQ(s21_stats::ShapeLabel(s21_stats::kShapeBuckets - 1), "16384+");
+}
+
+s21_stats::Counters StatsFor(const std::vector<s21_stats::Entry>& entries,
+                             s21_stats::Operation operation, int size) {
+  for (const s21_stats::Entry& entry : entries)
+    if (entry.operation == operation &&
+        entry.bucket == s21_stats::ShapeBucket(size, size))
+      return entry.counters;
+  return {};
+}
+
+TEST(statsTest, counters) {
+  if (!s21_stats::kEnabled) GTEST_SKIP();
+  using s21_stats::Operation;
+  const int n = 48;
+  S21Matrix a(n, n), b(n, n);
+  FillSequence(a, 1);
+  FillSequence(b, 2);
+  s21_stats::Reset();
+  a.MulMatrix(b);
+  a.MulMatrix(b);
+  // Counters of threads that have exited are kept.
+  std::thread worker([&b] {
+    S21Matrix c(b);
+    c.SumMatrix(b);
+  });
+  worker.join();
+  const std::vector<s21_stats::Entry> entries = s21_stats::Snapshot();
+  const s21_stats::Counters mul = StatsFor(entries, Operation::kMulMatrix, n);
+  EXPECT_EQ(mul.calls, 2u);
+  EXPECT_EQ(mul.flops, 4u * n * n * n);
+  EXPECT_GE(mul.bytes, 2u * n * n * sizeof(double));
+  EXPECT_GT(mul.seconds, 0);
+  const s21_stats::Counters sum = StatsFor(entries, Operation::kSum, n);
+  EXPECT_EQ(sum.calls, 1u);
+  EXPECT_EQ(sum.flops, (unsigned)(n * n));
+  EXPECT_EQ(sum.bytes, 0u);
+  const s21_stats::Counters copy = StatsFor(entries, Operation::kAllocate, n);
+  EXPECT_EQ(copy.calls, 1u);
+  EXPECT_GE(copy.bytes, n * n * sizeof(double));
+  EXPECT_EQ(StatsFor(entries, Operation::kInverse, n).calls, 0u);
+
+  const std::string json = s21_stats::ToJson(entries);
+  EXPECT_NE(json.find("{\"operation\": \"MulMatrix\", \"shape\": \"32-63\", "
+                      "\"calls\": 2, "),
+            std::string::npos);
+  const std::string text = s21_stats::ToPrometheus(entries);
+  EXPECT_NE(text.find("# TYPE s21_matrix_calls_total counter\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("s21_matrix_flops_total{operation=\"SumMatrix\","
+                      "shape=\"32-63\"} 2304\n"),
+            std::string::npos);
+
+  s21_stats::Reset();
+  EXPECT_TRUE(s21_stats::Snapshot().empty());
+  EXPECT_EQ(s21_stats::ToJson({}), "{\"entries\": []}\n");
+
+  // Expressions count as the operation at their root, one flop per node
+  // and element; buffers grown by SetSize and Reserve count as Allocate.
+  S21Matrix out(n, n);
+  s21_stats::Reset();
+  S21Matrix::SumMatrixInto(a, b, out);
+  out = a * 2.0 - b;
+  S21Matrix::MulNumberInto(a, 0.5, out);
+  out.TransposeInPlace();
+  out.MulMatrixReference(b);
+  out.MulMatrixStrassen(b);
+  S21Matrix grown(1, 1);
+  grown.SetSize(n, n);
+  grown.Reserve(2 * n, 2 * n);
+  const std::vector<s21_stats::Entry> more = s21_stats::Snapshot();
+  EXPECT_EQ(StatsFor(more, Operation::kSum, n).calls, 1u);
+  EXPECT_EQ(StatsFor(more, Operation::kSum, n).flops, (unsigned)(n * n));
+  EXPECT_EQ(StatsFor(more, Operation::kSub, n).flops, 2u * n * n);
+  EXPECT_EQ(StatsFor(more, Operation::kMulNumber, n).calls, 1u);
+  EXPECT_EQ(StatsFor(more, Operation::kTranspose, n).calls, 1u);
+  EXPECT_EQ(StatsFor(more, Operation::kMulMatrix, n).calls, 2u);
+  EXPECT_EQ(StatsFor(more, Operation::kAllocate, 1).calls, 1u);
+  EXPECT_GE(StatsFor(more, Operation::kAllocate, n).bytes,
+            n * n * sizeof(double));
+  EXPECT_GE(StatsFor(more, Operation::kAllocate, 2 * n).bytes,
+            4 * n * n * sizeof(double));
+  s21_stats::Reset();
+}
+
 int main(int argc, char *argv[]) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
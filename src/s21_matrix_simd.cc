@@ -0,0 +1,372 @@
+#include "s21_matrix_simd.h"
+
+#include <atomic>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define S21_SIMD_X86 1
+#endif
+
+// The avx512f target implies FMA, and fused multiply-adds would make the
+// reductions round differently from the other levels.
+#pragma GCC optimize("fp-contract=off")
+
+namespace s21_kernels {
+
+namespace {
+
+struct ElementwiseKernels {
+  void (*add)(double*, const double*, std::size_t);
+  void (*sub)(double*, const double*, std::size_t);
+  void (*scale)(double*, double, std::size_t);
+  bool (*all_close)(const double*, const double*, std::size_t, double);
+  void (*axpy)(double*, double, const double*, std::size_t);
+  double (*dot)(const double*, const double*, std::size_t);
+  double (*abs_sum)(const double*, std::size_t);
+  double (*sum_squares)(const double*, std::size_t);
+  double (*abs_max)(const double*, std::size_t);
+};
+
+constexpr int kLanes = kReductionLanes;
+
+void AddScalar(double* dst, const double* src, std::size_t size) {
+  for (std::size_t i = 0; i < size; i++) dst[i] += src[i];
+}
+
+void SubScalar(double* dst, const double* src, std::size_t size) {
+  for (std::size_t i = 0; i < size; i++) dst[i] -= src[i];
+}
+
+void ScaleScalar(double* dst, double num, std::size_t size) {
+  for (std::size_t i = 0; i < size; i++) dst[i] *= num;
+}
+
+bool AllCloseScalar(const double* lhs, const double* rhs, std::size_t size,
+                    double epsilon) {
+  for (std::size_t i = 0; i < size; i++) {
+    const double diff = lhs[i] - rhs[i];
+    if ((diff < 0 ? -diff : diff) > epsilon) return false;
+  }
+  return true;
+}
+
+void AxpyScalar(double* y, double alpha, const double* x, std::size_t size) {
+  for (std::size_t i = 0; i < size; i++) y[i] += alpha * x[i];
+}
+
+// Same comparison as the max instructions: NaN in value is never taken.
+double Max(double value, double max) { return value > max ? value : max; }
+
+// Folds the lanes of a sum pairwise, then adds the terms from index i on.
+template <typename Term>
+double FinishSum(double* lanes, std::size_t i, std::size_t size, Term term) {
+  for (int width = kLanes / 2; width > 0; width /= 2)
+    for (int lane = 0; lane < width; lane++) lanes[lane] += lanes[lane + width];
+  double sum = lanes[0];
+  for (; i < size; i++) sum += term(i);
+  return sum;
+}
+
+template <typename Term>
+double FinishMax(double* lanes, std::size_t i, std::size_t size, Term term) {
+  for (int width = kLanes / 2; width > 0; width /= 2)
+    for (int lane = 0; lane < width; lane++)
+      lanes[lane] = Max(lanes[lane + width], lanes[lane]);
+  double max = lanes[0];
+  for (; i < size; i++) max = Max(term(i), max);
+  return max;
+}
+
+template <typename Term>
+double SumScalar(std::size_t size, Term term) {
+  double lanes[kLanes] = {};
+  std::size_t i = 0;
+  for (; i + kLanes <= size; i += kLanes)
+    for (int lane = 0; lane < kLanes; lane++) lanes[lane] += term(i + lane);
+  return FinishSum(lanes, i, size, term);
+}
+
+double DotScalar(const double* lhs, const double* rhs, std::size_t size) {
+  return SumScalar(size, [&](std::size_t i) { return lhs[i] * rhs[i]; });
+}
+
+double AbsSumScalar(const double* src, std::size_t size) {
+  return SumScalar(size, [&](std::size_t i) { return std::fabs(src[i]); });
+}
+
+double SumSquaresScalar(const double* src, std::size_t size) {
+  return SumScalar(size, [&](std::size_t i) { return src[i] * src[i]; });
+}
+
+double AbsMaxScalar(const double* src, std::size_t size) {
+  double lanes[kLanes] = {};
+  std::size_t i = 0;
+  for (; i + kLanes <= size; i += kLanes)
+    for (int lane = 0; lane < kLanes; lane++)
+      lanes[lane] = Max(std::fabs(src[i + lane]), lanes[lane]);
+  return FinishMax(lanes, i, size,
+                   [&](std::size_t j) { return std::fabs(src[j]); });
+}
+
+#ifdef S21_SIMD_X86
+
+// Each variant handles full vectors and leaves the tail to the scalar loop,
+// so results are bit-identical to the scalar kernels.
+#define S21_DEFINE_X86_KERNELS(SUFFIX, TARGET, VEC, WIDTH, LOAD, STORE, SET1, \
+                               ADD, SUB, MUL, ABS_DIFF_GT)                    \
+  __attribute__((target(TARGET))) void Add##SUFFIX(                          \
+      double* dst, const double* src, std::size_t size) {                    \
+    std::size_t i = 0;                                                       \
+    for (; i + WIDTH <= size; i += WIDTH)                                    \
+      STORE(dst + i, ADD(LOAD(dst + i), LOAD(src + i)));                     \
+    AddScalar(dst + i, src + i, size - i);                                   \
+  }                                                                          \
+  __attribute__((target(TARGET))) void Sub##SUFFIX(                          \
+      double* dst, const double* src, std::size_t size) {                    \
+    std::size_t i = 0;                                                       \
+    for (; i + WIDTH <= size; i += WIDTH)                                    \
+      STORE(dst + i, SUB(LOAD(dst + i), LOAD(src + i)));                     \
+    SubScalar(dst + i, src + i, size - i);                                   \
+  }                                                                          \
+  __attribute__((target(TARGET))) void Scale##SUFFIX(                        \
+      double* dst, double num, std::size_t size) {                           \
+    const VEC factor = SET1(num);                                            \
+    std::size_t i = 0;                                                       \
+    for (; i + WIDTH <= size; i += WIDTH)                                    \
+      STORE(dst + i, MUL(LOAD(dst + i), factor));                            \
+    ScaleScalar(dst + i, num, size - i);                                     \
+  }                                                                          \
+  __attribute__((target(TARGET))) bool AllClose##SUFFIX(                     \
+      const double* lhs, const double* rhs, std::size_t size,                \
+      double epsilon) {                                                      \
+    const VEC eps = SET1(epsilon);                                           \
+    std::size_t i = 0;                                                       \
+    for (; i + WIDTH <= size; i += WIDTH) {                                  \
+      if (ABS_DIFF_GT(LOAD(lhs + i), LOAD(rhs + i), eps)) return false;      \
+    }                                                                        \
+    return AllCloseScalar(lhs + i, rhs + i, size - i, epsilon);              \
+  }
+
+// Ordered compares keep NaN differences "close", like the scalar branch.
+#define S21_SSE2_ABS_DIFF_GT(a, b, eps)                                    \
+  (_mm_movemask_pd(_mm_cmpgt_pd(                                           \
+       _mm_andnot_pd(_mm_set1_pd(-0.0), _mm_sub_pd(a, b)), eps)) != 0)
+#define S21_AVX2_ABS_DIFF_GT(a, b, eps)                                    \
+  (_mm256_movemask_pd(_mm256_cmp_pd(                                       \
+       _mm256_andnot_pd(_mm256_set1_pd(-0.0), _mm256_sub_pd(a, b)), eps,   \
+       _CMP_GT_OQ)) != 0)
+#define S21_AVX512_ABS_DIFF_GT(a, b, eps) \
+  (_mm512_cmp_pd_mask(_mm512_abs_pd(_mm512_sub_pd(a, b)), eps, _CMP_GT_OQ) != 0)
+
+S21_DEFINE_X86_KERNELS(Sse2, "sse2", __m128d, 2, _mm_loadu_pd, _mm_storeu_pd,
+                       _mm_set1_pd, _mm_add_pd, _mm_sub_pd, _mm_mul_pd,
+                       S21_SSE2_ABS_DIFF_GT)
+S21_DEFINE_X86_KERNELS(Avx2, "avx2", __m256d, 4, _mm256_loadu_pd,
+                       _mm256_storeu_pd, _mm256_set1_pd, _mm256_add_pd,
+                       _mm256_sub_pd, _mm256_mul_pd, S21_AVX2_ABS_DIFF_GT)
+S21_DEFINE_X86_KERNELS(Avx512, "avx512f", __m512d, 8, _mm512_loadu_pd,
+                       _mm512_storeu_pd, _mm512_set1_pd, _mm512_add_pd,
+                       _mm512_sub_pd, _mm512_mul_pd, S21_AVX512_ABS_DIFF_GT)
+
+// Lane l of the scalar reductions is element l of vector l / WIDTH here.
+#define S21_DEFINE_X86_REDUCTIONS(SUFFIX, TARGET, VEC, WIDTH, LOAD, STORE,    \
+                                  SET1, ADD, MUL, ABS, MAX)                  \
+  __attribute__((target(TARGET))) void Axpy##SUFFIX(                         \
+      double* y, double alpha, const double* x, std::size_t size) {          \
+    const VEC factor = SET1(alpha);                                          \
+    std::size_t i = 0;                                                       \
+    for (; i + WIDTH <= size; i += WIDTH)                                    \
+      STORE(y + i, ADD(LOAD(y + i), MUL(factor, LOAD(x + i))));              \
+    AxpyScalar(y + i, alpha, x + i, size - i);                               \
+  }                                                                          \
+  __attribute__((target(TARGET))) double Dot##SUFFIX(                        \
+      const double* lhs, const double* rhs, std::size_t size) {              \
+    VEC acc[kLanes / WIDTH];                                                 \
+    for (VEC& vec : acc) vec = SET1(0.0);                                    \
+    std::size_t i = 0;                                                       \
+    for (; i + kLanes <= size; i += kLanes)                                  \
+      for (int v = 0; v < kLanes / WIDTH; v++)                               \
+        acc[v] = ADD(acc[v], MUL(LOAD(lhs + i + v * WIDTH),                  \
+                                 LOAD(rhs + i + v * WIDTH)));                \
+    double lanes[kLanes];                                                    \
+    for (int v = 0; v < kLanes / WIDTH; v++) STORE(lanes + v * WIDTH, acc[v]); \
+    return FinishSum(lanes, i, size,                                         \
+                     [&](std::size_t j) { return lhs[j] * rhs[j]; });        \
+  }                                                                          \
+  __attribute__((target(TARGET))) double AbsSum##SUFFIX(const double* src,   \
+                                                        std::size_t size) {  \
+    VEC acc[kLanes / WIDTH];                                                 \
+    for (VEC& vec : acc) vec = SET1(0.0);                                    \
+    std::size_t i = 0;                                                       \
+    for (; i + kLanes <= size; i += kLanes)                                  \
+      for (int v = 0; v < kLanes / WIDTH; v++)                               \
+        acc[v] = ADD(acc[v], ABS(LOAD(src + i + v * WIDTH)));                \
+    double lanes[kLanes];                                                    \
+    for (int v = 0; v < kLanes / WIDTH; v++) STORE(lanes + v * WIDTH, acc[v]); \
+    return FinishSum(lanes, i, size,                                         \
+                     [&](std::size_t j) { return std::fabs(src[j]); });      \
+  }                                                                          \
+  __attribute__((target(TARGET))) double SumSquares##SUFFIX(                 \
+      const double* src, std::size_t size) {                                 \
+    VEC acc[kLanes / WIDTH];                                                 \
+    for (VEC& vec : acc) vec = SET1(0.0);                                    \
+    std::size_t i = 0;                                                       \
+    for (; i + kLanes <= size; i += kLanes)                                  \
+      for (int v = 0; v < kLanes / WIDTH; v++) {                             \
+        const VEC value = LOAD(src + i + v * WIDTH);                         \
+        acc[v] = ADD(acc[v], MUL(value, value));                             \
+      }                                                                      \
+    double lanes[kLanes];                                                    \
+    for (int v = 0; v < kLanes / WIDTH; v++) STORE(lanes + v * WIDTH, acc[v]); \
+    return FinishSum(lanes, i, size,                                         \
+                     [&](std::size_t j) { return src[j] * src[j]; });        \
+  }                                                                          \
+  __attribute__((target(TARGET))) double AbsMax##SUFFIX(const double* src,   \
+                                                        std::size_t size) {  \
+    VEC acc[kLanes / WIDTH];                                                 \
+    for (VEC& vec : acc) vec = SET1(0.0);                                    \
+    std::size_t i = 0;                                                       \
+    for (; i + kLanes <= size; i += kLanes)                                  \
+      for (int v = 0; v < kLanes / WIDTH; v++)                               \
+        acc[v] = MAX(ABS(LOAD(src + i + v * WIDTH)), acc[v]);                \
+    double lanes[kLanes];                                                    \
+    for (int v = 0; v < kLanes / WIDTH; v++) STORE(lanes + v * WIDTH, acc[v]); \
+    return FinishMax(lanes, i, size,                                         \
+                     [&](std::size_t j) { return std::fabs(src[j]); });      \
+  }
+
+#define S21_SSE2_ABS(a) _mm_andnot_pd(_mm_set1_pd(-0.0), a)
+#define S21_AVX2_ABS(a) _mm256_andnot_pd(_mm256_set1_pd(-0.0), a)
+// The zero-masked form avoids _mm512_undefined_pd, which GCC 12 reports as
+// uninitialized.
+#define S21_AVX512_MAX(a, b) _mm512_maskz_max_pd(0xFF, a, b)
+
+S21_DEFINE_X86_REDUCTIONS(Sse2, "sse2", __m128d, 2, _mm_loadu_pd,
+                          _mm_storeu_pd, _mm_set1_pd, _mm_add_pd, _mm_mul_pd,
+                          S21_SSE2_ABS, _mm_max_pd)
+S21_DEFINE_X86_REDUCTIONS(Avx2, "avx2", __m256d, 4, _mm256_loadu_pd,
+                          _mm256_storeu_pd, _mm256_set1_pd, _mm256_add_pd,
+                          _mm256_mul_pd, S21_AVX2_ABS, _mm256_max_pd)
+S21_DEFINE_X86_REDUCTIONS(Avx512, "avx512f", __m512d, 8, _mm512_loadu_pd,
+                          _mm512_storeu_pd, _mm512_set1_pd, _mm512_add_pd,
+                          _mm512_mul_pd, _mm512_abs_pd, S21_AVX512_MAX)
+
+#undef S21_SSE2_ABS
+#undef S21_AVX2_ABS
+#undef S21_AVX512_MAX
+#undef S21_DEFINE_X86_REDUCTIONS
+#undef S21_SSE2_ABS_DIFF_GT
+#undef S21_AVX2_ABS_DIFF_GT
+#undef S21_AVX512_ABS_DIFF_GT
+#undef S21_DEFINE_X86_KERNELS
+
+#endif  // S21_SIMD_X86
+
+const ElementwiseKernels kScalarKernels = {
+    AddScalar, SubScalar,    ScaleScalar,      AllCloseScalar, AxpyScalar,
+    DotScalar, AbsSumScalar, SumSquaresScalar, AbsMaxScalar};
+#ifdef S21_SIMD_X86
+const ElementwiseKernels kSse2Kernels = {
+    AddSse2, SubSse2,    ScaleSse2,      AllCloseSse2, AxpySse2,
+    DotSse2, AbsSumSse2, SumSquaresSse2, AbsMaxSse2};
+const ElementwiseKernels kAvx2Kernels = {
+    AddAvx2, SubAvx2,    ScaleAvx2,      AllCloseAvx2, AxpyAvx2,
+    DotAvx2, AbsSumAvx2, SumSquaresAvx2, AbsMaxAvx2};
+const ElementwiseKernels kAvx512Kernels = {
+    AddAvx512, SubAvx512,    ScaleAvx512,      AllCloseAvx512, AxpyAvx512,
+    DotAvx512, AbsSumAvx512, SumSquaresAvx512, AbsMaxAvx512};
+#endif
+
+const ElementwiseKernels& KernelsFor(SimdLevel level) {
+#ifdef S21_SIMD_X86
+  switch (level) {
+    case SimdLevel::kAvx512:
+      return kAvx512Kernels;
+    case SimdLevel::kAvx2:
+      return kAvx2Kernels;
+    case SimdLevel::kSse2:
+      return kSse2Kernels;
+    case SimdLevel::kScalar:
+      break;
+  }
+#else
+  (void)level;
+#endif
+  return kScalarKernels;
+}
+
+SimdLevel Detect() {
+#ifdef S21_SIMD_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) return SimdLevel::kAvx512;
+  if (__builtin_cpu_supports("avx2")) return SimdLevel::kAvx2;
+  if (__builtin_cpu_supports("sse2")) return SimdLevel::kSse2;
+#endif
+  return SimdLevel::kScalar;
+}
+
+std::atomic<SimdLevel>& ActiveLevel() {
+  static std::atomic<SimdLevel> level(DetectedSimdLevel());
+  return level;
+}
+
+const ElementwiseKernels& Active() {
+  return KernelsFor(ActiveLevel().load(std::memory_order_relaxed));
+}
+
+}  // namespace
+
+SimdLevel DetectedSimdLevel() {
+  static const SimdLevel detected = Detect();
+  return detected;
+}
+
+SimdLevel ActiveSimdLevel() {
+  return ActiveLevel().load(std::memory_order_relaxed);
+}
+
+SimdLevel SetSimdLevel(SimdLevel level) {
+  if (level > DetectedSimdLevel()) level = DetectedSimdLevel();
+  ActiveLevel().store(level, std::memory_order_relaxed);
+  return level;
+}
+
+void Add(double* dst, const double* src, std::size_t size) {
+  Active().add(dst, src, size);
+}
+
+void Sub(double* dst, const double* src, std::size_t size) {
+  Active().sub(dst, src, size);
+}
+
+void Scale(double* dst, double num, std::size_t size) {
+  Active().scale(dst, num, size);
+}
+
+bool AllClose(const double* lhs, const double* rhs, std::size_t size,
+              double epsilon) {
+  return Active().all_close(lhs, rhs, size, epsilon);
+}
+
+void Axpy(double* y, double alpha, const double* x, std::size_t size) {
+  Active().axpy(y, alpha, x, size);
+}
+
+double Dot(const double* lhs, const double* rhs, std::size_t size) {
+  return Active().dot(lhs, rhs, size);
+}
+
+double AbsSum(const double* src, std::size_t size) {
+  return Active().abs_sum(src, size);
+}
+
+double SumSquares(const double* src, std::size_t size) {
+  return Active().sum_squares(src, size);
+}
+
+double AbsMax(const double* src, std::size_t size) {
+  return Active().abs_max(src, size);
+}
+
+}  // namespace s21_kernels
@@ -0,0 +1,37 @@
+#ifndef SRC_S21_MATRIX_SIMD_
+#define SRC_S21_MATRIX_SIMD_
+
+#include <cstddef>
+
+namespace s21_kernels {
+
+enum class SimdLevel { kScalar, kSse2, kAvx2, kAvx512 };
+
+// Best level the running CPU supports, detected once via CPUID.
+SimdLevel DetectedSimdLevel();
+SimdLevel ActiveSimdLevel();
+// Selects the kernels used from now on; requests above the detected level
+// are clamped to it. Returns the level actually selected.
+SimdLevel SetSimdLevel(SimdLevel level);
+
+void Add(double* dst, const double* src, std::size_t size);
+void Sub(double* dst, const double* src, std::size_t size);
+void Scale(double* dst, double num, std::size_t size);
+// True if |lhs[i] - rhs[i]| <= epsilon for every i (NaN differences pass,
+// as in the scalar comparison).
+bool AllClose(const double* lhs, const double* rhs, std::size_t size,
+              double epsilon);
+// y += alpha * x.
+void Axpy(double* y, double alpha, const double* x, std::size_t size);
+// Reductions keep kReductionLanes interleaved partial results that are
+// combined in a fixed order, so every level gives the same bits. AbsMax
+// ignores NaN elements.
+constexpr int kReductionLanes = 16;
+double Dot(const double* lhs, const double* rhs, std::size_t size);
+double AbsSum(const double* src, std::size_t size);
+double SumSquares(const double* src, std::size_t size);
+double AbsMax(const double* src, std::size_t size);
+
+}  // namespace s21_kernels
+
+#endif  // SRC_S21_MATRIX_SIMD_
@@ -0,0 +1,442 @@
+#include "s21_matrix_solvers.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+
+#include "s21_matrix_gemm.h"
+#include "s21_matrix_householder.h"
+#include "s21_matrix_simd.h"
+#include "s21_thread_pool.h"
+
+namespace {
+
+using s21_kernels::Op;
+
+// Columns per panel of the factorizations and rows per block of the
+// triangular solves.
+constexpr int kBlock = 64;
+// Rows of the trailing matrix per GEMM call in the Cholesky update; each
+// call stops at the diagonal, so the upper triangle is mostly skipped.
+constexpr int kUpdateRows = 256;
+
+// Solves T * X = X in place for a lower or upper triangular t with a
+// non-zero diagonal; the rows of x must be contiguous. The rows already
+// solved enter each block of kBlock rows as one GEMM product, the rest is
+// substitution inside the block.
+void SolveTriangular(S21ConstMatrixView t, bool lower, S21MatrixView x) {
+  const int n = t.GetRows(), k = x.GetCols();
+  if (k == 0) return;
+  S21Matrix update;
+  for (int done = 0; done < n; done += kBlock) {
+    const int rows = std::min(kBlock, n - done);
+    const int first = lower ? done : n - done - rows;
+    const int solved = lower ? 0 : first + rows;
+    const S21MatrixView block = x.Submatrix(first, 0, rows, k);
+    if (done > 0) {
+      update.SetSize(rows, k);
+      s21_views::Multiply(t.Submatrix(first, solved, rows, done),
+                          x.Submatrix(solved, 0, done, k), update);
+      s21_views::Sub(update, block);
+    }
+    for (int step = 0; step < rows; step++) {
+      const int i = lower ? step : rows - 1 - step;
+      double* dst = block.RowData(i);
+      const int from = lower ? 0 : i + 1, to = lower ? i : rows;
+      for (int j = from; j < to; j++)
+        s21_kernels::Axpy(dst, -t.At(first + i, first + j), block.RowData(j),
+                          k);
+      s21_kernels::Scale(dst, 1.0 / t.At(first + i, first + i), k);
+    }
+  }
+}
+
+}  // namespace
+
+S21Cholesky::S21Cholesky(const S21Matrix& matrix)
+    : l_(matrix.GetResource()) {
+  Factor(matrix);
+}
+
+void S21Cholesky::Factor(const S21Matrix& matrix) {
+  if (matrix.GetRows() != matrix.GetCols())
+    throw std::invalid_argument("The matrix is not square");
+  l_ = matrix;
+  positive_definite_ = true;
+  const int n = l_.GetRows();
+  const S21MatrixView a = l_.View();
+  const int lda = (int)a.GetRowStride();
+  for (int k0 = 0; k0 < n && positive_definite_; k0 += kBlock) {
+    const int nb = std::min(kBlock, n - k0), k1 = k0 + nb, rest = n - k1;
+    // Diagonal block; the earlier panels are already subtracted from it.
+    for (int j = k0; j < k1 && positive_definite_; j++) {
+      double* row_j = a.RowData(j);
+      const double d =
+          row_j[j] - s21_kernels::Dot(row_j + k0, row_j + k0, j - k0);
+      if (!(d > 0.0)) {
+        positive_definite_ = false;
+        break;
+      }
+      row_j[j] = std::sqrt(d);
+      for (int i = j + 1; i < k1; i++) {
+        double* row_i = a.RowData(i);
+        row_i[j] = (row_i[j] - s21_kernels::Dot(row_i + k0, row_j + k0,
+                                                j - k0)) /
+                   row_j[j];
+      }
+    }
+    if (!positive_definite_ || rest == 0) break;
+    // L21 = A21 * L11^-T, solved as L11 * L21^T = A21^T so that the
+    // substitution runs along long rows; columns split between threads.
+    S21Matrix panel(a.Submatrix(k1, k0, rest, nb).Transposed(),
+                    l_.GetResource());
+    const S21ConstMatrixView diagonal = a.Submatrix(k0, k0, nb, nb);
+    S21ThreadPool::ParallelFor(
+        (rest + kBlock - 1) / kBlock, (long)kBlock * nb * nb,
+        [&](int begin, int end) {
+          const int first = begin * kBlock;
+          const int cols = std::min(end * kBlock, rest) - first;
+          SolveTriangular(diagonal, true,
+                          panel.View().Submatrix(0, first, nb, cols));
+        });
+    s21_views::Copy(panel.View().Transposed(), a.Submatrix(k1, k0, rest, nb));
+    // A22 -= L21 * L21^T on and below the diagonal.
+    S21Matrix negated(a.Submatrix(k1, k0, rest, nb), l_.GetResource());
+    negated.MulNumber(-1.0);
+    const S21ConstMatrixView lhs = negated.View();
+    for (int first = 0; first < rest; first += kUpdateRows) {
+      const int rows = std::min(kUpdateRows, rest - first);
+      s21_kernels::Gemm(Op::kNoTrans, Op::kTrans, rows, first + rows, nb,
+                        lhs.RowData(first), (int)lhs.GetRowStride(),
+                        a.RowData(k1) + k0, lda, a.RowData(k1 + first) + k1,
+                        lda);
+    }
+  }
+  for (int i = 0; i < n; i++)
+    std::fill(a.RowData(i) + i + 1, a.RowData(i) + n, 0.0);
+}
+
+double S21Cholesky::Determinant() const {
+  if (!positive_definite_)
+    throw std::invalid_argument("Matrix is not positive definite");
+  double det = 1.0;
+  const S21ConstMatrixView l = l_.View();
+  for (int i = 0; i < l.GetRows(); i++) det *= l.At(i, i) * l.At(i, i);
+  return det;
+}
+
+S21Matrix S21Cholesky::Solve(const S21Matrix& b) const {
+  S21Matrix x(b.GetResource());
+  SolveInto(b, x);
+  return x;
+}
+
+void S21Cholesky::SolveInto(const S21Matrix& b, S21Matrix& x) const {
+  if (b.GetRows() != GetSize())
+    throw std::out_of_range(
+        "Invalid matrix sizes: right-hand side must have as many rows as the "
+        "system matrix");
+  if (!positive_definite_)
+    throw std::invalid_argument("Matrix is not positive definite");
+  x = b;
+  SolveTriangular(l_.View(), true, x.View());
+  SolveTriangular(l_.View().Transposed(), false, x.View());
+}
+
+S21QR::S21QR(const S21Matrix& matrix) : qr_(matrix.GetResource()) {
+  Factor(matrix);
+}
+
+void S21QR::Factor(const S21Matrix& matrix) {
+  const int m = matrix.GetRows(), n = matrix.GetCols();
+  if (m < n)
+    throw std::invalid_argument("The matrix has fewer rows than columns");
+  qr_ = matrix;
+  taus_.assign(n, 0.0);
+  block_t_.clear();
+  const S21MatrixView a = qr_.View();
+  std::vector<double> w;
+  for (int k0 = 0; k0 < n; k0 += kBlock) {
+    const int k1 = std::min(k0 + kBlock, n);
+    for (int j = k0; j < k1; j++) {
+      taus_[j] = s21_views::MakeReflector(a, j);
+      s21_views::ApplyReflector(a, j, taus_[j], j + 1, k1, w);
+    }
+    const S21Matrix y = Reflectors(k0);
+    block_t_.push_back(s21_views::TriangularFactor(y, taus_.data() + k0));
+    if (k1 < n)
+      s21_views::ApplyBlock(y, block_t_.back(), true,
+                            a.Submatrix(k0, k1, m - k0, n - k1));
+  }
+  double max_diagonal = 0.0;
+  for (int j = 0; j < n; j++)
+    max_diagonal = std::max(max_diagonal, std::fabs(a.At(j, j)));
+  const double threshold =
+      max_diagonal * m * std::numeric_limits<double>::epsilon();
+  full_rank_ = true;
+  for (int j = 0; j < n; j++)
+    if (!(std::fabs(a.At(j, j)) > threshold)) full_rank_ = false;
+}
+
+S21Matrix S21QR::Solve(const S21Matrix& b) const {
+  S21Matrix x(b.GetResource());
+  SolveInto(b, x);
+  return x;
+}
+
+void S21QR::SolveInto(const S21Matrix& b, S21Matrix& x) const {
+  const int m = GetRows(), n = GetCols(), k = b.GetCols();
+  if (b.GetRows() != m)
+    throw std::out_of_range(
+        "Invalid matrix sizes: right-hand side must have as many rows as the "
+        "system matrix");
+  if (!full_rank_) throw std::invalid_argument("Matrix is rank deficient");
+  if (n == 0 || k == 0) {
+    x = S21Matrix(n, k, x.GetResource());
+    return;
+  }
+  x = b;
+  for (int block = 0; block * kBlock < n; block++) {
+    const int k0 = block * kBlock;
+    s21_views::ApplyBlock(Reflectors(k0), block_t_[block], true,
+                          x.View().Submatrix(k0, 0, m - k0, k));
+  }
+  SolveTriangular(qr_.View().Submatrix(0, 0, n, n), false,
+                  x.View().Submatrix(0, 0, n, k));
+  x.SetRows(n);
+}
+
+S21Matrix S21QR::Q() const {
+  const int m = GetRows(), n = GetCols();
+  S21Matrix q(m, n, qr_.GetResource());
+  for (int i = 0; i < n; i++) q(i, i) = 1.0;
+  for (int block = (int)block_t_.size() - 1; block >= 0; block--) {
+    const int k0 = block * kBlock;
+    s21_views::ApplyBlock(Reflectors(k0), block_t_[block], false,
+                          q.View().Submatrix(k0, 0, m - k0, n));
+  }
+  return q;
+}
+
+S21Matrix S21QR::R() const {
+  const int n = GetCols();
+  S21Matrix r(n, n, qr_.GetResource());
+  for (int i = 0; i < n; i++)
+    for (int j = i; j < n; j++) r(i, j) = qr_(i, j);
+  return r;
+}
+
+S21Matrix S21QR::Reflectors(int first) const {
+  return s21_views::Reflectors(qr_.View(), first,
+                               std::min(kBlock, GetCols() - first));
+}
+
+namespace s21_solvers {
+
+namespace {
+
+int MaxIterations(const Options& options, int size) {
+  return options.max_iterations > 0 ? options.max_iterations
+                                    : std::max(size, 1);
+}
+
+// z = M^-1 * r, or a copy of r without a preconditioner.
+void Precondition(const Preconditioner& preconditioner, const S21Vector& r,
+                  S21Vector& z) {
+  if (preconditioner) {
+    preconditioner(r, z);
+  } else {
+    z = r;
+  }
+}
+
+template <typename Solve>
+std::vector<Report> SolveColumns(const S21Matrix& b, S21Matrix& x,
+                                 Solve solve) {
+  const int n = b.GetRows(), k = b.GetCols();
+  if (x.GetRows() != n || x.GetCols() != k)
+    x = S21Matrix(n, k, b.GetResource());
+  std::vector<Report> reports(k);
+  S21ThreadPool::ParallelFor(k, (long)n * n, [&](int begin, int end) {
+    for (int col = begin; col < end; col++) {
+      const S21Vector rhs(b.View().Col(col));
+      S21Vector solution(x.View().Col(col));
+      reports[col] = solve(rhs, solution);
+      s21_views::Copy(solution.View(), x.View().Col(col));
+    }
+  });
+  return reports;
+}
+
+}  // namespace
+
+Operator MatrixOperator(const S21Matrix& a) {
+  return [&a](const S21Vector& x, S21Vector& y) { y.Gemv(1.0, a, x); };
+}
+
+Preconditioner Jacobi(const S21Matrix& a) {
+  if (a.GetRows() != a.GetCols())
+    throw std::invalid_argument("The matrix is not square");
+  auto inverse = std::make_shared<S21Vector>(a.GetRows());
+  for (int i = 0; i < a.GetRows(); i++) {
+    if (a(i, i) == 0.0)
+      throw std::invalid_argument("The matrix has a zero on the diagonal");
+    (*inverse)(i) = 1.0 / a(i, i);
+  }
+  return [inverse](const S21Vector& r, S21Vector& z) {
+    const double* scale = inverse->Data();
+    const double* src = r.Data();
+    double* dst = z.Data();
+    for (int i = 0; i < r.GetSize(); i++) dst[i] = scale[i] * src[i];
+  };
+}
+
+Report ConjugateGradient(const Operator& a, const S21Vector& b, S21Vector& x,
+                         const Options& options,
+                         const Preconditioner& preconditioner) {
+  const int n = b.GetSize();
+  if (x.GetSize() != n) x = S21Vector(n);
+  Report report;
+  const double b_norm = b.Norm2();
+  if (b_norm == 0.0) {
+    x = S21Vector(n);
+    report.converged = true;
+    return report;
+  }
+  S21Vector r(b), z(n), p(n), q(n);
+  a(x, q);
+  r -= q;
+  report.residual = r.Norm2() / b_norm;
+  Precondition(preconditioner, r, z);
+  p = z;
+  double rz = r.Dot(z);
+  const int max_iterations = MaxIterations(options, n);
+  while (report.residual > options.tolerance &&
+         report.iterations < max_iterations) {
+    a(p, q);
+    const double pq = p.Dot(q);
+    // A is not positive definite along p.
+    if (!(pq > 0.0)) break;
+    const double alpha = rz / pq;
+    x.Axpy(alpha, p);
+    r.Axpy(-alpha, q);
+    report.iterations++;
+    report.residual = r.Norm2() / b_norm;
+    Precondition(preconditioner, r, z);
+    const double rz_next = r.Dot(z);
+    p *= rz_next / rz;
+    p += z;
+    rz = rz_next;
+  }
+  report.converged = report.residual <= options.tolerance;
+  return report;
+}
+
+Report Gmres(const Operator& a, const S21Vector& b, S21Vector& x,
+             const Options& options, const Preconditioner& preconditioner) {
+  const int n = b.GetSize();
+  if (x.GetSize() != n) x = S21Vector(n);
+  Report report;
+  const double b_norm = b.Norm2();
+  if (b_norm == 0.0) {
+    x = S21Vector(n);
+    report.converged = true;
+    return report;
+  }
+  const int restart = std::max(1, std::min(options.restart, n));
+  const int max_iterations = MaxIterations(options, n);
+  // Rows of basis are the orthonormal Krylov vectors; rows of directions
+  // are the same vectors preconditioned, which x is updated along.
+  S21Matrix basis(restart + 1, n);
+  S21Matrix directions(preconditioner ? restart : 0, n);
+  // Hessenberg matrix, turned into R by the Givens rotations cs, sn.
+  S21Matrix h(restart + 1, restart);
+  std::vector<double> cs(restart), sn(restart), g(restart + 1);
+  S21Vector v(n), z(n), w(n), coefficients(restart + 1), y;
+  while (true) {
+    a(x, w);
+    v = b;
+    v -= w;
+    const double beta = v.Norm2();
+    report.residual = beta / b_norm;
+    if (report.residual <= options.tolerance ||
+        report.iterations >= max_iterations)
+      break;
+    v *= 1.0 / beta;
+    std::copy(v.Data(), v.Data() + n, basis.View().RowData(0));
+    std::fill(g.begin(), g.end(), 0.0);
+    g[0] = beta;
+    int size = 0;
+    while (size < restart && report.iterations < max_iterations) {
+      const int j = size++;
+      Precondition(preconditioner, v, z);
+      if (preconditioner)
+        std::copy(z.Data(), z.Data() + n, directions.View().RowData(j));
+      a(z, w);
+      // Classical Gram-Schmidt, repeated once for orthogonality; each pass
+      // is two GEMVs over the basis.
+      const S21ConstMatrixView krylov = basis.View().Submatrix(0, 0, j + 1, n);
+      const S21MatrixView projection =
+          coefficients.View().Submatrix(0, 0, j + 1, 1);
+      for (int pass = 0; pass < 2; pass++) {
+        s21_views::Gemv(1.0, krylov, w, 0.0, projection);
+        s21_views::Gemv(-1.0, krylov.Transposed(), projection, 1.0, w);
+        for (int i = 0; i <= j; i++) h(i, j) += coefficients(i);
+      }
+      const double subdiagonal = w.Norm2();
+      h(j + 1, j) = subdiagonal;
+      report.iterations++;
+      for (int i = 0; i < j; i++) {
+        const double rotated = cs[i] * h(i, j) + sn[i] * h(i + 1, j);
+        h(i + 1, j) = -sn[i] * h(i, j) + cs[i] * h(i + 1, j);
+        h(i, j) = rotated;
+      }
+      const double radius = std::hypot(h(j, j), h(j + 1, j));
+      cs[j] = radius == 0.0 ? 1.0 : h(j, j) / radius;
+      sn[j] = radius == 0.0 ? 0.0 : h(j + 1, j) / radius;
+      h(j, j) = radius;
+      h(j + 1, j) = 0.0;
+      g[j + 1] = -sn[j] * g[j];
+      g[j] *= cs[j];
+      report.residual = std::fabs(g[j + 1]) / b_norm;
+      // A zero subdiagonal means the solution lies in the basis already.
+      if (report.residual <= options.tolerance || subdiagonal == 0.0) break;
+      v = w;
+      v *= 1.0 / subdiagonal;
+      std::copy(v.Data(), v.Data() + n, basis.View().RowData(j + 1));
+    }
+    // y = R^-1 * g, then x += directions^T * y.
+    y.SetSize(size);
+    for (int i = size - 1; i >= 0; i--) {
+      double sum = g[i];
+      for (int c = i + 1; c < size; c++) sum -= h(i, c) * y(c);
+      y(i) = sum / h(i, i);
+    }
+    const S21Matrix& along = preconditioner ? directions : basis;
+    x.GemvTransposed(1.0, along.View().Submatrix(0, 0, size, n), y, 1.0);
+    for (int i = 0; i < restart + 1; i++)
+      std::fill(h.View().RowData(i), h.View().RowData(i) + restart, 0.0);
+  }
+  report.converged = report.residual <= options.tolerance;
+  return report;
+}
+
+std::vector<Report> ConjugateGradient(const Operator& a, const S21Matrix& b,
+                                      S21Matrix& x, const Options& options,
+                                      const Preconditioner& preconditioner) {
+  return SolveColumns(b, x, [&](const S21Vector& rhs, S21Vector& solution) {
+    return ConjugateGradient(a, rhs, solution, options, preconditioner);
+  });
+}
+
+std::vector<Report> Gmres(const Operator& a, const S21Matrix& b, S21Matrix& x,
+                          const Options& options,
+                          const Preconditioner& preconditioner) {
+  return SolveColumns(b, x, [&](const S21Vector& rhs, S21Vector& solution) {
+    return Gmres(a, rhs, solution, options, preconditioner);
+  });
+}
+
+}  // namespace s21_solvers
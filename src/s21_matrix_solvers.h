@@ -0,0 +1,122 @@
+#ifndef SRC_S21_MATRIX_SOLVERS_
+#define SRC_S21_MATRIX_SOLVERS_
+
+#include <functional>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+#include "s21_vector.h"
+
+// Cholesky factorization A = L * L^T of a symmetric positive definite
+// matrix; only the lower triangle of A is read. Column panels are factored
+// directly and the trailing matrix is updated with the GEMM kernel, which
+// splits the work between threads.
+class S21Cholesky {
+ public:
+  explicit S21Cholesky(const S21Matrix& matrix);
+  // Factors another matrix in the storage of this one.
+  void Factor(const S21Matrix& matrix);
+
+  int GetSize() const { return l_.GetRows(); }
+  bool IsPositiveDefinite() const { return positive_definite_; }
+  double Determinant() const;
+  // Solves A * X = B for every column of B.
+  S21Matrix Solve(const S21Matrix& b) const;
+  void SolveInto(const S21Matrix& b, S21Matrix& x) const;
+  // L, with zeros above the diagonal.
+  const S21Matrix& Lower() const { return l_; }
+
+ private:
+  S21Matrix l_;
+  bool positive_definite_;
+};
+
+// Householder QR factorization A = Q * R of a rows x cols matrix with
+// rows >= cols. Reflectors are applied in blocks in the compact WY form
+// Q = I - Y * T * Y^T, so most of the work is GEMM.
+class S21QR {
+ public:
+  explicit S21QR(const S21Matrix& matrix);
+  void Factor(const S21Matrix& matrix);
+
+  int GetRows() const { return qr_.GetRows(); }
+  int GetCols() const { return qr_.GetCols(); }
+  bool IsFullRank() const { return full_rank_; }
+  // Least-squares solution of A * X = B for every column of B, exact when
+  // A is square and non-singular.
+  S21Matrix Solve(const S21Matrix& b) const;
+  void SolveInto(const S21Matrix& b, S21Matrix& x) const;
+  // The rows x cols Q with orthonormal columns and the cols x cols upper
+  // triangular R.
+  S21Matrix Q() const;
+  S21Matrix R() const;
+
+ private:
+  // Y of the reflector block starting at column first, unit diagonal and
+  // zeros above it included.
+  S21Matrix Reflectors(int first) const;
+
+  // R on and above the diagonal, Householder vectors below it.
+  S21Matrix qr_;
+  std::vector<double> taus_;
+  // T of every reflector block.
+  std::vector<S21Matrix> block_t_;
+  bool full_rank_;
+};
+
+// Iterative solvers for large systems. The matrix is only seen through an
+// operator computing y = A * x, so sparse and matrix-free systems work as
+// well as dense ones; a preconditioner computes z = M^-1 * r for some
+// approximation M of A. Both must be safe to call from several threads
+// when more than one right-hand side is solved at once.
+namespace s21_solvers {
+
+using Operator = std::function<void(const S21Vector& x, S21Vector& y)>;
+using Preconditioner = std::function<void(const S21Vector& r, S21Vector& z)>;
+
+struct Options {
+  // Stops once |b - A * x| <= tolerance * |b|.
+  double tolerance = 1e-10;
+  // 0 selects the size of the system.
+  int max_iterations = 0;
+  // Krylov basis size of GMRES between restarts.
+  int restart = 50;
+};
+
+struct Report {
+  int iterations = 0;
+  // Final |b - A * x| / |b|.
+  double residual = 0.0;
+  bool converged = false;
+};
+
+// y = a * x through Gemv; keeps a reference to a.
+Operator MatrixOperator(const S21Matrix& a);
+// Divides by the diagonal of a.
+Preconditioner Jacobi(const S21Matrix& a);
+
+// Preconditioned conjugate gradient for symmetric positive definite A
+// and M. x is the initial guess, or zero when its size does not match b,
+// and receives the solution.
+Report ConjugateGradient(const Operator& a, const S21Vector& b, S21Vector& x,
+                         const Options& options = {},
+                         const Preconditioner& preconditioner = nullptr);
+// Restarted GMRES for any non-singular A. The preconditioner is applied
+// on the right, so the residual it tracks is that of the system itself.
+Report Gmres(const Operator& a, const S21Vector& b, S21Vector& x,
+             const Options& options = {},
+             const Preconditioner& preconditioner = nullptr);
+
+// The same for every column of b; columns are solved independently and
+// split between threads.
+std::vector<Report> ConjugateGradient(
+    const Operator& a, const S21Matrix& b, S21Matrix& x,
+    const Options& options = {},
+    const Preconditioner& preconditioner = nullptr);
+std::vector<Report> Gmres(const Operator& a, const S21Matrix& b,
+                          S21Matrix& x, const Options& options = {},
+                          const Preconditioner& preconditioner = nullptr);
+
+}  // namespace s21_solvers
+
+#endif  // SRC_S21_MATRIX_SOLVERS_
@@ -0,0 +1,290 @@
+#include "s21_matrix_stats.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+
+namespace s21_stats {
+
+namespace {
+
+const char* const kOperationNames[kOperations] = {
+    "SumMatrix",   "SubMatrix",       "MulNumber",     "MulMatrix", "Transpose",
+    "Determinant", "CalcComplements", "InverseMatrix", "Solve",     "Allocate"};
+
+// Raw counters of one slot. Calls and time are split between calls that
+// are always timed and small ones, of which only a sample is.
+enum Field {
+  kTimedCalls,
+  kSmallCalls,
+  kBytes,
+  kFlops,
+  kNanoseconds,
+  kSampledCalls,
+  kSampledNanoseconds,
+  kFields
+};
+
+struct Totals {
+  std::uint64_t values[kOperations][kShapeBuckets][kFields] = {};
+};
+
+}  // namespace
+
+// Written only by the owning thread; the atomics let other threads read
+// it while it runs, and relaxed loads and stores are plain moves.
+struct Slot {
+  std::atomic<std::uint64_t> values[kFields] = {};
+
+  void Add(Field field, std::uint64_t value) {
+    values[field].store(values[field].load(std::memory_order_relaxed) + value,
+                        std::memory_order_relaxed);
+  }
+};
+
+namespace {
+
+struct ThreadCounters {
+  Slot slots[kOperations][kShapeBuckets];
+  // The slot of the innermost operation running on the thread.
+  Slot* active = nullptr;
+
+  void AddTo(Totals& totals) const {
+    for (int op = 0; op < kOperations; op++)
+      for (int bucket = 0; bucket < kShapeBuckets; bucket++)
+        for (int field = 0; field < kFields; field++)
+          totals.values[op][bucket][field] +=
+              slots[op][bucket].values[field].load(std::memory_order_relaxed);
+  }
+};
+
+struct Registry {
+  std::mutex mutex;
+  std::vector<const ThreadCounters*> threads;
+  // Counters of the threads that have exited.
+  Totals retired;
+  // Totals at the last Reset().
+  Totals baseline;
+};
+
+// Never destroyed, so that threads exiting during static destruction can
+// still retire their counters.
+Registry& GetRegistry() {
+  static Registry* registry = new Registry;
+  return *registry;
+}
+
+Totals Sum(Registry& registry) {
+  Totals totals = registry.retired;
+  for (const ThreadCounters* counters : registry.threads)
+    counters->AddTo(totals);
+  return totals;
+}
+
+#ifdef S21_MATRIX_STATS
+
+// Trivially initialized, so that reading it needs no guard.
+thread_local ThreadCounters* local_counters = nullptr;
+
+// Moves the counters of an exiting thread into the registry.
+struct Retirement {
+  ~Retirement() {
+    if (local_counters == nullptr) return;
+    Registry& registry = GetRegistry();
+    {
+      const std::lock_guard<std::mutex> lock(registry.mutex);
+      local_counters->AddTo(registry.retired);
+      registry.threads.erase(std::find(registry.threads.begin(),
+                                       registry.threads.end(), local_counters));
+    }
+    delete local_counters;
+    local_counters = nullptr;
+  }
+};
+thread_local Retirement retirement;
+
+// Kept out of line so that the callers' fast path stays small.
+__attribute__((noinline)) ThreadCounters& Register() {
+  static_cast<void>(&retirement);
+  auto* counters = new ThreadCounters;
+  Registry& registry = GetRegistry();
+  const std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.threads.push_back(counters);
+  local_counters = counters;
+  return *counters;
+}
+
+ThreadCounters& Local() {
+  return local_counters ? *local_counters : Register();
+}
+
+std::int64_t Now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+#endif
+
+}  // namespace
+
+const char* OperationName(Operation operation) {
+  return kOperationNames[static_cast<int>(operation)];
+}
+
+int ShapeBucket(int rows, int cols) {
+  if (rows <= 0 || cols <= 0) return 0;
+  const unsigned largest = static_cast<unsigned>(std::max(rows, cols));
+  const int bits = 32 - __builtin_clz(largest);
+  return std::min(bits, kShapeBuckets - 1);
+}
+
+std::string ShapeLabel(int bucket) {
+  if (bucket <= 1) return std::to_string(bucket);
+  const long low = 1L << (bucket - 1);
+  if (bucket == kShapeBuckets - 1) return std::to_string(low) + "+";
+  return std::to_string(low) + "-" + std::to_string(2 * low - 1);
+}
+
+std::vector<Entry> Snapshot() {
+  Registry& registry = GetRegistry();
+  Totals totals;
+  {
+    const std::lock_guard<std::mutex> lock(registry.mutex);
+    totals = Sum(registry);
+    for (int op = 0; op < kOperations; op++)
+      for (int bucket = 0; bucket < kShapeBuckets; bucket++)
+        for (int field = 0; field < kFields; field++)
+          totals.values[op][bucket][field] -=
+              registry.baseline.values[op][bucket][field];
+  }
+  std::vector<Entry> entries;
+  for (int op = 0; op < kOperations; op++) {
+    for (int bucket = 0; bucket < kShapeBuckets; bucket++) {
+      const std::uint64_t* raw = totals.values[op][bucket];
+      const std::uint64_t calls = raw[kTimedCalls] + raw[kSmallCalls];
+      if (calls == 0 && raw[kBytes] == 0) continue;
+      double nanoseconds = raw[kNanoseconds];
+      if (raw[kSampledCalls] > 0)
+        nanoseconds += static_cast<double>(raw[kSampledNanoseconds]) *
+                       raw[kSmallCalls] / raw[kSampledCalls];
+      Counters counters;
+      counters.calls = calls;
+      counters.bytes = raw[kBytes];
+      counters.flops = raw[kFlops];
+      counters.seconds = nanoseconds * 1e-9;
+      entries.push_back({static_cast<Operation>(op), bucket, counters});
+    }
+  }
+  return entries;
+}
+
+void Reset() {
+  Registry& registry = GetRegistry();
+  const std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.baseline = Sum(registry);
+}
+
+std::string ToJson(const std::vector<Entry>& entries) {
+  std::string json = "{\"entries\": [";
+  char buffer[320];
+  for (std::size_t i = 0; i < entries.size(); i++) {
+    const Entry& entry = entries[i];
+    std::snprintf(buffer, sizeof(buffer),
+                  "%s\n  {\"operation\": \"%s\", \"shape\": \"%s\", "
+                  "\"calls\": %llu, \"bytes\": %llu, \"flops\": %llu, "
+                  "\"seconds\": %.9g}",
+                  i == 0 ? "" : ",", OperationName(entry.operation),
+                  ShapeLabel(entry.bucket).c_str(),
+                  static_cast<unsigned long long>(entry.counters.calls),
+                  static_cast<unsigned long long>(entry.counters.bytes),
+                  static_cast<unsigned long long>(entry.counters.flops),
+                  entry.counters.seconds);
+    json += buffer;
+  }
+  json += entries.empty() ? "]}\n" : "\n]}\n";
+  return json;
+}
+
+std::string ToPrometheus(const std::vector<Entry>& entries) {
+  struct Family {
+    const char* name;
+    const char* help;
+  };
+  const Family families[] = {
+      {"s21_matrix_calls_total", "Calls of S21Matrix operations."},
+      {"s21_matrix_allocated_bytes_total",
+       "Bytes of S21Matrix buffers allocated."},
+      {"s21_matrix_flops_total", "Floating point operations performed."},
+      {"s21_matrix_seconds_total", "Wall time spent in the operations."}};
+  std::string text;
+  char buffer[256];
+  for (int family = 0; family < 4; family++) {
+    text += std::string("# HELP ") + families[family].name + " " +
+            families[family].help + "\n# TYPE " + families[family].name +
+            " counter\n";
+    for (const Entry& entry : entries) {
+      const Counters& counters = entry.counters;
+      const int length = std::snprintf(
+          buffer, sizeof(buffer), "%s{operation=\"%s\",shape=\"%s\"} ",
+          families[family].name, OperationName(entry.operation),
+          ShapeLabel(entry.bucket).c_str());
+      const std::uint64_t counts[] = {counters.calls, counters.bytes,
+                                      counters.flops};
+      if (family < 3) {
+        std::snprintf(buffer + length, sizeof(buffer) - length, "%llu\n",
+                      static_cast<unsigned long long>(counts[family]));
+      } else {
+        std::snprintf(buffer + length, sizeof(buffer) - length, "%.9g\n",
+                      counters.seconds);
+      }
+      text += buffer;
+    }
+  }
+  return text;
+}
+
+#ifdef S21_MATRIX_STATS
+
+Scope::Scope(Operation operation, int rows, int cols, double flops) {
+  ThreadCounters& local = Local();
+  slot_ = &local.slots[static_cast<int>(operation)][ShapeBucket(rows, cols)];
+  outer_ = local.active;
+  local.active = slot_;
+  slot_->Add(kFlops, static_cast<std::uint64_t>(flops));
+  if (flops >= kTimedFlops) {
+    slot_->Add(kTimedCalls, 1);
+    timing_ = kNanoseconds;
+  } else {
+    const std::uint64_t small =
+        slot_->values[kSmallCalls].load(std::memory_order_relaxed);
+    slot_->values[kSmallCalls].store(small + 1, std::memory_order_relaxed);
+    timing_ = small % kSampleInterval == 0 ? kSampledNanoseconds : 0;
+  }
+  start_ = timing_ ? Now() : 0;
+}
+
+Scope::~Scope() {
+  if (timing_) {
+    slot_->Add(static_cast<Field>(timing_), Now() - start_);
+    if (timing_ == kSampledNanoseconds) slot_->Add(kSampledCalls, 1);
+  }
+  local_counters->active = outer_;
+}
+
+void RecordAllocation(std::size_t bytes, int rows, int cols) {
+  ThreadCounters& local = Local();
+  Slot* slot = local.active;
+  if (slot == nullptr) {
+    slot = &local.slots[static_cast<int>(Operation::kAllocate)]
+                       [ShapeBucket(rows, cols)];
+    slot->Add(kSmallCalls, 1);
+  }
+  slot->Add(kBytes, bytes);
+}
+
+#endif
+
+}  // namespace s21_stats
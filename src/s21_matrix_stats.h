@@ -0,0 +1,112 @@
+#ifndef SRC_S21_MATRIX_STATS_
+#define SRC_S21_MATRIX_STATS_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Optional instrumentation of the S21Matrix operations: calls, bytes
+// allocated by S21Matrix buffers, floating point operations and wall time,
+// per operation and shape bucket. It is compiled in only with
+// -DS21_MATRIX_STATS; without it the hooks expand to nothing and Snapshot()
+// stays empty. Each thread counts into its own block with plain stores, and
+// the blocks are summed on demand, so that the hot path takes no lock and
+// shares no cache line. Allocations count toward the operation running on
+// the allocating thread; those outside any operation, including the ones
+// of pool threads, are reported as Allocate. Wall time is inclusive of
+// nested operations. Calls under kTimedFlops are timed one in
+// kSampleInterval, and their time is extrapolated from the sample.
+namespace s21_stats {
+
+#ifdef S21_MATRIX_STATS
+inline constexpr bool kEnabled = true;
+#else
+inline constexpr bool kEnabled = false;
+#endif
+
+enum class Operation {
+  kSum,
+  kSub,
+  kMulNumber,
+  kMulMatrix,
+  kTranspose,
+  kDeterminant,
+  kCalcComplements,
+  kInverse,
+  kSolve,
+  // Buffer allocations outside the operations above, one call each.
+  kAllocate,
+};
+inline constexpr int kOperations = 10;
+// Bucket b holds shapes whose larger dimension lies in [2^(b - 1), 2^b),
+// with bucket 0 for empty matrices and the last bucket open-ended.
+inline constexpr int kShapeBuckets = 16;
+inline constexpr double kTimedFlops = 1 << 16;
+inline constexpr int kSampleInterval = 256;
+
+const char* OperationName(Operation operation);
+int ShapeBucket(int rows, int cols);
+// "0", "1", "2-3", "4-7", ..., "16384+".
+std::string ShapeLabel(int bucket);
+
+struct Counters {
+  std::uint64_t calls = 0;
+  std::uint64_t bytes = 0;
+  std::uint64_t flops = 0;
+  double seconds = 0.0;
+};
+
+struct Entry {
+  Operation operation;
+  int bucket;
+  Counters counters;
+};
+
+// Counters of all threads since the last Reset(), operation by operation
+// and bucket by bucket, leaving out the ones without calls or bytes.
+std::vector<Entry> Snapshot();
+void Reset();
+
+// {"entries": [{"operation": ..., "shape": ..., "calls": ..., ...}, ...]}.
+std::string ToJson(const std::vector<Entry>& entries);
+// Prometheus text exposition format, one counter family per field.
+std::string ToPrometheus(const std::vector<Entry>& entries);
+
+#ifdef S21_MATRIX_STATS
+
+struct Slot;
+
+// Counts one call for the lifetime of the object.
+class Scope {
+ public:
+  Scope(Operation operation, int rows, int cols, double flops);
+  ~Scope();
+  Scope(const Scope&) = delete;
+  Scope& operator=(const Scope&) = delete;
+
+ private:
+  Slot* slot_;
+  Slot* outer_;
+  // Sampled calls go to separate counters; 0 when the call is not timed.
+  int timing_;
+  std::int64_t start_;
+};
+
+void RecordAllocation(std::size_t bytes, int rows, int cols);
+
+#define S21_STATS_SCOPE(operation, rows, cols, flops) \
+  s21_stats::Scope s21_stats_scope((operation), (rows), (cols), (flops))
+#define S21_STATS_ALLOCATION(bytes, rows, cols) \
+  s21_stats::RecordAllocation((bytes), (rows), (cols))
+
+#else
+
+#define S21_STATS_SCOPE(operation, rows, cols, flops) static_cast<void>(0)
+#define S21_STATS_ALLOCATION(bytes, rows, cols) static_cast<void>(0)
+
+#endif
+
+}  // namespace s21_stats
+
+#endif  // SRC_S21_MATRIX_STATS_
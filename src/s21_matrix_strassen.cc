@@ -0,0 +1,220 @@
+#include "s21_matrix_strassen.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+
+#include "s21_matrix_gemm.h"
+#include "s21_thread_pool.h"
+
+namespace s21_kernels {
+
+namespace {
+
+// Row-major block of a larger buffer.
+struct Block {
+  double* data;
+  int ld;
+
+  double* Row(int row) const { return data + row * (long)ld; }
+  Block Quadrant(int row, int col, int rows, int cols) const {
+    return {data + row * (long)rows * ld + col * cols, ld};
+  }
+};
+
+// c = a + sign * b over rows x cols; c may be a or b.
+void Combine(int rows, int cols, Block a, Block b, double sign, Block c) {
+  S21ThreadPool::ParallelFor(rows, cols, [&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      const double* x = a.Row(i);
+      const double* y = b.Row(i);
+      double* z = c.Row(i);
+      if (sign > 0) {
+        for (int j = 0; j < cols; j++) z[j] = x[j] + y[j];
+      } else {
+        for (int j = 0; j < cols; j++) z[j] = x[j] - y[j];
+      }
+    }
+  });
+}
+
+void Add(int rows, int cols, Block a, Block b, Block c) {
+  Combine(rows, cols, a, b, 1.0, c);
+}
+
+void Sub(int rows, int cols, Block a, Block b, Block c) {
+  Combine(rows, cols, a, b, -1.0, c);
+}
+
+// Two temporaries per level, X (m/2 x max(k/2, n/2)) and Y (k/2 x n/2),
+// plus the workspace of the next level.
+std::size_t SerialWorkspace(int m, int n, int k, int levels) {
+  if (levels == 0) return 0;
+  const std::size_t hm = m / 2, hn = n / 2, hk = k / 2;
+  return hm * std::max(hk, hn) + hk * hn +
+         SerialWorkspace(m / 2, n / 2, k / 2, levels - 1);
+}
+
+// c = a * b, every dimension divisible by 2^levels. The schedule of Boyer,
+// Dumas, Pernet and Zhou: products go into the quadrants of c and the two
+// temporaries, so that each level only needs SerialWorkspace().
+void Multiply(int m, int n, int k, Block a, Block b, Block c, int levels,
+              double* work) {
+  if (levels == 0) {
+    for (int i = 0; i < m; i++) std::fill(c.Row(i), c.Row(i) + n, 0.0);
+    Gemm(m, n, k, a.data, a.ld, b.data, b.ld, c.data, c.ld);
+    return;
+  }
+  const int hm = m / 2, hn = n / 2, hk = k / 2;
+  const Block a11 = a.Quadrant(0, 0, hm, hk), a12 = a.Quadrant(0, 1, hm, hk);
+  const Block a21 = a.Quadrant(1, 0, hm, hk), a22 = a.Quadrant(1, 1, hm, hk);
+  const Block b11 = b.Quadrant(0, 0, hk, hn), b12 = b.Quadrant(0, 1, hk, hn);
+  const Block b21 = b.Quadrant(1, 0, hk, hn), b22 = b.Quadrant(1, 1, hk, hn);
+  const Block c11 = c.Quadrant(0, 0, hm, hn), c12 = c.Quadrant(0, 1, hm, hn);
+  const Block c21 = c.Quadrant(1, 0, hm, hn), c22 = c.Quadrant(1, 1, hm, hn);
+  const Block x = {work, std::max(hk, hn)};
+  const Block y = {work + (std::size_t)hm * x.ld, hn};
+  double* next = y.data + (std::size_t)hk * hn;
+  auto mul = [&](Block lhs, Block rhs, Block dst) {
+    Multiply(hm, hn, hk, lhs, rhs, dst, levels - 1, next);
+  };
+  Sub(hm, hk, a11, a21, x);    // S3
+  Sub(hk, hn, b22, b12, y);    // T3
+  mul(x, y, c21);              // P7
+  Add(hm, hk, a21, a22, x);    // S1
+  Sub(hk, hn, b12, b11, y);    // T1
+  mul(x, y, c22);              // P5
+  Sub(hm, hk, x, a11, x);      // S2
+  Sub(hk, hn, b22, y, y);      // T2
+  mul(x, y, c12);              // P6
+  Sub(hm, hk, a12, x, x);      // S4
+  mul(x, b22, c11);            // P3
+  mul(a11, b11, x);            // P1
+  Add(hm, hn, x, c12, c12);    // U2 = P1 + P6
+  Add(hm, hn, c12, c21, c21);  // U3 = U2 + P7
+  Add(hm, hn, c12, c22, c12);  // U4 = U2 + P5
+  Add(hm, hn, c21, c22, c22);  // U7 = U3 + P5, C22
+  Add(hm, hn, c12, c11, c12);  // U5 = U4 + P3, C12
+  Sub(hk, hn, y, b21, y);      // T4
+  mul(a22, y, c11);            // P4
+  Sub(hm, hn, c21, c11, c21);  // U6 = U3 - P4, C21
+  mul(a12, b21, c11);          // P2
+  Add(hm, hn, x, c11, c11);    // U1 = P1 + P2, C11
+}
+
+std::size_t ParallelWorkspace(int m, int n, int k, int levels) {
+  const std::size_t hm = m / 2, hn = n / 2, hk = k / 2;
+  return 4 * hm * hk + 4 * hk * hn + 3 * hm * hn +
+         7 * SerialWorkspace(m / 2, n / 2, k / 2, levels - 1);
+}
+
+// The top level of Multiply with all operand sums formed first, so the
+// seven products are independent tasks. Every sum pairs the same operands
+// as in Multiply, so the results are bit for bit the same.
+void MultiplyParallel(int m, int n, int k, Block a, Block b, Block c,
+                      int levels, double* work) {
+  const int hm = m / 2, hn = n / 2, hk = k / 2;
+  const Block a11 = a.Quadrant(0, 0, hm, hk), a12 = a.Quadrant(0, 1, hm, hk);
+  const Block a21 = a.Quadrant(1, 0, hm, hk), a22 = a.Quadrant(1, 1, hm, hk);
+  const Block b11 = b.Quadrant(0, 0, hk, hn), b12 = b.Quadrant(0, 1, hk, hn);
+  const Block b21 = b.Quadrant(1, 0, hk, hn), b22 = b.Quadrant(1, 1, hk, hn);
+  const Block c11 = c.Quadrant(0, 0, hm, hn), c12 = c.Quadrant(0, 1, hm, hn);
+  const Block c21 = c.Quadrant(1, 0, hm, hn), c22 = c.Quadrant(1, 1, hm, hn);
+  auto take = [&work](int rows, int cols) {
+    const Block block = {work, cols};
+    work += (std::size_t)rows * cols;
+    return block;
+  };
+  const Block s1 = take(hm, hk), s2 = take(hm, hk), s3 = take(hm, hk),
+              s4 = take(hm, hk);
+  const Block t1 = take(hk, hn), t2 = take(hk, hn), t3 = take(hk, hn),
+              t4 = take(hk, hn);
+  const Block p1 = take(hm, hn), p6 = take(hm, hn), p7 = take(hm, hn);
+  Sub(hm, hk, a11, a21, s3);
+  Sub(hk, hn, b22, b12, t3);
+  Add(hm, hk, a21, a22, s1);
+  Sub(hk, hn, b12, b11, t1);
+  Sub(hm, hk, s1, a11, s2);
+  Sub(hk, hn, b22, t1, t2);
+  Sub(hm, hk, a12, s2, s4);
+  Sub(hk, hn, t2, b21, t4);
+  struct Product {
+    Block lhs, rhs, dst;
+  };
+  const Product products[7] = {{a11, b11, p1}, {a12, b21, c11},
+                               {s4, b22, c12}, {a22, t4, c21},
+                               {s1, t1, c22},  {s2, t2, p6},
+                               {s3, t3, p7}};
+  const std::size_t task_work = SerialWorkspace(hm, hn, hk, levels - 1);
+  S21ThreadPool::ParallelFor(
+      7, (long)hm * hn * hk, [&](int begin, int end) {
+        for (int i = begin; i < end; i++)
+          Multiply(hm, hn, hk, products[i].lhs, products[i].rhs,
+                   products[i].dst, levels - 1, work + i * task_work);
+      });
+  Add(hm, hn, p1, p6, p6);    // U2
+  Add(hm, hn, p1, c11, c11);  // U1, C11
+  Add(hm, hn, p6, p7, p7);    // U3
+  Add(hm, hn, p6, c22, p6);   // U4
+  Add(hm, hn, p7, c22, c22);  // U7, C22
+  Add(hm, hn, p6, c12, c12);  // U5, C12
+  Sub(hm, hn, p7, c21, c21);  // U6, C21
+}
+
+int RoundUp(int value, int multiple) {
+  return (value + multiple - 1) / multiple * multiple;
+}
+
+}  // namespace
+
+void Strassen(int m, int n, int k, const double* a, int lda, const double* b,
+              int ldb, double* c, int ldc, int crossover) {
+  if (crossover < 1)
+    throw std::invalid_argument("Strassen crossover should be positive");
+  if (m <= 0 || n <= 0 || k <= 0) return;
+  int levels = 0;
+  for (int size = std::min({m, n, k}); size > crossover; size = (size + 1) / 2)
+    levels++;
+  if (levels == 0) {
+    Gemm(m, n, k, a, lda, b, ldb, c, ldc);
+    return;
+  }
+  const int step = 1 << levels;
+  const int pm = RoundUp(m, step), pn = RoundUp(n, step);
+  const int pk = RoundUp(k, step);
+  const bool pad = pm != m || pn != n || pk != k;
+  const bool parallel = S21ThreadPool::GetThreadCount() > 1;
+  const std::size_t work_size = parallel
+                                    ? ParallelWorkspace(pm, pn, pk, levels)
+                                    : SerialWorkspace(pm, pn, pk, levels);
+  const std::size_t padded_size =
+      pad ? (std::size_t)pm * pk + (std::size_t)pk * pn : 0;
+  std::unique_ptr<double[]> scratch(
+      new double[work_size + padded_size + (std::size_t)pm * pn]);
+  // Blocks are only written through when they are workspace.
+  Block lhs = {const_cast<double*>(a), lda};
+  Block rhs = {const_cast<double*>(b), ldb};
+  double* free_space = scratch.get();
+  if (pad) {
+    // Zero rows and columns contribute nothing to the product.
+    lhs = {free_space, pk};
+    rhs = {free_space + (std::size_t)pm * pk, pn};
+    free_space += padded_size;
+    std::fill(lhs.data, lhs.data + padded_size, 0.0);
+    for (int i = 0; i < m; i++)
+      std::copy_n(a + i * (long)lda, k, lhs.Row(i));
+    for (int i = 0; i < k; i++)
+      std::copy_n(b + i * (long)ldb, n, rhs.Row(i));
+  }
+  const Block result = {free_space, pn};
+  double* work = free_space + (std::size_t)pm * pn;
+  if (parallel) {
+    MultiplyParallel(pm, pn, pk, lhs, rhs, result, levels, work);
+  } else {
+    Multiply(pm, pn, pk, lhs, rhs, result, levels, work);
+  }
+  Add(m, n, {c, ldc}, result, {c, ldc});
+}
+
+}  // namespace s21_kernels
@@ -0,0 +1,31 @@
+#ifndef SRC_S21_MATRIX_STRASSEN_
+#define SRC_S21_MATRIX_STRASSEN_
+
+namespace s21_kernels {
+
+// Products whose smallest dimension is at most this size go straight to
+// Gemm. Measured with BM_MulMatrixStrassen: 128 and 256 run about as fast,
+// and 256 loses less accuracy.
+constexpr int kStrassenCrossover = 256;
+
+// C(m x n) += A(m x k) * B(k x n) by Strassen-Winograd recursion: 7
+// half-size products and 15 additions per level instead of 8 products,
+// recursing until the smallest dimension is at most crossover and handing
+// the leaves to Gemm. Dimensions are zero-padded to a multiple of
+// 2^levels. Workspace comes from one allocation per call; the seven
+// top-level products run as separate pool tasks when the pool has more
+// than one thread, with results identical to the serial schedule.
+//
+// Accuracy: the error bound is normwise, |C - AB| <= c(n) u |A| |B| with
+// c(n) growing like (n / crossover)^log2(18) instead of n, so single
+// elements much smaller than |A| |B| can lose relative accuracy. For
+// 2048 x 2048 operands with elements up to 1e3 the largest difference to
+// GemmReference is about 2e-7, against 1e-8 for Gemm, on products of
+// magnitude 1e6; crossover 64 raises it to about 8e-7.
+void Strassen(int m, int n, int k, const double* a, int lda, const double* b,
+              int ldb, double* c, int ldc,
+              int crossover = kStrassenCrossover);
+
+}  // namespace s21_kernels
+
+#endif  // SRC_S21_MATRIX_STRASSEN_
@@ -0,0 +1,74 @@
+#include "s21_matrix_transpose.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "s21_thread_pool.h"
+
+namespace s21_kernels {
+
+namespace {
+
+// Blocks up to kLeaf x kLeaf are copied directly: the source rows and the
+// destination rows they touch fit in L1 together.
+constexpr int kLeaf = 32;
+// Rows per task handed to the thread pool.
+constexpr int kBand = 64;
+
+// Cache-oblivious transpose: halves the longer side until the block is a
+// leaf, so every level of the memory hierarchy sees blocks that fit.
+void TransposeBlock(int rows, int cols, const double* src, long lds,
+                    double* dst, long ldd) {
+  if (rows <= kLeaf && cols <= kLeaf) {
+    for (int row = 0; row < rows; row++) {
+      const double* src_row = src + row * lds;
+      for (int col = 0; col < cols; col++) dst[col * ldd + row] = src_row[col];
+    }
+  } else if (rows >= cols) {
+    const int half = rows / 2;
+    TransposeBlock(half, cols, src, lds, dst, ldd);
+    TransposeBlock(rows - half, cols, src + half * lds, lds, dst + half, ldd);
+  } else {
+    const int half = cols / 2;
+    TransposeBlock(rows, half, src, lds, dst, ldd);
+    TransposeBlock(rows, cols - half, src + half, lds, dst + half * ldd, ldd);
+  }
+}
+
+}  // namespace
+
+void Transpose(int rows, int cols, const double* src, int lds, double* dst,
+               int ldd) {
+  const int bands = (rows + kBand - 1) / kBand;
+  S21ThreadPool::ParallelFor(
+      bands, (long)kBand * cols, [&](int begin, int end) {
+        const int first = begin * kBand;
+        const int last = std::min(rows, end * kBand);
+        TransposeBlock(last - first, cols, src + first * (long)lds, lds,
+                       dst + first, ldd);
+      });
+}
+
+void TransposeInPlace(int n, double* a, int lda) {
+  const int blocks = (n + kLeaf - 1) / kLeaf;
+  // Block row bi swaps every block right of the diagonal with its mirror,
+  // so no two tasks touch the same element.
+  S21ThreadPool::ParallelFor(
+      blocks, (long)kLeaf * n / 2, [&](int begin, int end) {
+        for (int bi = begin; bi < end; bi++) {
+          const int row_first = bi * kLeaf;
+          const int row_last = std::min(n, row_first + kLeaf);
+          for (int col_first = row_first; col_first < n; col_first += kLeaf) {
+            const int col_last = std::min(n, col_first + kLeaf);
+            for (int row = row_first; row < row_last; row++) {
+              double* upper = a + row * (long)lda;
+              for (int col = std::max(col_first, row + 1); col < col_last;
+                   col++)
+                std::swap(upper[col], a[col * (long)lda + row]);
+            }
+          }
+        }
+      });
+}
+
+}  // namespace s21_kernels
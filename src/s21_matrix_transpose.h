@@ -0,0 +1,15 @@
+#ifndef SRC_S21_MATRIX_TRANSPOSE_
+#define SRC_S21_MATRIX_TRANSPOSE_
+
+namespace s21_kernels {
+
+// dst(cols x rows) = src(rows x cols)^T; dst must not alias src.
+void Transpose(int rows, int cols, const double* src, int lds, double* dst,
+               int ldd);
+
+// Transposes the n x n matrix a in place.
+void TransposeInPlace(int n, double* a, int lda);
+
+}  // namespace s21_kernels
+
+#endif  // SRC_S21_MATRIX_TRANSPOSE_
@@ -0,0 +1,297 @@
+#include "s21_matrix_view.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "s21_matrix_gemm.h"
+#include "s21_matrix_simd.h"
+#include "s21_thread_pool.h"
+
+namespace s21_views {
+
+namespace {
+
+void CheckSameShape(S21ConstMatrixView lhs, S21ConstMatrixView rhs) {
+  if (lhs.GetRows() != rhs.GetRows() || lhs.GetCols() != rhs.GetCols())
+    throw std::out_of_range("Different matrix dimensions");
+}
+
+// Runs body(row) for every row of dst, split between threads.
+template <typename Body>
+void ForEachRow(S21ConstMatrixView dst, Body body) {
+  S21ThreadPool::ParallelFor(
+      dst.GetRows(), dst.GetCols(), [&](int begin, int end) {
+        for (int row = begin; row < end; row++) body(row);
+      });
+}
+
+bool Contiguous(S21ConstMatrixView view) { return view.GetColStride() == 1; }
+
+// How Gemm can read a view: as stored when its rows are contiguous, as
+// the transpose of a row-major matrix when its columns are.
+bool GemmOperand(S21ConstMatrixView view, s21_kernels::Op* op, int* ld) {
+  if (view.GetColStride() == 1) {
+    *op = s21_kernels::Op::kNoTrans;
+    *ld = (int)view.GetRowStride();
+    return true;
+  }
+  if (view.GetRowStride() == 1) {
+    *op = s21_kernels::Op::kTrans;
+    *ld = (int)view.GetColStride();
+    return true;
+  }
+  return false;
+}
+
+// Length and element step of a view with one row or one column.
+void VectorShape(S21ConstMatrixView view, int* size, std::ptrdiff_t* step) {
+  if (view.GetCols() == 1) {
+    *size = view.GetRows();
+    *step = view.GetRowStride();
+  } else if (view.GetRows() == 1) {
+    *size = view.GetCols();
+    *step = view.GetColStride();
+  } else {
+    throw std::invalid_argument("The view is not a vector");
+  }
+}
+
+// Whether the memory spanned by two views intersects. Strides are never
+// negative, so a view spans [Data(), &At(rows - 1, cols - 1)].
+bool Overlap(S21ConstMatrixView lhs, S21ConstMatrixView rhs) {
+  if (lhs.GetRows() == 0 || lhs.GetCols() == 0 || rhs.GetRows() == 0 ||
+      rhs.GetCols() == 0)
+    return false;
+  const std::less<const double*> less;
+  return !less(&lhs.At(lhs.GetRows() - 1, lhs.GetCols() - 1), rhs.Data()) &&
+         !less(&rhs.At(rhs.GetRows() - 1, rhs.GetCols() - 1), lhs.Data());
+}
+
+}  // namespace
+
+void Copy(S21ConstMatrixView src, S21MatrixView dst) {
+  CheckSameShape(src, dst);
+  const int cols = dst.GetCols();
+  ForEachRow(dst, [&](int row) {
+    const double* from = src.RowData(row);
+    double* to = dst.RowData(row);
+    if (Contiguous(src) && Contiguous(dst)) {
+      std::copy(from, from + cols, to);
+    } else {
+      for (int col = 0; col < cols; col++)
+        to[col * dst.GetColStride()] = from[col * src.GetColStride()];
+    }
+  });
+}
+
+void Add(S21ConstMatrixView src, S21MatrixView dst) {
+  CheckSameShape(src, dst);
+  const int cols = dst.GetCols();
+  ForEachRow(dst, [&](int row) {
+    if (Contiguous(src) && Contiguous(dst)) {
+      s21_kernels::Add(dst.RowData(row), src.RowData(row), cols);
+    } else {
+      for (int col = 0; col < cols; col++) dst.At(row, col) += src.At(row, col);
+    }
+  });
+}
+
+void Sub(S21ConstMatrixView src, S21MatrixView dst) {
+  CheckSameShape(src, dst);
+  const int cols = dst.GetCols();
+  ForEachRow(dst, [&](int row) {
+    if (Contiguous(src) && Contiguous(dst)) {
+      s21_kernels::Sub(dst.RowData(row), src.RowData(row), cols);
+    } else {
+      for (int col = 0; col < cols; col++) dst.At(row, col) -= src.At(row, col);
+    }
+  });
+}
+
+void Scale(double num, S21MatrixView dst) {
+  const int cols = dst.GetCols();
+  ForEachRow(dst, [&](int row) {
+    if (Contiguous(dst)) {
+      s21_kernels::Scale(dst.RowData(row), num, cols);
+    } else {
+      for (int col = 0; col < cols; col++) dst.At(row, col) *= num;
+    }
+  });
+}
+
+bool Equal(S21ConstMatrixView lhs, S21ConstMatrixView rhs) {
+  if (lhs.GetRows() != rhs.GetRows() || lhs.GetCols() != rhs.GetCols())
+    return false;
+  bool code = true;
+  for (int row = 0; row < lhs.GetRows() && code; row++) {
+    if (Contiguous(lhs) && Contiguous(rhs)) {
+      code = s21_kernels::AllClose(lhs.RowData(row), rhs.RowData(row),
+                                   lhs.GetCols(), 1e-7);
+    } else {
+      for (int col = 0; col < lhs.GetCols() && code; col++)
+        code = !(std::fabs(lhs.At(row, col) - rhs.At(row, col)) > 1e-7);
+    }
+  }
+  return code;
+}
+
+void Multiply(S21ConstMatrixView lhs, S21ConstMatrixView rhs,
+              S21MatrixView dst) {
+  if (lhs.GetCols() != rhs.GetRows())
+    throw std::out_of_range(
+        "Invalid matrix sizes: number of cols of the first matrix must be "
+        "equal to the number of rows of the second matrix");
+  if (dst.GetRows() != lhs.GetRows() || dst.GetCols() != rhs.GetCols())
+    throw std::out_of_range("Different matrix dimensions");
+  const int m = dst.GetRows(), n = dst.GetCols(), k = lhs.GetCols();
+  s21_kernels::Op op_a, op_b;
+  int lda, ldb;
+  if (Contiguous(dst) && GemmOperand(lhs, &op_a, &lda) &&
+      GemmOperand(rhs, &op_b, &ldb)) {
+    for (int row = 0; row < m; row++)
+      std::fill(dst.RowData(row), dst.RowData(row) + n, 0.0);
+    s21_kernels::Gemm(op_a, op_b, m, n, k, lhs.Data(), lda, rhs.Data(), ldb,
+                      dst.Data(), (int)dst.GetRowStride());
+    return;
+  }
+  S21ThreadPool::ParallelFor(m, (long)n * k, [&](int begin, int end) {
+    for (int row = begin; row < end; row++) {
+      for (int col = 0; col < n; col++) {
+        double sum = 0.0;
+        for (int i = 0; i < k; i++) sum += lhs.At(row, i) * rhs.At(i, col);
+        dst.At(row, col) = sum;
+      }
+    }
+  });
+}
+
+void Gemv(double alpha, S21ConstMatrixView a, S21ConstMatrixView x,
+          double beta, S21MatrixView y) {
+  int x_size, y_size;
+  std::ptrdiff_t x_step, y_step;
+  VectorShape(x, &x_size, &x_step);
+  VectorShape(y, &y_size, &y_step);
+  if (a.GetCols() != x_size)
+    throw std::out_of_range(
+        "Invalid matrix sizes: vector length must be equal to the number of "
+        "cols of the matrix");
+  if (a.GetRows() != y_size)
+    throw std::out_of_range("Different matrix dimensions");
+  const int m = y_size, n = x_size;
+  // The kernel wants x contiguous, and x is read until the last element of
+  // y is written, so it is copied when y overwrites it.
+  std::vector<double> x_copy;
+  const double* x_data = x.Data();
+  if ((x_step != 1 && n > 1) || Overlap(x, y)) {
+    x_copy.resize(n);
+    for (int i = 0; i < n; i++) x_copy[i] = x_data[i * x_step];
+    x_data = x_copy.data();
+    x_step = 1;
+  }
+  s21_kernels::Op op;
+  int lda;
+  if (GemmOperand(a, &op, &lda)) {
+    std::vector<double> y_copy;
+    double* y_data = y.Data();
+    if (y_step != 1 && m > 1) {
+      y_copy.resize(m);
+      for (int i = 0; i < m; i++) y_copy[i] = y_data[i * y_step];
+      y_data = y_copy.data();
+    }
+    s21_kernels::Gemv(op, m, n, alpha, a.Data(), lda, x_data, beta, y_data);
+    for (int i = 0; i < (int)y_copy.size(); i++)
+      y.Data()[i * y_step] = y_copy[i];
+    return;
+  }
+  S21ThreadPool::ParallelFor(m, n, [&](int begin, int end) {
+    for (int row = begin; row < end; row++) {
+      double sum = 0.0;
+      for (int col = 0; col < n; col++)
+        sum += a.At(row, col) * x_data[col * x_step];
+      double& dst = y.Data()[row * y_step];
+      dst = beta == 0.0 ? alpha * sum : beta * dst + alpha * sum;
+    }
+  });
+}
+
+void Minor(S21ConstMatrixView src, int m_row, int m_col, S21MatrixView dst) {
+  const int rows = src.GetRows(), cols = src.GetCols();
+  if (m_row < 0 || m_row >= rows || m_col < 0 || m_col >= cols)
+    throw std::out_of_range("Incorrect input, index is out of range");
+  if (dst.GetRows() != rows - 1 || dst.GetCols() != cols - 1)
+    throw std::out_of_range("Different matrix dimensions");
+  const int below = rows - m_row - 1, right = cols - m_col - 1;
+  Copy(src.Submatrix(0, 0, m_row, m_col), dst.Submatrix(0, 0, m_row, m_col));
+  Copy(src.Submatrix(0, m_col + 1, m_row, right),
+       dst.Submatrix(0, m_col, m_row, right));
+  Copy(src.Submatrix(m_row + 1, 0, below, m_col),
+       dst.Submatrix(m_row, 0, below, m_col));
+  Copy(src.Submatrix(m_row + 1, m_col + 1, below, right),
+       dst.Submatrix(m_row, m_col, below, right));
+}
+
+double SingularTolerance(S21ConstMatrixView a) {
+  double largest = 0.0;
+  for (int i = 0; i < a.GetRows(); i++)
+    for (int j = 0; j < a.GetCols(); j++)
+      largest = std::max(largest, std::fabs(a.At(i, j)));
+  return a.GetRows() * std::numeric_limits<double>::epsilon() * largest;
+}
+
+int FactorLU(S21MatrixView a, int* pivots, bool& singular) {
+  const int n = a.GetRows();
+  if (n != a.GetCols()) throw std::invalid_argument("The matrix is not square");
+  const std::ptrdiff_t step = a.GetColStride();
+  const double tolerance = SingularTolerance(a);
+  int sign = 1;
+  singular = false;
+  if (pivots)
+    for (int i = 0; i < n; i++) pivots[i] = i;
+  for (int k = 0; k < n; k++) {
+    int pivot = k;
+    double pivot_abs = std::fabs(a.At(k, k));
+    for (int i = k + 1; i < n; i++) {
+      const double value = std::fabs(a.At(i, k));
+      if (value > pivot_abs) pivot = i, pivot_abs = value;
+    }
+    if (pivot_abs <= tolerance) singular = true;
+    if (pivot_abs == 0.0) continue;
+    if (pivot != k) {
+      for (int j = 0; j < n; j++) std::swap(a.At(k, j), a.At(pivot, j));
+      if (pivots) std::swap(pivots[k], pivots[pivot]);
+      sign = -sign;
+    }
+    const double* pivot_row = a.RowData(k);
+    for (int i = k + 1; i < n; i++) {
+      double* row = a.RowData(i);
+      const double factor = row[k * step] / pivot_row[k * step];
+      row[k * step] = factor;
+      if (factor == 0.0) continue;
+      if (step == 1) {
+        for (int j = k + 1; j < n; j++) row[j] -= factor * pivot_row[j];
+      } else {
+        for (int j = k + 1; j < n; j++)
+          row[j * step] -= factor * pivot_row[j * step];
+      }
+    }
+  }
+  return sign;
+}
+
+double Determinant(S21MatrixView a) {
+  const int n = a.GetRows();
+  if (n != a.GetCols()) throw std::invalid_argument("The matrix is not square");
+  if (n == 0) return 1;
+  if (n == 1) return a.At(0, 0);
+  if (n == 2) return a.At(0, 0) * a.At(1, 1) - a.At(1, 0) * a.At(0, 1);
+  bool singular;
+  double det = FactorLU(a, nullptr, singular);
+  for (int i = 0; i < n; i++) det *= a.At(i, i);
+  return det;
+}
+
+}  // namespace s21_views
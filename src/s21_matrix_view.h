@@ -0,0 +1,124 @@
+#ifndef SRC_S21_MATRIX_VIEW_
+#define SRC_S21_MATRIX_VIEW_
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+// Non-owning rows x cols window into storage owned elsewhere, usually an
+// S21Matrix. Element (row, col) lives at data[row * row_stride +
+// col * col_stride], so submatrices, rows, columns, diagonals and
+// transposes are all views of the same buffer. A view is only valid while
+// the storage it points into is alive and not reallocated.
+template <typename T>
+class S21BasicMatrixView {
+ public:
+  S21BasicMatrixView()
+      : data_(nullptr), rows_(0), cols_(0), row_stride_(0), col_stride_(1) {}
+  S21BasicMatrixView(T* data, int rows, int cols, std::ptrdiff_t row_stride,
+                     std::ptrdiff_t col_stride = 1)
+      : data_(data),
+        rows_(rows),
+        cols_(cols),
+        row_stride_(row_stride),
+        col_stride_(col_stride) {
+    if (rows < 0 || cols < 0)
+      throw std::invalid_argument("Number of rows or columns is negative");
+  }
+  // A mutable view converts to a read-only one.
+  template <typename U, typename = std::enable_if_t<
+                            std::is_same<const U, T>::value &&
+                            !std::is_same<U, T>::value>>
+  S21BasicMatrixView(const S21BasicMatrixView<U>& other)
+      : S21BasicMatrixView(other.Data(), other.GetRows(), other.GetCols(),
+                           other.GetRowStride(), other.GetColStride()) {}
+
+  int GetRows() const { return rows_; }
+  int GetCols() const { return cols_; }
+  std::ptrdiff_t GetRowStride() const { return row_stride_; }
+  std::ptrdiff_t GetColStride() const { return col_stride_; }
+  T* Data() const { return data_; }
+  bool Empty() const { return rows_ == 0 || cols_ == 0; }
+
+  T& operator()(int row, int col) const {
+    if (row < 0 || row >= rows_ || col < 0 || col >= cols_)
+      throw std::out_of_range("Incorrect input, index is out of range");
+    return At(row, col);
+  }
+  // Unchecked access for kernels.
+  T& At(int row, int col) const {
+    return data_[row * row_stride_ + col * col_stride_];
+  }
+  T* RowData(int row) const { return data_ + row * row_stride_; }
+
+  S21BasicMatrixView Submatrix(int row, int col, int rows, int cols) const {
+    if (row < 0 || col < 0 || rows < 0 || cols < 0 || row + rows > rows_ ||
+        col + cols > cols_)
+      throw std::out_of_range("Incorrect input, index is out of range");
+    return S21BasicMatrixView(data_ + row * row_stride_ + col * col_stride_,
+                              rows, cols, row_stride_, col_stride_);
+  }
+  // 1 x cols view of a row.
+  S21BasicMatrixView Row(int row) const { return Submatrix(row, 0, 1, cols_); }
+  // rows x 1 view of a column.
+  S21BasicMatrixView Col(int col) const { return Submatrix(0, col, rows_, 1); }
+  // Main diagonal as a column.
+  S21BasicMatrixView Diagonal() const {
+    return S21BasicMatrixView(data_, std::min(rows_, cols_), 1,
+                              row_stride_ + col_stride_, 1);
+  }
+  S21BasicMatrixView Transposed() const {
+    return S21BasicMatrixView(data_, cols_, rows_, col_stride_, row_stride_);
+  }
+
+ private:
+  T* data_;
+  int rows_, cols_;
+  std::ptrdiff_t row_stride_, col_stride_;
+};
+
+using S21MatrixView = S21BasicMatrixView<double>;
+using S21ConstMatrixView = S21BasicMatrixView<const double>;
+
+// Kernels on views. Shapes are checked like the S21Matrix methods do;
+// outputs must not overlap inputs unless stated otherwise.
+namespace s21_views {
+
+void Copy(S21ConstMatrixView src, S21MatrixView dst);
+// dst += src and dst -= src; dst may be src itself.
+void Add(S21ConstMatrixView src, S21MatrixView dst);
+void Sub(S21ConstMatrixView src, S21MatrixView dst);
+void Scale(double num, S21MatrixView dst);
+bool Equal(S21ConstMatrixView lhs, S21ConstMatrixView rhs);
+// dst = lhs * rhs.
+void Multiply(S21ConstMatrixView lhs, S21ConstMatrixView rhs,
+              S21MatrixView dst);
+// y = alpha * a * x + beta * y, where x and y are views with one row or
+// one column; pass a.Transposed() for the transposed product. beta 0
+// ignores the old contents of y. x may overlap y.
+void Gemv(double alpha, S21ConstMatrixView a, S21ConstMatrixView x,
+          double beta, S21MatrixView y);
+// dst = src with row m_row and column m_col removed.
+void Minor(S21ConstMatrixView src, int m_row, int m_col, S21MatrixView dst);
+// n * epsilon * the largest magnitude in the n x n matrix a. Pivots no
+// larger than this are taken for zero by FactorLU, as they are rounding
+// noise of an exactly singular matrix such as
+// [[1, 2, 3], [4, 5, 6], [7, 8, 9]].
+double SingularTolerance(S21ConstMatrixView a);
+// Partially pivoted LU factorization of the square view a in place: U on
+// and above the diagonal, the multipliers of L below it. Row k of the
+// factors is row pivots[k] of a when pivots is not null. Returns the sign
+// of the row permutation; singular is set when a pivot falls within
+// SingularTolerance(a). Only an exactly zero pivot stops elimination in
+// its column. S21LU and Determinant are both built on it.
+int FactorLU(S21MatrixView a, int* pivots, bool& singular);
+// Determinant by FactorLU, the signed product of the pivots: tiny rather
+// than 0 for a matrix that is only singular up to rounding, and exact for
+// badly scaled ones such as diag(1e8, 1e8, 1e-8). a is used as scratch
+// and left overwritten.
+double Determinant(S21MatrixView a);
+
+}  // namespace s21_views
+
+#endif  // SRC_S21_MATRIX_VIEW_
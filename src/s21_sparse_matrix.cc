@@ -0,0 +1,314 @@
+#include "s21_sparse_matrix.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+#include "s21_thread_pool.h"
+
+S21SparseMatrix::S21SparseMatrix() : S21SparseMatrix(0, 0) {}
+
+S21SparseMatrix::S21SparseMatrix(int rows, int cols, Format format)
+    : rows_(rows), cols_(cols), format_(format) {
+  if (rows < 0 || cols < 0)
+    throw std::invalid_argument("Number of rows or columns should be positive");
+  offsets_.assign(Outer() + 1, 0);
+}
+
+S21SparseMatrix::S21SparseMatrix(int rows, int cols,
+                                 const std::vector<S21Triplet>& entries,
+                                 Format format)
+    : S21SparseMatrix(rows, cols, format) {
+  const bool csr = format == Format::kCsr;
+  std::vector<std::pair<long, double>> keyed;
+  keyed.reserve(entries.size());
+  for (const S21Triplet& entry : entries) {
+    if (entry.row < 0 || entry.row >= rows || entry.col < 0 ||
+        entry.col >= cols)
+      throw std::out_of_range("Incorrect input, index is out of range");
+    const long outer = csr ? entry.row : entry.col;
+    const long inner = csr ? entry.col : entry.row;
+    keyed.emplace_back(outer * Inner() + inner, entry.value);
+  }
+  std::stable_sort(keyed.begin(), keyed.end(),
+                   [](const auto& lhs, const auto& rhs) {
+                     return lhs.first < rhs.first;
+                   });
+  for (std::size_t i = 0; i < keyed.size();) {
+    const long key = keyed[i].first;
+    double sum = 0.0;
+    for (; i < keyed.size() && keyed[i].first == key; i++)
+      sum += keyed[i].second;
+    if (sum == 0.0) continue;
+    offsets_[key / Inner() + 1]++;
+    indices_.push_back((int)(key % Inner()));
+    values_.push_back(sum);
+  }
+  for (int i = 0; i < Outer(); i++) offsets_[i + 1] += offsets_[i];
+}
+
+S21SparseMatrix::S21SparseMatrix(const S21Matrix& dense, double drop_tolerance,
+                                 Format format)
+    : S21SparseMatrix(dense.GetRows(), dense.GetCols()) {
+  if (drop_tolerance < 0)
+    throw std::invalid_argument("Drop tolerance should not be negative");
+  const S21ConstMatrixView view = dense.View();
+  for (int row = 0; row < rows_; row++) {
+    const double* src = view.RowData(row);
+    for (int col = 0; col < cols_; col++) {
+      if (std::fabs(src[col]) > drop_tolerance) {
+        indices_.push_back(col);
+        values_.push_back(src[col]);
+      }
+    }
+    offsets_[row + 1] = (int)values_.size();
+  }
+  if (format != Format::kCsr) *this = ToFormat(format);
+}
+
+double S21SparseMatrix::operator()(int row, int col) const {
+  if (row < 0 || row >= rows_ || col < 0 || col >= cols_)
+    throw std::out_of_range("Incorrect input, index is out of range");
+  const int outer = format_ == Format::kCsr ? row : col;
+  const int inner = format_ == Format::kCsr ? col : row;
+  const auto first = indices_.begin() + offsets_[outer];
+  const auto last = indices_.begin() + offsets_[outer + 1];
+  const auto found = std::lower_bound(first, last, inner);
+  if (found == last || *found != inner) return 0.0;
+  return values_[found - indices_.begin()];
+}
+
+S21Matrix S21SparseMatrix::ToDense(std::pmr::memory_resource* resource) const {
+  S21Matrix result(rows_, cols_, resource);
+  S21MatrixView view = result.View();
+  for (int outer = 0; outer < Outer(); outer++) {
+    for (int p = offsets_[outer]; p < offsets_[outer + 1]; p++) {
+      if (format_ == Format::kCsr) {
+        view.At(outer, indices_[p]) = values_[p];
+      } else {
+        view.At(indices_[p], outer) = values_[p];
+      }
+    }
+  }
+  return result;
+}
+
+S21SparseMatrix S21SparseMatrix::ToFormat(Format format) const {
+  if (format == format_) return *this;
+  // Counting sort by inner index; walking the outer indices in order keeps
+  // every new segment sorted.
+  S21SparseMatrix result(rows_, cols_, format);
+  for (int index : indices_) result.offsets_[index + 1]++;
+  for (int i = 0; i < Inner(); i++)
+    result.offsets_[i + 1] += result.offsets_[i];
+  result.indices_.resize(indices_.size());
+  result.values_.resize(values_.size());
+  std::vector<int> next(result.offsets_.begin(), result.offsets_.end() - 1);
+  for (int outer = 0; outer < Outer(); outer++) {
+    for (int p = offsets_[outer]; p < offsets_[outer + 1]; p++) {
+      const int dst = next[indices_[p]]++;
+      result.indices_[dst] = outer;
+      result.values_[dst] = values_[p];
+    }
+  }
+  return result;
+}
+
+S21SparseMatrix S21SparseMatrix::Transpose() const {
+  S21SparseMatrix result(*this);
+  std::swap(result.rows_, result.cols_);
+  result.format_ = format_ == Format::kCsr ? Format::kCsc : Format::kCsr;
+  return result;
+}
+
+bool S21SparseMatrix::EqMatrix(const S21SparseMatrix& other) const {
+  if (rows_ != other.rows_ || cols_ != other.cols_) return false;
+  const S21SparseMatrix difference = *this - other;
+  for (double value : difference.values_)
+    if (std::fabs(value) > 1e-7) return false;
+  return true;
+}
+
+void S21SparseMatrix::SumMatrix(const S21SparseMatrix& other) {
+  Merge(other, 1.0);
+}
+
+void S21SparseMatrix::SubMatrix(const S21SparseMatrix& other) {
+  Merge(other, -1.0);
+}
+
+void S21SparseMatrix::Merge(const S21SparseMatrix& other, double sign) {
+  if (rows_ != other.rows_ || cols_ != other.cols_)
+    throw std::out_of_range("Different matrix dimensions");
+  if (other.format_ != format_) return Merge(other.ToFormat(format_), sign);
+  std::vector<int> offsets(offsets_.size(), 0);
+  std::vector<int> indices;
+  std::vector<double> values;
+  indices.reserve(indices_.size() + other.indices_.size());
+  values.reserve(indices.capacity());
+  auto push = [&](int index, double value) {
+    if (value == 0.0) return;
+    indices.push_back(index);
+    values.push_back(value);
+  };
+  for (int outer = 0; outer < Outer(); outer++) {
+    int p = offsets_[outer], q = other.offsets_[outer];
+    const int p_end = offsets_[outer + 1], q_end = other.offsets_[outer + 1];
+    while (p < p_end || q < q_end) {
+      if (q == q_end || (p < p_end && indices_[p] < other.indices_[q])) {
+        push(indices_[p], values_[p]), p++;
+      } else if (p == p_end || other.indices_[q] < indices_[p]) {
+        push(other.indices_[q], sign * other.values_[q]), q++;
+      } else {
+        push(indices_[p], values_[p] + sign * other.values_[q]), p++, q++;
+      }
+    }
+    offsets[outer + 1] = (int)values.size();
+  }
+  offsets_ = std::move(offsets);
+  indices_ = std::move(indices);
+  values_ = std::move(values);
+}
+
+void S21SparseMatrix::MulNumber(double num) {
+  if (num == 0.0) {
+    *this = S21SparseMatrix(rows_, cols_, format_);
+    return;
+  }
+  for (double& value : values_) value *= num;
+}
+
+std::vector<double> S21SparseMatrix::MulVector(
+    const std::vector<double>& x) const {
+  if ((int)x.size() != cols_)
+    throw std::out_of_range(
+        "Invalid matrix sizes: vector length must be equal to the number of "
+        "cols of the matrix");
+  std::vector<double> y(rows_, 0.0);
+  if (format_ == Format::kCsr) {
+    const long row_cost = (long)values_.size() / std::max(rows_, 1) + 1;
+    S21ThreadPool::ParallelFor(rows_, row_cost, [&](int begin, int end) {
+      for (int row = begin; row < end; row++) {
+        double sum = 0.0;
+        for (int p = offsets_[row]; p < offsets_[row + 1]; p++)
+          sum += values_[p] * x[indices_[p]];
+        y[row] = sum;
+      }
+    });
+  } else {
+    for (int col = 0; col < cols_; col++) {
+      const double factor = x[col];
+      for (int p = offsets_[col]; p < offsets_[col + 1]; p++)
+        y[indices_[p]] += values_[p] * factor;
+    }
+  }
+  return y;
+}
+
+S21Matrix S21SparseMatrix::MulMatrix(const S21Matrix& dense) const {
+  if (cols_ != dense.GetRows())
+    throw std::out_of_range(
+        "Invalid matrix sizes: number of cols of the first matrix must be "
+        "equal to the number of rows of the second matrix");
+  // Row i of the result gathers rows of dense, which needs CSR.
+  if (format_ != Format::kCsr) return ToFormat(Format::kCsr).MulMatrix(dense);
+  const int n = dense.GetCols();
+  S21Matrix result(rows_, n, dense.GetResource());
+  const S21ConstMatrixView src = dense.View();
+  const S21MatrixView dst = result.View();
+  const long row_cost = ((long)values_.size() / std::max(rows_, 1) + 1) * n;
+  S21ThreadPool::ParallelFor(rows_, row_cost, [&](int begin, int end) {
+    for (int row = begin; row < end; row++) {
+      double* out = dst.RowData(row);
+      for (int p = offsets_[row]; p < offsets_[row + 1]; p++) {
+        const double factor = values_[p];
+        const double* in = src.RowData(indices_[p]);
+        for (int col = 0; col < n; col++) out[col] += factor * in[col];
+      }
+    }
+  });
+  return result;
+}
+
+bool S21SparseMatrix::operator==(const S21SparseMatrix& other) const {
+  return EqMatrix(other);
+}
+
+bool S21SparseMatrix::operator!=(const S21SparseMatrix& other) const {
+  return !EqMatrix(other);
+}
+
+S21SparseMatrix& S21SparseMatrix::operator+=(const S21SparseMatrix& other) {
+  SumMatrix(other);
+  return *this;
+}
+
+S21SparseMatrix& S21SparseMatrix::operator-=(const S21SparseMatrix& other) {
+  SubMatrix(other);
+  return *this;
+}
+
+S21SparseMatrix& S21SparseMatrix::operator*=(double num) {
+  MulNumber(num);
+  return *this;
+}
+
+S21SparseMatrix operator+(S21SparseMatrix lhs, const S21SparseMatrix& rhs) {
+  return lhs += rhs;
+}
+
+S21SparseMatrix operator-(S21SparseMatrix lhs, const S21SparseMatrix& rhs) {
+  return lhs -= rhs;
+}
+
+S21SparseMatrix operator*(S21SparseMatrix lhs, double num) {
+  return lhs *= num;
+}
+
+S21SparseMatrix operator*(double num, S21SparseMatrix rhs) {
+  return rhs *= num;
+}
+
+S21Matrix operator*(const S21SparseMatrix& lhs, const S21Matrix& rhs) {
+  return lhs.MulMatrix(rhs);
+}
+
+S21Matrix operator*(const S21Matrix& lhs, const S21SparseMatrix& rhs) {
+  if (lhs.GetCols() != rhs.GetRows())
+    throw std::out_of_range(
+        "Invalid matrix sizes: number of cols of the first matrix must be "
+        "equal to the number of rows of the second matrix");
+  const int n = rhs.GetCols();
+  const bool csr = rhs.GetFormat() == S21SparseMatrix::Format::kCsr;
+  const std::vector<int>& offsets = rhs.Offsets();
+  const std::vector<int>& indices = rhs.Indices();
+  const std::vector<double>& values = rhs.Values();
+  S21Matrix result(lhs.GetRows(), n, lhs.GetResource());
+  const S21ConstMatrixView src = lhs.View();
+  const S21MatrixView dst = result.View();
+  const long row_cost = rhs.NonZeros() + n;
+  S21ThreadPool::ParallelFor(lhs.GetRows(), row_cost, [&](int begin, int end) {
+    for (int row = begin; row < end; row++) {
+      const double* in = src.RowData(row);
+      double* out = dst.RowData(row);
+      if (csr) {
+        // Scatter row k of rhs, scaled by lhs(row, k).
+        for (int k = 0; k < lhs.GetCols(); k++) {
+          const double factor = in[k];
+          for (int p = offsets[k]; p < offsets[k + 1]; p++)
+            out[indices[p]] += factor * values[p];
+        }
+      } else {
+        // Dot product with every column of rhs.
+        for (int col = 0; col < n; col++) {
+          double sum = 0.0;
+          for (int p = offsets[col]; p < offsets[col + 1]; p++)
+            sum += in[indices[p]] * values[p];
+          out[col] = sum;
+        }
+      }
+    }
+  });
+  return result;
+}
@@ -0,0 +1,86 @@
+#ifndef SRC_S21_SPARSE_MATRIX_
+#define SRC_S21_SPARSE_MATRIX_
+
+#include <memory_resource>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+struct S21Triplet {
+  int row, col;
+  double value;
+};
+
+// Compressed sparse matrix. In CSR form Offsets() has rows + 1 entries and
+// the non-zeros of row i are Indices()/Values() in [Offsets()[i],
+// Offsets()[i + 1]), sorted by column; CSC is the same with rows and
+// columns swapped. Storage and the cost of every operation scale with the
+// number of stored entries.
+class S21SparseMatrix {
+ public:
+  enum class Format { kCsr, kCsc };
+
+  S21SparseMatrix();
+  // All-zero rows x cols matrix.
+  S21SparseMatrix(int rows, int cols, Format format = Format::kCsr);
+  // Entries may come in any order; duplicates are summed.
+  S21SparseMatrix(int rows, int cols, const std::vector<S21Triplet>& entries,
+                  Format format = Format::kCsr);
+  // Keeps the elements of dense with |value| > drop_tolerance.
+  explicit S21SparseMatrix(const S21Matrix& dense, double drop_tolerance = 0.0,
+                           Format format = Format::kCsr);
+
+  int GetRows() const { return rows_; }
+  int GetCols() const { return cols_; }
+  Format GetFormat() const { return format_; }
+  int NonZeros() const { return (int)values_.size(); }
+  const std::vector<int>& Offsets() const { return offsets_; }
+  const std::vector<int>& Indices() const { return indices_; }
+  const std::vector<double>& Values() const { return values_; }
+
+  double operator()(int row, int col) const;
+  S21Matrix ToDense(
+      std::pmr::memory_resource* resource = S21SmallBlockPool::Instance())
+      const;
+  S21SparseMatrix ToFormat(Format format) const;
+  // Reinterprets the arrays, so it is O(1) apart from the copy: the
+  // transpose of a CSR matrix comes back in CSC form and vice versa.
+  S21SparseMatrix Transpose() const;
+
+  bool EqMatrix(const S21SparseMatrix& other) const;
+  void SumMatrix(const S21SparseMatrix& other);
+  void SubMatrix(const S21SparseMatrix& other);
+  void MulNumber(double num);
+  // y = A * x. CSR rows are split between threads; CSC scatters by column
+  // on the calling thread.
+  std::vector<double> MulVector(const std::vector<double>& x) const;
+  // A * dense.
+  S21Matrix MulMatrix(const S21Matrix& dense) const;
+
+  bool operator==(const S21SparseMatrix& other) const;
+  bool operator!=(const S21SparseMatrix& other) const;
+  S21SparseMatrix& operator+=(const S21SparseMatrix& other);
+  S21SparseMatrix& operator-=(const S21SparseMatrix& other);
+  S21SparseMatrix& operator*=(double num);
+
+ private:
+  int Outer() const { return format_ == Format::kCsr ? rows_ : cols_; }
+  int Inner() const { return format_ == Format::kCsr ? cols_ : rows_; }
+  void Merge(const S21SparseMatrix& other, double sign);
+
+  int rows_, cols_;
+  Format format_;
+  std::vector<int> offsets_;
+  std::vector<int> indices_;
+  std::vector<double> values_;
+};
+
+S21SparseMatrix operator+(S21SparseMatrix lhs, const S21SparseMatrix& rhs);
+S21SparseMatrix operator-(S21SparseMatrix lhs, const S21SparseMatrix& rhs);
+S21SparseMatrix operator*(S21SparseMatrix lhs, double num);
+S21SparseMatrix operator*(double num, S21SparseMatrix rhs);
+S21Matrix operator*(const S21SparseMatrix& lhs, const S21Matrix& rhs);
+// dense * sparse.
+S21Matrix operator*(const S21Matrix& lhs, const S21SparseMatrix& rhs);
+
+#endif  // SRC_S21_SPARSE_MATRIX_
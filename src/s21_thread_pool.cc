@@ -0,0 +1,222 @@
+#include "s21_thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr long kDefaultSerialThreshold = 1L << 16;
+// Chunks per thread, so that stealing can even out uneven rows.
+constexpr int kChunksPerThread = 4;
+
+// Completion state shared by the chunks of one ParallelFor call.
+struct Batch {
+  std::atomic<int> remaining;
+  std::mutex mutex;
+  std::condition_variable done;
+  std::exception_ptr error;
+};
+
+// Fixed set of workers, each owning a deque. Owners pop from the front,
+// idle workers and the submitting thread steal from the back of others.
+class WorkerGroup {
+ public:
+  explicit WorkerGroup(int workers) : queues_(workers) {
+    for (auto& queue : queues_) queue = std::make_unique<Queue>();
+    for (int i = 0; i < workers; i++)
+      threads_.emplace_back([this, i] { WorkerLoop(i); });
+  }
+
+  ~WorkerGroup() {
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex_);
+      stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& thread : threads_) thread.join();
+  }
+
+  int Workers() const { return static_cast<int>(queues_.size()); }
+
+  void Run(int chunks, const std::function<void(int)>& run_chunk) {
+    Batch batch;
+    batch.remaining.store(chunks);
+    for (int chunk = 0; chunk < chunks; chunk++) {
+      Queue& queue = *queues_[chunk % queues_.size()];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      queue.tasks.push_back([&batch, &run_chunk, chunk] {
+        try {
+          run_chunk(chunk);
+        } catch (...) {
+          std::lock_guard<std::mutex> error_lock(batch.mutex);
+          if (!batch.error) batch.error = std::current_exception();
+        }
+        std::lock_guard<std::mutex> done_lock(batch.mutex);
+        if (batch.remaining.fetch_sub(1) == 1) batch.done.notify_all();
+      });
+    }
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex_);
+      pending_ += chunks;
+    }
+    wake_.notify_all();
+    while (batch.remaining.load() > 0 && TryRunOne(0)) {
+    }
+    // Taking the lock also waits for the last chunk to stop touching batch.
+    std::unique_lock<std::mutex> lock(batch.mutex);
+    batch.done.wait(lock, [&batch] { return batch.remaining.load() == 0; });
+    if (batch.error) std::rethrow_exception(batch.error);
+  }
+
+ private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  bool TryRunOne(int home) {
+    std::function<void()> task;
+    const int count = Workers();
+    for (int offset = 0; offset < count && !task; offset++) {
+      Queue& queue = *queues_[(home + offset) % count];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      if (queue.tasks.empty()) continue;
+      if (offset == 0) {
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+      } else {
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+      }
+    }
+    if (!task) return false;
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex_);
+      pending_--;
+    }
+    task();
+    return true;
+  }
+
+  void WorkerLoop(int index) {
+    while (true) {
+      if (TryRunOne(index)) continue;
+      std::unique_lock<std::mutex> lock(sleep_mutex_);
+      wake_.wait(lock, [this] { return stop_ || pending_ > 0; });
+      if (stop_ && pending_ == 0) return;
+    }
+  }
+
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::vector<std::thread> threads_;
+  std::mutex sleep_mutex_;
+  std::condition_variable wake_;
+  long pending_ = 0;
+  bool stop_ = false;
+};
+
+struct PoolState {
+  std::mutex mutex;
+  int threads = 0;
+  long serial_threshold = kDefaultSerialThreshold;
+  S21ThreadPool::Executor executor;
+  std::shared_ptr<WorkerGroup> workers;
+};
+
+PoolState& State() {
+  static PoolState state;
+  return state;
+}
+
+int ResolveThreads(int threads) {
+  if (threads > 0) return threads;
+  // hardware_concurrency reads /sys on every call, which costs more than
+  // small ParallelFor bodies.
+  static const int hardware =
+      std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  return hardware;
+}
+
+}  // namespace
+
+void S21ThreadPool::SetThreadCount(int threads) {
+  if (threads < 0)
+    throw std::invalid_argument("Number of threads should not be negative");
+  PoolState& state = State();
+  std::shared_ptr<WorkerGroup> retired;
+  std::lock_guard<std::mutex> lock(state.mutex);
+  state.threads = threads;
+  retired = std::move(state.workers);
+}
+
+int S21ThreadPool::GetThreadCount() {
+  PoolState& state = State();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  return ResolveThreads(state.threads);
+}
+
+void S21ThreadPool::SetExecutor(Executor executor) {
+  PoolState& state = State();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  state.executor = std::move(executor);
+}
+
+void S21ThreadPool::SetSerialThreshold(long cost) {
+  PoolState& state = State();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  state.serial_threshold = cost;
+}
+
+long S21ThreadPool::GetSerialThreshold() {
+  PoolState& state = State();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  return state.serial_threshold;
+}
+
+void S21ThreadPool::ParallelFor(int count, long cost_per_item,
+                                const std::function<void(int, int)>& body) {
+  if (count <= 0) return;
+  PoolState& state = State();
+  Executor executor;
+  std::shared_ptr<WorkerGroup> workers;
+  int threads;
+  {
+    std::lock_guard<std::mutex> lock(state.mutex);
+    threads = ResolveThreads(state.threads);
+    if (count == 1 ||
+        static_cast<double>(count) * cost_per_item < state.serial_threshold ||
+        (threads == 1 && !state.executor)) {
+      threads = 1;
+    } else if (state.executor) {
+      executor = state.executor;
+    } else {
+      if (!state.workers || state.workers->Workers() != threads - 1)
+        state.workers = std::make_shared<WorkerGroup>(threads - 1);
+      workers = state.workers;
+    }
+  }
+  if (threads == 1) {
+    body(0, count);
+    return;
+  }
+  const int chunks = std::min(count, threads * kChunksPerThread);
+  auto run_chunk = [&body, count, chunks](int chunk) {
+    const int begin =
+        static_cast<int>(static_cast<long>(count) * chunk / chunks);
+    const int end =
+        static_cast<int>(static_cast<long>(count) * (chunk + 1) / chunks);
+    if (begin < end) body(begin, end);
+  };
+  if (executor)
+    executor(chunks, run_chunk);
+  else
+    workers->Run(chunks, run_chunk);
+}
@@ -0,0 +1,40 @@
+#ifndef SRC_S21_THREAD_POOL_
+#define SRC_S21_THREAD_POOL_
+
+#include <functional>
+
+// Process-wide pool that S21Matrix operations use to split work by row
+// blocks. Chunk boundaries never change what is computed for an element,
+// so results do not depend on the thread count.
+class S21ThreadPool {
+ public:
+  // Must run run_chunk(0) ... run_chunk(chunks - 1), possibly concurrently,
+  // and return once all of them have finished.
+  using Executor = std::function<void(
+      int chunks, const std::function<void(int)>& run_chunk)>;
+
+  // 0 selects std::thread::hardware_concurrency(); 1 disables threading.
+  static void SetThreadCount(int threads);
+  static int GetThreadCount();
+  // Hands all parallel work to an external executor; an empty executor
+  // switches back to the built-in work-stealing workers.
+  static void SetExecutor(Executor executor);
+  // Jobs whose estimated cost (in multiply-adds) is below the threshold run
+  // serially on the calling thread.
+  static void SetSerialThreshold(long cost);
+  static long GetSerialThreshold();
+
+  // Calls body(begin, end) on disjoint ranges covering [0, count).
+  static void ParallelFor(int count, long cost_per_item,
+                          const std::function<void(int, int)>& body);
+  // Other callables are wrapped by reference, which std::function holds
+  // without allocating, however much a lambda captures. Splitting the
+  // work between threads still allocates the task records of the workers.
+  template <typename Body>
+  static void ParallelFor(int count, long cost_per_item, const Body& body) {
+    ParallelFor(count, cost_per_item,
+                std::function<void(int, int)>(std::cref(body)));
+  }
+};
+
+#endif  // SRC_S21_THREAD_POOL_
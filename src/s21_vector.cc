@@ -0,0 +1,249 @@
+#include "s21_vector.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "s21_matrix_simd.h"
+#include "s21_thread_pool.h"
+
+namespace {
+
+// Elements per task of the reductions. Block boundaries do not depend on
+// the thread count, and the partial results are combined in block order.
+constexpr int kReductionBlock = 1 << 14;
+
+// Combines block(first, count) over fixed blocks of [0, size) with
+// combine, starting from init.
+template <typename Block, typename Combine>
+double Reduce(int size, double init, Block block, Combine combine) {
+  const int blocks = (size + kReductionBlock - 1) / kReductionBlock;
+  if (blocks <= 1) return combine(init, block(0, size));
+  std::vector<double> partial(blocks);
+  S21ThreadPool::ParallelFor(
+      blocks, kReductionBlock, [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+          const int first = i * kReductionBlock;
+          partial[i] = block(first, std::min(kReductionBlock, size - first));
+        }
+      });
+  for (double value : partial) init = combine(init, value);
+  return init;
+}
+
+double Plus(double lhs, double rhs) { return lhs + rhs; }
+
+double Larger(double lhs, double rhs) { return rhs > lhs ? rhs : lhs; }
+
+// Runs body(first, count) on disjoint blocks of [0, size) in parallel.
+template <typename Body>
+void ForEachBlock(int size, Body body) {
+  const int blocks = (size + kReductionBlock - 1) / kReductionBlock;
+  S21ThreadPool::ParallelFor(blocks, kReductionBlock, [&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      const int first = i * kReductionBlock;
+      body(first, std::min(kReductionBlock, size - first));
+    }
+  });
+}
+
+}  // namespace
+
+S21Vector::S21Vector() : storage_(1, 0) {}
+
+S21Vector::S21Vector(int size, std::pmr::memory_resource* resource)
+    : storage_(1, size, resource) {}
+
+S21Vector::S21Vector(std::initializer_list<double> values)
+    : storage_(1, (int)values.size()) {
+  std::copy(values.begin(), values.end(), Data());
+}
+
+S21Vector::S21Vector(const std::vector<double>& values)
+    : storage_(1, (int)values.size()) {
+  std::copy(values.begin(), values.end(), Data());
+}
+
+S21Vector::S21Vector(S21ConstMatrixView view,
+                     std::pmr::memory_resource* resource)
+    : storage_(resource) {
+  if (view.GetRows() != 1 && view.GetCols() != 1)
+    throw std::invalid_argument("The view is not a vector");
+  storage_ = S21Matrix(1, view.GetRows() * view.GetCols(), resource);
+  s21_views::Copy(view.GetCols() == 1 ? view : view.Transposed(), View());
+}
+
+void S21Vector::SetSize(int size) {
+  if (size < 0) throw std::invalid_argument("Size should not be negative");
+  if (size == 0) {
+    storage_ = S21Matrix(1, 0, storage_.GetResource());
+  } else {
+    storage_.SetSize(1, size);
+  }
+}
+
+double& S21Vector::operator()(int index) {
+  if (index < 0 || index >= GetSize())
+    throw std::out_of_range("Incorrect input, index is out of range");
+  return Data()[index];
+}
+
+const double& S21Vector::operator()(int index) const {
+  if (index < 0 || index >= GetSize())
+    throw std::out_of_range("Incorrect input, index is out of range");
+  return Data()[index];
+}
+
+S21MatrixView S21Vector::View() {
+  return S21MatrixView(Data(), GetSize(), 1, 1);
+}
+
+S21ConstMatrixView S21Vector::View() const {
+  return S21ConstMatrixView(Data(), GetSize(), 1, 1);
+}
+
+bool S21Vector::EqVector(const S21Vector& other) const {
+  return GetSize() == other.GetSize() &&
+         s21_kernels::AllClose(Data(), other.Data(), GetSize(), 1e-7);
+}
+
+void S21Vector::SumVector(const S21Vector& other) {
+  CheckSameSize(other);
+  ForEachBlock(GetSize(), [&](int first, int count) {
+    s21_kernels::Add(Data() + first, other.Data() + first, count);
+  });
+}
+
+void S21Vector::SubVector(const S21Vector& other) {
+  CheckSameSize(other);
+  ForEachBlock(GetSize(), [&](int first, int count) {
+    s21_kernels::Sub(Data() + first, other.Data() + first, count);
+  });
+}
+
+void S21Vector::MulNumber(double num) {
+  ForEachBlock(GetSize(), [&](int first, int count) {
+    s21_kernels::Scale(Data() + first, num, count);
+  });
+}
+
+void S21Vector::Axpy(double alpha, const S21Vector& x) {
+  CheckSameSize(x);
+  ForEachBlock(GetSize(), [&](int first, int count) {
+    s21_kernels::Axpy(Data() + first, alpha, x.Data() + first, count);
+  });
+}
+
+double S21Vector::Dot(const S21Vector& other) const {
+  CheckSameSize(other);
+  return Reduce(
+      GetSize(), 0.0,
+      [&](int first, int count) {
+        return s21_kernels::Dot(Data() + first, other.Data() + first, count);
+      },
+      Plus);
+}
+
+double S21Vector::Norm1() const {
+  return Reduce(
+      GetSize(), 0.0,
+      [&](int first, int count) {
+        return s21_kernels::AbsSum(Data() + first, count);
+      },
+      Plus);
+}
+
+double S21Vector::Norm2() const {
+  const double squares = Reduce(
+      GetSize(), 0.0,
+      [&](int first, int count) {
+        return s21_kernels::SumSquares(Data() + first, count);
+      },
+      Plus);
+  if (std::isnan(squares)) return squares;
+  if (squares >= std::numeric_limits<double>::min() &&
+      squares <= std::numeric_limits<double>::max())
+    return std::sqrt(squares);
+  // Squares overflowed or underflowed: scale by a power of two near the
+  // largest element, which is exact.
+  const double max = NormInf();
+  if (max == 0.0 || std::isinf(max)) return max;
+  S21Vector scaled(*this);
+  const int exponent = std::ilogb(max);
+  scaled.MulNumber(std::ldexp(1.0, -exponent));
+  return std::ldexp(std::sqrt(scaled.Dot(scaled)), exponent);
+}
+
+double S21Vector::NormInf() const {
+  return Reduce(
+      GetSize(), 0.0,
+      [&](int first, int count) {
+        return s21_kernels::AbsMax(Data() + first, count);
+      },
+      Larger);
+}
+
+void S21Vector::Gemv(double alpha, S21ConstMatrixView a, const S21Vector& x,
+                     double beta) {
+  s21_views::Gemv(alpha, a, x.View(), beta, View());
+}
+
+void S21Vector::GemvTransposed(double alpha, S21ConstMatrixView a,
+                               const S21Vector& x, double beta) {
+  s21_views::Gemv(alpha, a.Transposed(), x.View(), beta, View());
+}
+
+bool S21Vector::operator==(const S21Vector& other) const {
+  return EqVector(other);
+}
+
+bool S21Vector::operator!=(const S21Vector& other) const {
+  return !EqVector(other);
+}
+
+S21Vector& S21Vector::operator+=(const S21Vector& other) {
+  SumVector(other);
+  return *this;
+}
+
+S21Vector& S21Vector::operator-=(const S21Vector& other) {
+  SubVector(other);
+  return *this;
+}
+
+S21Vector& S21Vector::operator*=(double num) {
+  MulNumber(num);
+  return *this;
+}
+
+void S21Vector::CheckSameSize(const S21Vector& other) const {
+  if (GetSize() != other.GetSize())
+    throw std::out_of_range("Different vector sizes");
+}
+
+S21Vector operator+(S21Vector lhs, const S21Vector& rhs) {
+  lhs += rhs;
+  return lhs;
+}
+
+S21Vector operator-(S21Vector lhs, const S21Vector& rhs) {
+  lhs -= rhs;
+  return lhs;
+}
+
+S21Vector operator*(S21Vector lhs, double num) {
+  lhs *= num;
+  return lhs;
+}
+
+S21Vector operator*(double num, S21Vector rhs) {
+  rhs *= num;
+  return rhs;
+}
+
+S21Vector operator*(const S21Matrix& lhs, const S21Vector& rhs) {
+  S21Vector result(lhs.GetRows(), lhs.GetResource());
+  result.Gemv(1.0, lhs, rhs);
+  return result;
+}
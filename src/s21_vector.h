@@ -0,0 +1,79 @@
+#ifndef SRC_S21_VECTOR_
+#define SRC_S21_VECTOR_
+
+#include <initializer_list>
+#include <memory_resource>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+// Dense vector in one aligned buffer. View() sees it as a size x 1 column,
+// so the view kernels and Gemv accept it next to matrices and views of
+// them. Elementwise operations and reductions use the SIMD kernels and
+// are split between threads in fixed blocks, so results do not depend on
+// the thread count.
+class S21Vector {
+ public:
+  S21Vector();
+  explicit S21Vector(int size, std::pmr::memory_resource* resource =
+                                   S21SmallBlockPool::Instance());
+  S21Vector(std::initializer_list<double> values);
+  explicit S21Vector(const std::vector<double>& values);
+  // Copies a view with one row or one column.
+  explicit S21Vector(
+      S21ConstMatrixView view,
+      std::pmr::memory_resource* resource = S21SmallBlockPool::Instance());
+
+  int GetSize() const { return storage_.GetCols(); }
+  // Keeps the elements that still fit and zeroes the new ones; grows the
+  // buffer geometrically like S21Matrix::SetSize.
+  void SetSize(int size);
+  double* Data() { return storage_.View().RowData(0); }
+  const double* Data() const { return storage_.View().RowData(0); }
+  double& operator()(int index);
+  const double& operator()(int index) const;
+  S21MatrixView View();
+  S21ConstMatrixView View() const;
+  operator S21MatrixView() { return View(); }
+  operator S21ConstMatrixView() const { return View(); }
+
+  bool EqVector(const S21Vector& other) const;
+  void SumVector(const S21Vector& other);
+  void SubVector(const S21Vector& other);
+  void MulNumber(double num);
+  // this += alpha * x.
+  void Axpy(double alpha, const S21Vector& x);
+  double Dot(const S21Vector& other) const;
+  double Norm1() const;
+  // Rescales instead of overflowing or underflowing on extreme elements.
+  double Norm2() const;
+  // Largest absolute value; NaN elements are ignored.
+  double NormInf() const;
+  // this = alpha * a * x + beta * this, and the same with a transposed,
+  // for a matrix or any view of one. x may be this vector.
+  void Gemv(double alpha, S21ConstMatrixView a, const S21Vector& x,
+            double beta = 0.0);
+  void GemvTransposed(double alpha, S21ConstMatrixView a, const S21Vector& x,
+                      double beta = 0.0);
+
+  bool operator==(const S21Vector& other) const;
+  bool operator!=(const S21Vector& other) const;
+  S21Vector& operator+=(const S21Vector& other);
+  S21Vector& operator-=(const S21Vector& other);
+  S21Vector& operator*=(double num);
+
+ private:
+  void CheckSameSize(const S21Vector& other) const;
+
+  // One row.
+  S21Matrix storage_;
+};
+
+S21Vector operator+(S21Vector lhs, const S21Vector& rhs);
+S21Vector operator-(S21Vector lhs, const S21Vector& rhs);
+S21Vector operator*(S21Vector lhs, double num);
+S21Vector operator*(double num, S21Vector rhs);
+// Matrix-vector product through Gemv.
+S21Vector operator*(const S21Matrix& lhs, const S21Vector& rhs);
+
+#endif  // SRC_S21_VECTOR_